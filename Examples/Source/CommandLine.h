@@ -0,0 +1,50 @@
+#pragma once
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "CoreMinimal.h"
+
+/**
+ * Numeric value of a command line option. Malformed or out of range text is reported with the option name
+ * and returns false, where std::stoi would throw or silently accept a prefix like "12abc".
+ * Usage:
+ *	if (!ParseArgument("--spp", argv[++i], Settings.SamplesPerPixel, 1))
+ *		return PrintUsage();
+ */
+template <class T>
+bool ParseArgument(const char* Option, const char* Text, T& Out, T Min = std::numeric_limits<T>::lowest(), T Max = std::numeric_limits<T>::max())
+{
+	static_assert(std::is_arithmetic_v<T>);
+	using ParsedT = std::conditional_t<std::is_floating_point_v<T>, double, long long>;
+	ParsedT Value = 0;
+	size_t	Length = 0;
+	try
+	{
+		if constexpr (std::is_floating_point_v<T>)
+			Value = std::stod(Text, &Length);
+		else
+			Value = std::stoll(Text, &Length);
+	}
+	catch (const std::invalid_argument&)
+	{
+		Length = 0;
+	}
+	catch (const std::out_of_range&)
+	{
+		LOG_ERROR("Value of {} is out of range: {}", Option, Text);
+		return false;
+	}
+	if (Length == 0 || Text[Length] != '\0')
+	{
+		LOG_ERROR("Invalid value for {}: {}", Option, Text);
+		return false;
+	}
+	if (Value < static_cast<ParsedT>(Min) || Value > static_cast<ParsedT>(Max))
+	{
+		LOG_ERROR("Value of {} must be in [{}, {}]: {}", Option, Min, Max, Text);
+		return false;
+	}
+	Out = static_cast<T>(Value);
+	return true;
+}
@@ -4,41 +4,54 @@
 
 #pragma once
 #include "Actors/LightActor.h"
-
-inline auto CornellBox()
+#include "MeshShapes.h"
+#include "WorldSnapshot.h"
+
+/**
+ * The Cornell box described as a WorldSnapshot, so it can also be saved and reloaded without rebuilding, e.g.
+ * CornellBoxSnapshot().Save(Path::ProjectContentDir() / "CornellBox.mews");
+ * GEditor.LoadWorld(LoadWorldSnapshot(Path::ProjectContentDir() / "CornellBox.mews"));
+ */
+inline WorldSnapshot CornellBoxSnapshot()
 {
-	return [](World& world)
-	{
-		auto Camera = world.SpawnActor<CameraActor>("MainCamera");
-		Camera->SetTranslation({-10.760, 0.5, 1}); Camera->GetCameraComponent()->SetFovH(19.5); Camera->LookAt(FVector{0, 0.5, 1});
+	WorldSnapshot Snapshot;
+	auto& Camera = Snapshot.AddActor(ESnapshotActorType::Camera, "MainCamera");
+	Camera.Translation = {-10.760, 0.5, 1}; Camera.FovH = 19.5; Camera.LookAtTarget = FVector{0, 0.5, 1};
 
-		auto LeftWall = world.SpawnActor<StaticMeshActor>("LeftWall", BasicShapesLibrary::GenerateCuboid(FVector{2., 0.02, 2.}));
-		LeftWall->SetTranslation(FVector{0, -1, 1}); LeftWall->GetMaterial()->SetBaseColor({0.63, 0.065, 0.05});
+	auto& LeftWall = Snapshot.AddStaticMeshActor("LeftWall", MeshShapes::GenerateCuboid(FVector{2., 0.02, 2.}));
+	LeftWall.Translation = FVector{0, -1, 1}; LeftWall.BaseColor = FColor{0.63, 0.065, 0.05};
 
-		auto RightWall= world.SpawnActor<StaticMeshActor>("RightWall", BasicShapesLibrary::GenerateCuboid(FVector{2., 0.02, 2.}));
-		RightWall->SetTranslation(FVector{0, 1, 1}); RightWall->GetMaterial()->SetBaseColor({0.14, 0.45, 0.091});
+	auto& RightWall = Snapshot.AddStaticMeshActor("RightWall", MeshShapes::GenerateCuboid(FVector{2., 0.02, 2.}));
+	RightWall.Translation = FVector{0, 1, 1}; RightWall.BaseColor = FColor{0.14, 0.45, 0.091};
 
-		auto Floor = world.SpawnActor<StaticMeshActor>("Floor", BasicShapesLibrary::GenerateCuboid(FVector{2, 2, 0.02}));
-		Floor->GetMaterial()->SetBaseColor({0.725, 0.71, 0.68});
+	auto& Floor = Snapshot.AddStaticMeshActor("Floor", MeshShapes::GenerateCuboid(FVector{2, 2, 0.02}));
+	Floor.BaseColor = FColor{0.725, 0.71, 0.68};
 
-		auto Ceiling = world.SpawnActor<StaticMeshActor>("Ceiling", BasicShapesLibrary::GenerateCuboid(FVector{2, 2, 0.02}));
-		Ceiling->SetTranslation(FVector{0, 0, 2}); Ceiling->GetMaterial()->SetBaseColor({0.725, 0.71, 0.68});
+	auto& Ceiling = Snapshot.AddStaticMeshActor("Ceiling", MeshShapes::GenerateCuboid(FVector{2, 2, 0.02}));
+	Ceiling.Translation = FVector{0, 0, 2}; Ceiling.BaseColor = FColor{0.725, 0.71, 0.68};
 
-		auto BackWall = world.SpawnActor<StaticMeshActor>("BackWall", BasicShapesLibrary::GenerateCuboid(FVector{0.02, 2, 2.}));
-		BackWall->SetTranslation(FVector{1, 0, 1}); BackWall->GetMaterial()->SetBaseColor({0.725, 0.71, 0.68});
+	auto& BackWall = Snapshot.AddStaticMeshActor("BackWall", MeshShapes::GenerateCuboid(FVector{0.02, 2, 2.}));
+	BackWall.Translation = FVector{1, 0, 1}; BackWall.BaseColor = FColor{0.725, 0.71, 0.68};
 
-		auto ShortBox = world.SpawnActor<StaticMeshActor>("ShotBox", BasicShapesLibrary::GenerateCuboid(FVector{0.594811, 0.6, 0.604394}));
-		ShortBox->SetTranslation(FVector{-0.328631, 0.374592, 0.3})->SetRotation(FVector{0, 0, DegToRad(-163.36)});
-		ShortBox->GetMaterial()->SetBaseColor({0.725, 0.71, 0.68});
+	auto& ShortBox = Snapshot.AddStaticMeshActor("ShotBox", MeshShapes::GenerateCuboid(FVector{0.594811, 0.6, 0.604394}));
+	ShortBox.Translation = FVector{-0.328631, 0.374592, 0.3}; ShortBox.Rotation = FVector{0, 0, DegToRad(-163.36)};
+	ShortBox.BaseColor = FColor{0.725, 0.71, 0.68};
 
-		auto TallBox = world.SpawnActor<StaticMeshActor>("TallBox", BasicShapesLibrary::GenerateCuboid(FVector{0.607289, 0.597739, 1.2}));
-		TallBox->SetTranslation(FVector{0.335439, -0.291415, 0.6,})->SetRotation(FVector{0, 0, DegToRad(160.812)});
-		TallBox->GetMaterial()->SetBaseColor({0.725, 0.71, 0.68});
+	auto& TallBox = Snapshot.AddStaticMeshActor("TallBox", MeshShapes::GenerateCuboid(FVector{0.607289, 0.597739, 1.2}));
+	TallBox.Translation = FVector{0.335439, -0.291415, 0.6,}; TallBox.Rotation = FVector{0, 0, DegToRad(160.812)};
+	TallBox.BaseColor = FColor{0.725, 0.71, 0.68};
 
+	auto& Light = Snapshot.AddActor(ESnapshotActorType::AreaLight, "AreaLight");
+	Light.Translation = {-0.005, -0.03, 1.98};
+	Light.LightSize = {0.47, 0.38};
+	Light.Intensity = {170, 120, 40};
+	return Snapshot;
+}
 
-		auto Light = world.SpawnActor<AreaLightActor>("AreaLight");
-		Light->SetTranslation({-0.005, -0.03, 1.98});
-		Light->GetLightComponent()->SetSize({0.47, 0.38});
-		Light->GetLightComponent()->SetIntensity({170, 120, 40});
+inline auto CornellBox()
+{
+	return [](World& world)
+	{
+		CornellBoxSnapshot().Spawn(world);
 	};
-}
\ No newline at end of file
+}
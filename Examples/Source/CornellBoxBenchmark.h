@@ -0,0 +1,230 @@
+#pragma once
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include "CommandLine.h"
+#include "CornellBox.h"
+#include "CpuPathTracer.h"
+#include "ExampleCache.h"
+
+struct FRenderBenchmarkSettings
+{
+	int Width = 512;
+	int Height = 512;
+
+	// Stop after SamplesPerPixel, or after TimeBudget seconds of rendering when TimeBudget > 0
+	int	   SamplesPerPixel = 256;
+	double TimeBudget = 0.;
+
+	// Converged image to measure the error against. No reference and no error when empty.
+	// The one at DefaultReferenceImage is rendered with ReferenceSamplesPerPixel when missing, any other must exist
+	Path ReferenceImage;
+	int	 ReferenceSamplesPerPixel = 2048;
+
+	// Reference image in the example cache, keyed on everything it depends on so a stale one is never reused
+	[[nodiscard]] Path DefaultReferenceImage() const
+	{
+		return ExampleCacheDir() / ("CornellBoxReference_" + std::to_string(Width) + "x" + std::to_string(Height) + "_"
+			+ std::to_string(ReferenceSamplesPerPixel) + "spp_v" + std::to_string(CpuPathTracer::Version) + ".pfm");
+	}
+};
+
+struct FRenderBenchmarkResult
+{
+	struct FConvergencePoint
+	{
+		int	   SamplesPerPixel;
+		double Seconds;
+		double RMSE;
+	};
+
+	int						  Width = 0;
+	int						  Height = 0;
+	int						  Threads = 0;
+	int						  Triangles = 0;
+	int						  SamplesPerPixel = 0;
+	double					  RenderSeconds = 0.;
+	double					  BlasBuildSeconds = 0.;
+	double					  TlasBuildSeconds = 0.;
+	double					  SamplesPerSecond = 0.;
+	double					  RaysPerSecond = 0.;
+	double					  RMSE = -1.; // Negative without a reference
+	TArray<FConvergencePoint> Convergence;
+
+	[[nodiscard]] String ToJson() const
+	{
+		std::ostringstream Json;
+		Json.precision(9);
+		Json << "{\n"
+			 << "\t\"Scene\": \"CornellBox\",\n"
+			 << "\t\"Backend\": \"CPU\",\n"
+			 << "\t\"Width\": " << Width << ",\n"
+			 << "\t\"Height\": " << Height << ",\n"
+			 << "\t\"Threads\": " << Threads << ",\n"
+			 << "\t\"Triangles\": " << Triangles << ",\n"
+			 << "\t\"SamplesPerPixel\": " << SamplesPerPixel << ",\n"
+			 << "\t\"RenderSeconds\": " << RenderSeconds << ",\n"
+			 << "\t\"BlasBuildSeconds\": " << BlasBuildSeconds << ",\n"
+			 << "\t\"TlasBuildSeconds\": " << TlasBuildSeconds << ",\n"
+			 << "\t\"SamplesPerSecond\": " << SamplesPerSecond << ",\n"
+			 << "\t\"RaysPerSecond\": " << RaysPerSecond << ",\n"
+			 << "\t\"RMSE\": ";
+		if (RMSE < 0.)
+			Json << "null";
+		else
+			Json << RMSE;
+		Json << ",\n\t\"Convergence\": [";
+		for (size_t i = 0; i < Convergence.size(); i++)
+		{
+			const auto& Point = Convergence[i];
+			Json << (i ? ",\n\t\t" : "\n\t\t") << "{ \"SamplesPerPixel\": " << Point.SamplesPerPixel
+				 << ", \"Seconds\": " << Point.Seconds << ", \"RMSE\": " << Point.RMSE << " }";
+		}
+		Json << (Convergence.empty() ? "]\n}\n" : "\n\t]\n}\n");
+		return Json.str();
+	}
+};
+
+/**
+ * Progressive rendering benchmark of the Cornell box with the CPU path tracer.
+ * Samples are added in passes of growing size, the error against the reference is recorded after each pass
+ * (outside the timed region), so the result also describes the convergence rate.
+ * Empty when the reference image given in the settings cannot be used.
+ * Run it with
+ *	MechEngineExamples --benchmark [--spp N | --time Seconds] [--size W H] [--reference image.pfm|none] [--out result.json]
+ */
+inline std::optional<FRenderBenchmarkResult> RunCornellBoxBenchmark(const FRenderBenchmarkSettings& Settings)
+{
+	FRenderBenchmarkResult Result;
+	Result.Width = Settings.Width;
+	Result.Height = Settings.Height;
+	Result.Threads = JobSystem::Get().NumWorkers() + 1;
+
+	FCpuCamera Camera;
+	CpuScene   Scene = CpuScene::FromSnapshot(CornellBoxSnapshot(), &Camera);
+	Result.Triangles = Scene.NumTriangles();
+	Result.BlasBuildSeconds = Scene.GetBuildStats().BlasSeconds;
+	Result.TlasBuildSeconds = Scene.GetBuildStats().TlasSeconds;
+
+	TArray<Vector3f> Reference;
+	if (!Settings.ReferenceImage.empty())
+	{
+		// Only the cached reference is rendered again, a file given by the user is never overwritten
+		bool IsCached = Settings.ReferenceImage == Settings.DefaultReferenceImage();
+		int	 ReferenceWidth = 0, ReferenceHeight = 0;
+		if (std::filesystem::exists(Settings.ReferenceImage))
+			Reference = CpuPathTracer::LoadImage(Settings.ReferenceImage, ReferenceWidth, ReferenceHeight);
+		if (!Reference.empty() && (ReferenceWidth != Settings.Width || ReferenceHeight != Settings.Height))
+		{
+			if (!IsCached)
+			{
+				LOG_ERROR("Reference image {} is {}x{}, the benchmark renders {}x{}", Settings.ReferenceImage.string(), ReferenceWidth, ReferenceHeight,
+					Settings.Width, Settings.Height);
+				return std::nullopt;
+			}
+			LOG_WARNING("Reference image {} is {}x{}, rendering a new one", Settings.ReferenceImage.string(), ReferenceWidth, ReferenceHeight);
+			Reference.clear();
+		}
+		if (Reference.empty() && !IsCached)
+		{
+			LOG_ERROR("Failed to load reference image: {}", Settings.ReferenceImage.string());
+			return std::nullopt;
+		}
+		if (Reference.empty())
+		{
+			LOG_INFO("Rendering reference image at {} spp", Settings.ReferenceSamplesPerPixel);
+			// Another seed, so the benchmark samples are independent of the reference
+			CpuPathTracer ReferenceTracer(Scene, Camera, Settings.Width, Settings.Height, 1);
+			ReferenceTracer.RenderSamples(Settings.ReferenceSamplesPerPixel);
+			Path::CreateDirectory(Settings.ReferenceImage.parent_path());
+			ReferenceTracer.SaveImage(Settings.ReferenceImage);
+			Reference = ReferenceTracer.GetImage();
+		}
+	}
+
+	CpuPathTracer Tracer(Scene, Camera, Settings.Width, Settings.Height);
+	auto		  IsDone = [&] {
+		return Settings.TimeBudget > 0. ? Tracer.GetStats().RenderSeconds >= Settings.TimeBudget
+										: Tracer.GetSamplesPerPixel() >= Settings.SamplesPerPixel;
+	};
+	while (!IsDone())
+	{
+		// Double the sample count up to 16 spp per pass, fine grained early on for the convergence curve
+		int PassSamples = std::clamp(Tracer.GetSamplesPerPixel(), 1, 16);
+		if (Settings.TimeBudget <= 0.)
+			PassSamples = std::min(PassSamples, Settings.SamplesPerPixel - Tracer.GetSamplesPerPixel());
+		Tracer.RenderSamples(PassSamples);
+		if (!Reference.empty())
+			Result.Convergence.push_back({ Tracer.GetSamplesPerPixel(), Tracer.GetStats().RenderSeconds, ImageRMSE(Tracer.GetImage(), Reference) });
+	}
+
+	const auto& Stats = Tracer.GetStats();
+	Result.SamplesPerPixel = Tracer.GetSamplesPerPixel();
+	Result.RenderSeconds = Stats.RenderSeconds;
+	Result.SamplesPerSecond = Stats.Samples / std::max(Stats.RenderSeconds, 1e-9);
+	Result.RaysPerSecond = Stats.Rays / std::max(Stats.RenderSeconds, 1e-9);
+	if (!Result.Convergence.empty())
+		Result.RMSE = Result.Convergence.back().RMSE;
+	return Result;
+}
+
+// Entry point of the --benchmark command line mode, prints the result as JSON
+inline int CornellBoxBenchmarkMain(int argc, char* argv[])
+{
+	auto PrintUsage = [] {
+		std::cerr << "Usage: MechEngineExamples --benchmark [--spp N | --time Seconds] [--size W H] [--reference image.pfm|none] [--out result.json]\n";
+		return 1;
+	};
+	FRenderBenchmarkSettings Settings;
+	std::optional<Path>		 Reference; // The keyed file in the example cache by default
+	Path					 Output;
+	for (int i = 2; i < argc; i++)
+	{
+		String Option = argv[i];
+		if (Option == "--spp" && i + 1 < argc)
+		{
+			if (!ParseArgument("--spp", argv[++i], Settings.SamplesPerPixel, 1))
+				return PrintUsage();
+		}
+		else if (Option == "--time" && i + 1 < argc)
+		{
+			if (!ParseArgument("--time", argv[++i], Settings.TimeBudget, 0.))
+				return PrintUsage();
+		}
+		else if (Option == "--size" && i + 2 < argc)
+		{
+			if (!ParseArgument("--size", argv[++i], Settings.Width, 1, 16384) || !ParseArgument("--size", argv[++i], Settings.Height, 1, 16384))
+				return PrintUsage();
+		}
+		else if (Option == "--reference" && i + 1 < argc)
+		{
+			String ReferenceOption = argv[++i];
+			Reference = ReferenceOption == "none" ? Path() : Path(ReferenceOption);
+		}
+		else if (Option == "--out" && i + 1 < argc)
+			Output = argv[++i];
+		else
+		{
+			LOG_ERROR("Unknown benchmark option: {}", Option);
+			return PrintUsage();
+		}
+	}
+	Settings.ReferenceImage = Reference.value_or(Settings.DefaultReferenceImage());
+
+	auto Result = RunCornellBoxBenchmark(Settings);
+	if (!Result)
+		return 1;
+	String Json = Result->ToJson();
+	std::cout << Json;
+	if (!Output.empty())
+	{
+		std::ofstream OutFile(Output);
+		if (!(OutFile << Json))
+		{
+			LOG_ERROR("Failed to write benchmark result: {}", Output.string());
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,407 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include "CoreMinimal.h"
+
+/**
+ * Ray and hit record of the CPU renderer, in single precision.
+ */
+struct FCpuRay
+{
+	Vector3f Origin = Vector3f::Zero();
+	Vector3f Direction = Vector3f::UnitX();
+	float	 TMin = 1e-4f;
+	float	 TMax = std::numeric_limits<float>::infinity();
+};
+
+struct FCpuHit
+{
+	float T = std::numeric_limits<float>::infinity();
+	int	  Instance = -1;
+	int	  Triangle = -1;
+	float U = 0.f, V = 0.f;
+
+	[[nodiscard]] bool IsValid() const { return Triangle >= 0; }
+};
+
+/**
+ * Packet of PacketSize rays stored as structure of arrays, so the per-lane loops vectorize.
+ * Inactive lanes have TMax < TMin.
+ */
+template <int PacketSize>
+struct TCpuRayPacket
+{
+	std::array<float, PacketSize> Origin[3];
+	std::array<float, PacketSize> InvDirection[3];
+	std::array<float, PacketSize> TMin;
+	std::array<float, PacketSize> TMax;
+
+	void Set(int Lane, const FCpuRay& Ray)
+	{
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			Origin[Axis][Lane] = Ray.Origin[Axis];
+			InvDirection[Axis][Lane] = 1.f / Ray.Direction[Axis];
+		}
+		TMin[Lane] = Ray.TMin;
+		TMax[Lane] = Ray.TMax;
+	}
+};
+
+/**
+ * Bounding volume hierarchy over arbitrary primitives, built with binned SAH.
+ * Nodes are stored in depth first order, children always after their parent, so a refit is a reverse sweep.
+ * Used as bottom level over triangles and as top level over instances.
+ */
+class CpuBVH
+{
+public:
+	struct FNode
+	{
+		Vector3f Min;
+		int		 First; // Leaf: first primitive in PrimitiveIndices. Inner: index of the right child, the left is next
+		Vector3f Max;
+		int		 Count; // Leaf: number of primitives. Inner: -1 - split axis
+
+		[[nodiscard]] bool IsLeaf() const { return Count > 0; }
+		[[nodiscard]] int  SplitAxis() const { return -1 - Count; }
+	};
+
+	static constexpr int MaxLeafSize = 4;
+	static constexpr int NumBins = 12;
+
+	void Build(const TArray<AlignedBox3f>& PrimitiveBounds)
+	{
+		Nodes.clear();
+		Depth = 0;
+		PrimitiveIndices.resize(PrimitiveBounds.size());
+		for (int i = 0; i < static_cast<int>(PrimitiveIndices.size()); i++)
+			PrimitiveIndices[i] = i;
+		if (PrimitiveBounds.empty())
+			return;
+		Nodes.reserve(PrimitiveBounds.size() * 2);
+		BuildRecursive(PrimitiveBounds, 0, static_cast<int>(PrimitiveBounds.size()), 0);
+	}
+
+	// Recompute the node bounds from new primitive bounds, keeping the topology. Cheaper than Build but degrades with large motions
+	void Refit(const TArray<AlignedBox3f>& PrimitiveBounds)
+	{
+		for (int Index = static_cast<int>(Nodes.size()) - 1; Index >= 0; Index--)
+		{
+			FNode&		  Node = Nodes[Index];
+			AlignedBox3f Bounds;
+			if (Node.IsLeaf())
+			{
+				for (int i = Node.First; i < Node.First + Node.Count; i++)
+					Bounds.extend(PrimitiveBounds[PrimitiveIndices[i]]);
+			}
+			else
+			{
+				Bounds = NodeBounds(Index + 1).merged(NodeBounds(Node.First));
+			}
+			Node.Min = Bounds.min();
+			Node.Max = Bounds.max();
+		}
+	}
+
+	[[nodiscard]] bool IsEmpty() const { return Nodes.empty(); }
+	// Levels below the root, unbounded: the SAH splits of unevenly spaced primitives can build deep trees
+	[[nodiscard]] int GetDepth() const { return Depth; }
+	[[nodiscard]] const TArray<FNode>& GetNodes() const { return Nodes; }
+	// Primitives of a leaf are GetPrimitiveIndices()[First, First + Count)
+	[[nodiscard]] const TArray<int>& GetPrimitiveIndices() const { return PrimitiveIndices; }
+	[[nodiscard]] AlignedBox3f GetBounds() const { return IsEmpty() ? AlignedBox3f() : NodeBounds(0); }
+
+	/**
+	 * Visit the primitives whose leaves the ray reaches, near child first.
+	 * IntersectPrimitive(PrimitiveIndex, Ray) returns true on a hit and shrinks Ray.TMax. Return true if any primitive was hit.
+	 * With AnyHit the traversal stops at the first hit, for shadow rays.
+	 */
+	template <class IntersectT>
+	bool Traverse(FCpuRay& Ray, IntersectT&& IntersectPrimitive, bool AnyHit = false) const
+	{
+		if (IsEmpty())
+			return false;
+		const Vector3f	InvDirection = Ray.Direction.cwiseInverse();
+		FTraversalStack Stack(Depth + 1);
+		int				Index = 0;
+		bool		   Hit = false;
+		if (!IntersectBox(Nodes[0], Ray.Origin, InvDirection, Ray.TMin, Ray.TMax))
+			return false;
+		while (true)
+		{
+			const FNode& Node = Nodes[Index];
+			if (Node.IsLeaf())
+			{
+				for (int i = Node.First; i < Node.First + Node.Count; i++)
+				{
+					if (IntersectPrimitive(PrimitiveIndices[i], Ray))
+					{
+						Hit = true;
+						if (AnyHit)
+							return true;
+					}
+				}
+			}
+			else
+			{
+				int	  Left = Index + 1, Right = Node.First;
+				float TLeft = IntersectBox(Nodes[Left], Ray.Origin, InvDirection, Ray.TMin, Ray.TMax);
+				float TRight = IntersectBox(Nodes[Right], Ray.Origin, InvDirection, Ray.TMin, Ray.TMax);
+				if (TLeft > 0.f && TRight > 0.f)
+				{
+					if (TRight < TLeft)
+						std::swap(Left, Right);
+					Stack.Push(Right);
+					Index = Left;
+					continue;
+				}
+				if (TLeft > 0.f || TRight > 0.f)
+				{
+					Index = TLeft > 0.f ? Left : Right;
+					continue;
+				}
+			}
+			if (Stack.IsEmpty())
+				break;
+			Index = Stack.Pop();
+		}
+		return Hit;
+	}
+
+	// Visit(PrimitiveIndex) for the primitives of the leaves whose bounds overlap Box
+	template <class VisitT>
+	void TraverseBox(const AlignedBox3f& Box, VisitT&& Visit) const
+	{
+		if (IsEmpty())
+			return;
+		FTraversalStack Stack(Depth + 1);
+		Stack.Push(0);
+		while (!Stack.IsEmpty())
+		{
+			int			 Index = Stack.Pop();
+			const FNode& Node = Nodes[Index];
+			if ((Node.Min.array() > Box.max().array()).any() || (Node.Max.array() < Box.min().array()).any())
+				continue;
+			if (Node.IsLeaf())
+			{
+				for (int i = Node.First; i < Node.First + Node.Count; i++)
+					Visit(PrimitiveIndices[i]);
+				continue;
+			}
+			Stack.Push(Node.First);
+			Stack.Push(Index + 1);
+		}
+	}
+
+	/**
+	 * Packet traversal: a node is visited when any active lane reaches it, so coherent rays share the node fetches
+	 * and the box tests run as one loop over the lanes.
+	 * IntersectPrimitive(PrimitiveIndex, LaneMask, Packet) tests the lanes in LaneMask and shrinks their TMax.
+	 */
+	template <int PacketSize, class IntersectT>
+	void TraversePacket(TCpuRayPacket<PacketSize>& Packet, IntersectT&& IntersectPrimitive) const
+	{
+		static_assert(PacketSize <= 32);
+		if (IsEmpty())
+			return;
+		FTraversalStack Stack(Depth + 1);
+		Stack.Push(0);
+		while (!Stack.IsEmpty())
+		{
+			const FNode& Node = Nodes[Stack.Pop()];
+			uint32_t	 LaneMask = IntersectBoxPacket(Node, Packet);
+			if (LaneMask == 0)
+				continue;
+			if (Node.IsLeaf())
+			{
+				for (int i = Node.First; i < Node.First + Node.Count; i++)
+					IntersectPrimitive(PrimitiveIndices[i], LaneMask, Packet);
+			}
+			else
+			{
+				// Visit the child nearer to the first active lane first
+				int	 Left = static_cast<int>(&Node - Nodes.data()) + 1, Right = Node.First;
+				int	 Lane = std::countr_zero(LaneMask);
+				bool RightFirst = Packet.InvDirection[Node.SplitAxis()][Lane] < 0.f;
+				Stack.Push(RightFirst ? Left : Right);
+				Stack.Push(RightFirst ? Right : Left);
+			}
+		}
+	}
+
+protected:
+	TArray<FNode> Nodes;
+	TArray<int>	  PrimitiveIndices;
+	int			  Depth = 0;
+
+	// Stack of the nodes left to visit, in place up to the usual depths and on the heap for deeper trees
+	class FTraversalStack
+	{
+	public:
+		explicit FTraversalStack(int Capacity)
+		{
+			if (Capacity > InlineCapacity)
+			{
+				Heap.resize(Capacity);
+				Data = Heap.data();
+			}
+		}
+		FTraversalStack(const FTraversalStack&) = delete;
+		FTraversalStack& operator=(const FTraversalStack&) = delete;
+
+		void			   Push(int Index) { Data[Size++] = Index; }
+		int				   Pop() { return Data[--Size]; }
+		[[nodiscard]] bool IsEmpty() const { return Size == 0; }
+
+	protected:
+		static constexpr int InlineCapacity = 64;
+		int					 Inline[InlineCapacity];
+		TArray<int>			 Heap;
+		int*				 Data = Inline;
+		int					 Size = 0;
+	};
+
+	[[nodiscard]] AlignedBox3f NodeBounds(int Index) const { return AlignedBox3f(Nodes[Index].Min, Nodes[Index].Max); }
+
+	// Entry distance plus one if the ray hits the box, zero otherwise. The offset keeps hits at t = 0 distinguishable
+	static float IntersectBox(const FNode& Node, const Vector3f& Origin, const Vector3f& InvDirection, float TMin, float TMax)
+	{
+		Vector3f T0 = (Node.Min - Origin).cwiseProduct(InvDirection);
+		Vector3f T1 = (Node.Max - Origin).cwiseProduct(InvDirection);
+		float	 Near = std::max(T0.cwiseMin(T1).maxCoeff(), TMin);
+		float	 Far = std::min(T0.cwiseMax(T1).minCoeff(), TMax);
+		return Near <= Far ? Near + 1.f : 0.f;
+	}
+
+	template <int PacketSize>
+	static uint32_t IntersectBoxPacket(const FNode& Node, const TCpuRayPacket<PacketSize>& Packet)
+	{
+		std::array<float, PacketSize> Near = Packet.TMin, Far = Packet.TMax;
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			for (int Lane = 0; Lane < PacketSize; Lane++)
+			{
+				float T0 = (Node.Min[Axis] - Packet.Origin[Axis][Lane]) * Packet.InvDirection[Axis][Lane];
+				float T1 = (Node.Max[Axis] - Packet.Origin[Axis][Lane]) * Packet.InvDirection[Axis][Lane];
+				Near[Lane] = std::max(Near[Lane], std::min(T0, T1));
+				Far[Lane] = std::min(Far[Lane], std::max(T0, T1));
+			}
+		}
+		uint32_t Mask = 0;
+		for (int Lane = 0; Lane < PacketSize; Lane++)
+			Mask |= uint32_t(Near[Lane] <= Far[Lane]) << Lane;
+		return Mask;
+	}
+
+	void MakeLeaf(int NodeIndex, const TArray<AlignedBox3f>& PrimitiveBounds, int Begin, int End)
+	{
+		AlignedBox3f Bounds;
+		for (int i = Begin; i < End; i++)
+			Bounds.extend(PrimitiveBounds[PrimitiveIndices[i]]);
+		Nodes[NodeIndex] = { Bounds.min(), Begin, Bounds.max(), End - Begin };
+	}
+
+	int BuildRecursive(const TArray<AlignedBox3f>& PrimitiveBounds, int Begin, int End, int Level)
+	{
+		int NodeIndex = static_cast<int>(Nodes.size());
+		Nodes.emplace_back();
+		Depth = std::max(Depth, Level);
+		if (End - Begin <= MaxLeafSize)
+		{
+			MakeLeaf(NodeIndex, PrimitiveBounds, Begin, End);
+			return NodeIndex;
+		}
+
+		AlignedBox3f Bounds, CentroidBounds;
+		for (int i = Begin; i < End; i++)
+		{
+			Bounds.extend(PrimitiveBounds[PrimitiveIndices[i]]);
+			CentroidBounds.extend(PrimitiveBounds[PrimitiveIndices[i]].center());
+		}
+
+		// Binned SAH over the axes of the centroid bounds
+		float BestCost = std::numeric_limits<float>::infinity();
+		int	  BestAxis = -1, BestSplit = 0;
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			float Low = CentroidBounds.min()[Axis], High = CentroidBounds.max()[Axis];
+			if (High - Low < 1e-12f)
+				continue;
+			AlignedBox3f BinBounds[NumBins];
+			int			 BinCounts[NumBins] = {};
+			float		 Scale = NumBins / (High - Low);
+			for (int i = Begin; i < End; i++)
+			{
+				const auto& PrimBounds = PrimitiveBounds[PrimitiveIndices[i]];
+				int			Bin = std::min(NumBins - 1, static_cast<int>((PrimBounds.center()[Axis] - Low) * Scale));
+				BinBounds[Bin].extend(PrimBounds);
+				BinCounts[Bin]++;
+			}
+			// Sweep from the right to get the cost of every split in linear time
+			float		 RightArea[NumBins];
+			AlignedBox3f RightBounds;
+			int			 RightCount = 0;
+			for (int Bin = NumBins - 1; Bin > 0; Bin--)
+			{
+				RightBounds.extend(BinBounds[Bin]);
+				RightCount += BinCounts[Bin];
+				RightArea[Bin] = RightCount > 0 ? SurfaceArea(RightBounds) * RightCount : 0.f;
+			}
+			AlignedBox3f LeftBounds;
+			int			 LeftCount = 0;
+			for (int Bin = 0; Bin < NumBins - 1; Bin++)
+			{
+				LeftBounds.extend(BinBounds[Bin]);
+				LeftCount += BinCounts[Bin];
+				float Cost = (LeftCount > 0 ? SurfaceArea(LeftBounds) * LeftCount : 0.f) + RightArea[Bin + 1];
+				if (LeftCount > 0 && LeftCount < End - Begin && Cost < BestCost)
+				{
+					BestCost = Cost;
+					BestAxis = Axis;
+					BestSplit = Bin;
+				}
+			}
+		}
+
+		int Middle;
+		if (BestAxis < 0)
+		{
+			// All centroids coincide, split in the middle
+			Middle = (Begin + End) / 2;
+			BestAxis = 0;
+		}
+		else
+		{
+			float LeafCost = SurfaceArea(Bounds) * (End - Begin);
+			if (End - Begin <= MaxLeafSize * 2 && BestCost >= LeafCost)
+			{
+				MakeLeaf(NodeIndex, PrimitiveBounds, Begin, End);
+				return NodeIndex;
+			}
+			float Low = CentroidBounds.min()[BestAxis];
+			float Scale = NumBins / (CentroidBounds.max()[BestAxis] - Low);
+			Middle = static_cast<int>(std::partition(PrimitiveIndices.begin() + Begin, PrimitiveIndices.begin() + End, [&](int Primitive) {
+				int Bin = std::min(NumBins - 1, static_cast<int>((PrimitiveBounds[Primitive].center()[BestAxis] - Low) * Scale));
+				return Bin <= BestSplit;
+			}) - PrimitiveIndices.begin());
+			if (Middle == Begin || Middle == End)
+				Middle = (Begin + End) / 2;
+		}
+
+		BuildRecursive(PrimitiveBounds, Begin, Middle, Level + 1);
+		int Right = BuildRecursive(PrimitiveBounds, Middle, End, Level + 1);
+		Nodes[NodeIndex] = { Bounds.min(), Right, Bounds.max(), -1 - BestAxis };
+		return NodeIndex;
+	}
+
+	static float SurfaceArea(const AlignedBox3f& Bounds)
+	{
+		if (Bounds.isEmpty())
+			return 0.f;
+		Vector3f Extent = Bounds.sizes();
+		return 2.f * (Extent.x() * Extent.y() + Extent.y() * Extent.z() + Extent.z() * Extent.x());
+	}
+};
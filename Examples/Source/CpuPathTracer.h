@@ -0,0 +1,280 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include "CoreMinimal.h"
+#include "CpuScene.h"
+#include "JobSystem.h"
+#include "Misc/Path.h"
+
+// Root mean square error over all pixels and channels
+inline double ImageRMSE(const TArray<Vector3f>& Image, const TArray<Vector3f>& Reference)
+{
+	ASSERT(Image.size() == Reference.size());
+	double SquaredError = 0.;
+	for (size_t i = 0; i < Image.size(); i++)
+		SquaredError += (Image[i] - Reference[i]).cast<double>().squaredNorm();
+	return Image.empty() ? 0. : std::sqrt(SquaredError / (Image.size() * 3));
+}
+
+/**
+ * Progressive CPU path tracer for a CpuScene, the reference and fallback for the GPU renderer.
+ * Diffuse materials only, with next event estimation on the area lights and cosine-weighted bounces.
+ * The image is split into tiles scheduled on the job system, camera rays are traced as 2x2 packets.
+ * Each call to RenderSamples adds samples to the accumulation buffer, so rendering can stop at any time.
+ */
+class CpuPathTracer
+{
+public:
+	static constexpr int TileSize = 16;
+	static constexpr int MaxBounces = 8;
+	// Bump when a change alters the rendered image, cached reference images are keyed on it
+	static constexpr int Version = 1;
+
+	struct FStats
+	{
+		int64_t Samples = 0; // Per pixel samples times pixels
+		int64_t Rays = 0;	 // Closest hit and shadow rays
+		double	RenderSeconds = 0.;
+	};
+
+	// Tracers with different seeds produce independent images, e.g. for a reference render
+	CpuPathTracer(const CpuScene& InScene, const FCpuCamera& InCamera, int InWidth, int InHeight, uint64_t InSeed = 0)
+		: Scene(InScene), Camera(InCamera), Width(InWidth), Height(InHeight), Seed(InSeed)
+		, Accumulation(static_cast<size_t>(InWidth) * InHeight, Vector3f::Zero()) {}
+
+	[[nodiscard]] int GetWidth() const { return Width; }
+	[[nodiscard]] int GetHeight() const { return Height; }
+	[[nodiscard]] int GetSamplesPerPixel() const { return SamplesPerPixel; }
+	[[nodiscard]] const FStats& GetStats() const { return Stats; }
+
+	// Add SampleCount samples to every pixel
+	void RenderSamples(int SampleCount, JobSystem& Jobs = JobSystem::Get())
+	{
+		PROFILE_SCOPE("CpuPathTracer::RenderSamples");
+		auto				 StartTime = std::chrono::steady_clock::now();
+		int					 TilesX = (Width + TileSize - 1) / TileSize, TilesY = (Height + TileSize - 1) / TileSize;
+		std::atomic<int64_t> RayCount = 0;
+		Jobs.ParallelFor(TilesX * TilesY, [&](int Tile) {
+			RayCount.fetch_add(RenderTile(Tile % TilesX * TileSize, Tile / TilesX * TileSize, SampleCount), std::memory_order_relaxed);
+		});
+		SamplesPerPixel += SampleCount;
+		Stats.Samples += static_cast<int64_t>(SampleCount) * Width * Height;
+		Stats.Rays += RayCount.load();
+		Stats.RenderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+	}
+
+	void Reset()
+	{
+		std::fill(Accumulation.begin(), Accumulation.end(), Vector3f::Zero());
+		SamplesPerPixel = 0;
+		Stats = {};
+	}
+
+	// Mean radiance per pixel, row major from the top left
+	[[nodiscard]] TArray<Vector3f> GetImage() const
+	{
+		TArray<Vector3f> Image(Accumulation.size());
+		float			 Scale = SamplesPerPixel > 0 ? 1.f / SamplesPerPixel : 0.f;
+		for (size_t i = 0; i < Image.size(); i++)
+			Image[i] = Accumulation[i] * Scale;
+		return Image;
+	}
+
+	// Save the image as .pfm (linear radiance) or .ppm (gamma corrected, clamped)
+	bool SaveImage(const Path& FilePath) const
+	{
+		return SaveImage(GetImage(), Width, Height, FilePath);
+	}
+
+	static bool SaveImage(const TArray<Vector3f>& Image, int Width, int Height, const Path& FilePath)
+	{
+		std::fstream OutFile(FilePath, std::ios::out | std::ios::binary);
+		if (!OutFile.is_open())
+		{
+			LOG_ERROR("Failed to open file: {}", FilePath.string());
+			return false;
+		}
+		if (FilePath.extension() == ".pfm")
+		{
+			// Little endian, rows from the bottom
+			OutFile << "PF\n" << Width << " " << Height << "\n-1.0\n";
+			for (int Y = Height - 1; Y >= 0; Y--)
+				OutFile.write(reinterpret_cast<const char*>(Image.data() + static_cast<size_t>(Y) * Width), sizeof(Vector3f) * Width);
+		}
+		else
+		{
+			OutFile << "P6\n" << Width << " " << Height << "\n255\n";
+			TArray<uint8_t> Row(Width * 3);
+			for (int Y = 0; Y < Height; Y++)
+			{
+				for (int X = 0; X < Width; X++)
+					for (int Channel = 0; Channel < 3; Channel++)
+						Row[X * 3 + Channel] = static_cast<uint8_t>(std::lround(std::pow(std::clamp(Image[Y * Width + X][Channel], 0.f, 1.f), 1.f / 2.2f) * 255.f));
+				OutFile.write(reinterpret_cast<const char*>(Row.data()), Row.size());
+			}
+		}
+		return OutFile.good();
+	}
+
+	// Load a little endian .pfm written by SaveImage, empty on failure
+	static TArray<Vector3f> LoadImage(const Path& FilePath, int& OutWidth, int& OutHeight)
+	{
+		std::fstream InFile(FilePath, std::ios::in | std::ios::binary);
+		String		 Magic;
+		float		 Scale = 0.f;
+		if (!(InFile >> Magic >> OutWidth >> OutHeight >> Scale) || Magic != "PF" || Scale >= 0.f || OutWidth <= 0 || OutHeight <= 0)
+		{
+			LOG_ERROR("Failed to load pfm image: {}", FilePath.string());
+			return {};
+		}
+		InFile.get();
+		TArray<Vector3f> Image(static_cast<size_t>(OutWidth) * OutHeight);
+		for (int Y = OutHeight - 1; Y >= 0; Y--)
+			InFile.read(reinterpret_cast<char*>(Image.data() + static_cast<size_t>(Y) * OutWidth), sizeof(Vector3f) * OutWidth);
+		if (!InFile)
+		{
+			LOG_ERROR("Truncated pfm image: {}", FilePath.string());
+			return {};
+		}
+		return Image;
+	}
+
+protected:
+	const CpuScene&	 Scene;
+	FCpuCamera		 Camera;
+	int				 Width, Height;
+	uint64_t		 Seed;
+	int				 SamplesPerPixel = 0;
+	TArray<Vector3f> Accumulation;
+	FStats			 Stats;
+
+	// PCG32, one stream per pixel and sample so images do not depend on the tile schedule
+	struct FRandom
+	{
+		uint64_t State;
+
+		FRandom(uint64_t Pixel, uint64_t Sample, uint64_t Seed = 0)
+			: State((Pixel * 0x9E3779B97F4A7C15ull) ^ (Sample * 0xD1B54A32D192ED03ull) ^ (Seed * 0xA0761D6478BD642Full))
+		{
+			Next();
+		}
+
+		uint32_t Next()
+		{
+			uint64_t Old = State;
+			State = Old * 6364136223846793005ull + 1442695040888963407ull;
+			uint32_t XorShifted = static_cast<uint32_t>(((Old >> 18u) ^ Old) >> 27u);
+			uint32_t Rotation = static_cast<uint32_t>(Old >> 59u);
+			return (XorShifted >> Rotation) | (XorShifted << ((~Rotation + 1u) & 31));
+		}
+
+		float Uniform() { return static_cast<float>(Next() >> 8) * 0x1p-24f; }
+	};
+
+	int64_t RenderTile(int TileX, int TileY, int SampleCount)
+	{
+		PROFILE_SCOPE("CpuPathTracer::RenderTile");
+		int64_t Rays = 0;
+		float	Aspect = static_cast<float>(Width) / Height;
+		for (int Sample = 0; Sample < SampleCount; Sample++)
+		{
+			int SampleIndex = SamplesPerPixel + Sample;
+			for (int Y = TileY; Y < std::min(TileY + TileSize, Height); Y += 2)
+			{
+				for (int X = TileX; X < std::min(TileX + TileSize, Width); X += 2)
+				{
+					// 2x2 pixel block as one camera ray packet
+					std::array<FCpuRay, 4> Rays4;
+					std::array<FCpuHit, 4> Hits4;
+					std::array<int, 4>	   Pixels;
+					FRandom				   Randoms[4] = { { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 } };
+					for (int Lane = 0; Lane < 4; Lane++)
+					{
+						int PixelX = std::min(X + Lane % 2, Width - 1), PixelY = std::min(Y + Lane / 2, Height - 1);
+						Pixels[Lane] = PixelY * Width + PixelX;
+						Randoms[Lane] = FRandom(Pixels[Lane], SampleIndex, Seed);
+						Rays4[Lane] = Camera.GenerateRay((PixelX + Randoms[Lane].Uniform()) / Width, (PixelY + Randoms[Lane].Uniform()) / Height, Aspect);
+					}
+					Scene.IntersectPacket<4>(Rays4, Hits4);
+					Rays += 4;
+					for (int Lane = 0; Lane < 4; Lane++)
+					{
+						// Duplicated lanes at the image border are traced but not accumulated
+						bool Duplicate = false;
+						for (int Other = 0; Other < Lane; Other++)
+							Duplicate |= Pixels[Other] == Pixels[Lane];
+						if (!Duplicate)
+							Accumulation[Pixels[Lane]] += Shade(Rays4[Lane], Hits4[Lane], Randoms[Lane], Rays);
+					}
+				}
+			}
+		}
+		return Rays;
+	}
+
+	// Radiance along a camera ray whose closest hit is already known
+	Vector3f Shade(FCpuRay Ray, FCpuHit Hit, FRandom& Random, int64_t& Rays) const
+	{
+		Vector3f Radiance = Vector3f::Zero();
+		Vector3f Throughput = Vector3f::Ones();
+		for (int Bounce = 0; Bounce < MaxBounces; Bounce++)
+		{
+			if (Bounce > 0)
+			{
+				Hit = {};
+				Scene.Intersect(Ray, Hit);
+				Rays++;
+			}
+			// Emission is only added for camera rays, later bounces account for the lights through next event estimation
+			if (Bounce == 0)
+			{
+				for (const auto& Light : Scene.GetAreaLights())
+					if (Light.Intersect(Ray) < Hit.T)
+						return Light.Radiance;
+			}
+			if (!Hit.IsValid())
+				break;
+
+			const Vector3f Position = Ray.Origin + Ray.Direction * Hit.T;
+			Vector3f	   Normal = Scene.HitNormal(Hit).normalized();
+			if (Normal.dot(Ray.Direction) > 0.f)
+				Normal = -Normal;
+			const Vector3f Albedo = Scene.GetMaterial(Scene.GetInstance(Hit.Instance).Material).BaseColor;
+			const Vector3f Origin = Position + Normal * 1e-4f;
+
+			// Next event estimation, one sample per area light
+			for (const auto& Light : Scene.GetAreaLights())
+			{
+				Vector3f LightPoint = Light.Center + (Random.Uniform() - 0.5f) * Light.EdgeU + (Random.Uniform() - 0.5f) * Light.EdgeV;
+				Vector3f ToLight = LightPoint - Origin;
+				float	 Distance2 = ToLight.squaredNorm();
+				Vector3f Direction = ToLight / std::sqrt(Distance2);
+				float	 CosSurface = Normal.dot(Direction);
+				float	 CosLight = -Light.Normal.dot(Direction);
+				if (CosSurface <= 0.f || CosLight <= 0.f)
+					continue;
+				Rays++;
+				if (Scene.Occluded({ Origin, Direction, 1e-4f, std::sqrt(Distance2) * (1.f - 1e-4f) }))
+					continue;
+				Radiance += Throughput.cwiseProduct(Albedo).cwiseProduct(Light.Radiance) * (CosSurface * CosLight * Light.Area() / (Distance2 * static_cast<float>(M_PI)));
+			}
+
+			// Cosine-weighted bounce, the diffuse BRDF and the pdf cancel to the albedo
+			Throughput = Throughput.cwiseProduct(Albedo);
+			if (Bounce >= 3)
+			{
+				float Survive = std::min(0.95f, Throughput.maxCoeff());
+				if (Random.Uniform() >= Survive)
+					break;
+				Throughput /= Survive;
+			}
+			float	 Phi = 2.f * static_cast<float>(M_PI) * Random.Uniform();
+			float	 R2 = Random.Uniform();
+			Vector3f Tangent = (std::abs(Normal.x()) > 0.9f ? Vector3f::UnitY() : Vector3f::UnitX()).cross(Normal).normalized();
+			Vector3f Bitangent = Normal.cross(Tangent);
+			Ray = { Origin, (Tangent * (std::cos(Phi) * std::sqrt(R2)) + Bitangent * (std::sin(Phi) * std::sqrt(R2)) + Normal * std::sqrt(1.f - R2)).normalized() };
+		}
+		return Radiance;
+	}
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include "CornellBox.h"
+#include "CpuPathTracer.h"
+
+/**
+ * Render the Cornell box offline with the CPU path tracer, without creating a window or a GPU device.
+ * Useful on headless machines and as the ground truth image for the GPU renderer.
+ * Output is a .ppm (tone mapped) or a .pfm (linear radiance) file, e.g.
+ *	MechEngineExamples --cpu-render CornellBox.pfm 256
+ */
+inline bool RenderCornellBoxOffline(const Path& Output, int Width = 512, int Height = 512, int SamplesPerPixel = 64)
+{
+	FCpuCamera Camera;
+	CpuScene   Scene = CpuScene::FromSnapshot(CornellBoxSnapshot(), &Camera);
+
+	CpuPathTracer Tracer(Scene, Camera, Width, Height);
+	Tracer.RenderSamples(SamplesPerPixel);
+	const auto& Stats = Tracer.GetStats();
+	LOG_INFO("CPU render {}x{} at {} spp in {:.2f}s, {:.2f} Mrays/s", Width, Height, SamplesPerPixel,
+		Stats.RenderSeconds, Stats.Rays / std::max(Stats.RenderSeconds, 1e-9) * 1e-6);
+	return Tracer.SaveImage(Output);
+}
+
+/**
+ * Render a turntable of the Cornell box, one image per frame in OutputFolder: the tall box turns and the short box
+ * is squashed and stretched. Moving the tall box turns it into a dynamic instance, so each frame only refits the small
+ * dynamic top level BVH and the walls are never rebuilt. The short box keeps its topology, its BLAS is refit in a job
+ * while the previous frame's BLAS is still in use.
+ *	MechEngineExamples --cpu-turntable Turntable 24
+ */
+inline bool RenderCornellBoxTurntableOffline(const Path& OutputFolder, int NumFrames = 24, int Width = 256, int Height = 256, int SamplesPerPixel = 16)
+{
+	WorldSnapshot Snapshot = CornellBoxSnapshot();
+	FCpuCamera	  Camera;
+	CpuScene	  Scene = CpuScene::FromSnapshot(Snapshot, &Camera);
+
+	// Instances are created in the order of the static mesh actors
+	int					  TallBox = -1, ShortBox = -1, InstanceIndex = 0;
+	const FSnapshotActor* TallBoxActor = nullptr;
+	const FSnapshotActor* ShortBoxActor = nullptr;
+	for (const auto& Actor : Snapshot.GetActors())
+	{
+		if (Actor.Type != ESnapshotActorType::StaticMesh)
+			continue;
+		if (Actor.Name == "TallBox")
+		{
+			TallBox = InstanceIndex;
+			TallBoxActor = &Actor;
+		}
+		else if (Actor.Name == "ShotBox")
+		{
+			ShortBox = InstanceIndex;
+			ShortBoxActor = &Actor;
+		}
+		InstanceIndex++;
+	}
+	if (!TallBoxActor || !ShortBoxActor)
+	{
+		LOG_ERROR("The Cornell box has no TallBox or ShotBox actor");
+		return false;
+	}
+
+	const FMeshBuffers& ShortBoxSource = Snapshot.GetMeshBuffers(ShortBoxActor->MeshIndex);
+	double				Bottom = std::numeric_limits<double>::max();
+	for (const FVector& Vertex : ShortBoxSource.Vertices)
+		Bottom = std::min(Bottom, Vertex.z());
+
+	Path::CreateDirectory(OutputFolder);
+	for (int Frame = 0; Frame < NumFrames; Frame++)
+	{
+		double	Phase = 2. * M_PI * Frame / NumFrames;
+		FVector Rotation = TallBoxActor->Rotation + FVector{ 0, 0, Phase };
+		Scene.SetInstanceTransform(TallBox, (Translation3d(TallBoxActor->Translation) * MMath::QuaternionFromEulerXYZ(Rotation) * Scaling(TallBoxActor->Scale)).cast<float>());
+
+		// Scaled in height over its bottom face, so it stays on the floor
+		FMeshBuffers Squashed = ShortBoxSource;
+		for (FVector& Vertex : Squashed.Vertices)
+			Vertex.z() = Bottom + (Vertex.z() - Bottom) * (1. + 0.3 * std::sin(Phase));
+		Scene.UpdateMesh(Scene.GetInstance(ShortBox).Mesh, std::move(Squashed));
+		Scene.Update();
+
+		CpuPathTracer Tracer(Scene, Camera, Width, Height);
+		Tracer.RenderSamples(SamplesPerPixel);
+		String FileName = "Frame" + std::to_string(Frame) + ".ppm";
+		if (!Tracer.SaveImage(OutputFolder / FileName))
+			return false;
+	}
+	const auto& Stats = Scene.GetBuildStats();
+	LOG_INFO("Turntable: {} BLAS refits, {} TLAS builds, {} TLAS refits, {:.3f}ms in BLAS and {:.3f}ms in TLAS updates", Stats.NumBlasRefits,
+		Stats.NumTlasBuilds, Stats.NumTlasRefits, Stats.BlasSeconds * 1e3, Stats.TlasSeconds * 1e3);
+	return true;
+}
@@ -0,0 +1,578 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include "CoreMinimal.h"
+#include "CpuBVH.h"
+#include "JobSystem.h"
+#include "MaterialLibrary.h"
+#include "MeshBuffers.h"
+#include "WorldSnapshot.h"
+#include "Math/Math.h"
+
+/**
+ * Triangle mesh of the CPU renderer with its bottom level BVH, in object space.
+ */
+class CpuMesh
+{
+public:
+	// Refits in a row before the BVH is rebuilt anyway, the tree quality degrades with each refit
+	static constexpr int MaxRefits = 32;
+
+	explicit CpuMesh(const FMeshBuffers& Mesh)
+	{
+		SetGeometry(Mesh);
+	}
+
+	/**
+	 * Replace the geometry. When only the vertices moved (e.g. OffsetVertex) the BVH is refit,
+	 * when the topology changed it is rebuilt.
+	 * @return true if the BVH was rebuilt
+	 */
+	bool SetGeometry(const FMeshBuffers& Mesh)
+	{
+		bool SameTopology = !BVH.IsEmpty() && Mesh.NumVertices() == static_cast<int>(Positions.size()) && Mesh.Triangles == Triangles;
+		Positions.resize(Mesh.Vertices.size());
+		for (int i = 0; i < Mesh.NumVertices(); i++)
+			Positions[i] = Mesh.Vertices[i].cast<float>();
+		if (SameTopology && NumRefits < MaxRefits)
+		{
+			BVH.Refit(TriangleBounds());
+			NumRefits++;
+			return false;
+		}
+		Triangles = Mesh.Triangles;
+		BVH.Build(TriangleBounds());
+		NumRefits = 0;
+		return true;
+	}
+
+	[[nodiscard]] const CpuBVH& GetBVH() const { return BVH; }
+	[[nodiscard]] AlignedBox3f GetBounds() const { return BVH.GetBounds(); }
+	[[nodiscard]] int NumTriangles() const { return static_cast<int>(Triangles.size()); }
+
+	[[nodiscard]] Vector3f GeometricNormal(int Triangle) const
+	{
+		const auto& Indices = Triangles[Triangle];
+		return (Positions[Indices[1]] - Positions[Indices[0]]).cross(Positions[Indices[2]] - Positions[Indices[0]]);
+	}
+
+	// Möller-Trumbore, shrink Ray.TMax and return true on a hit nearer than Ray.TMax
+	bool IntersectTriangle(int Triangle, const Vector3f& Origin, const Vector3f& Direction, float TMin, float& TMax, float& OutU, float& OutV) const
+	{
+		const auto&	   Indices = Triangles[Triangle];
+		const Vector3f V0 = Positions[Indices[0]];
+		const Vector3f Edge1 = Positions[Indices[1]] - V0;
+		const Vector3f Edge2 = Positions[Indices[2]] - V0;
+		const Vector3f P = Direction.cross(Edge2);
+		const float	   Determinant = Edge1.dot(P);
+		if (std::abs(Determinant) < 1e-12f)
+			return false;
+		const float	   InvDeterminant = 1.f / Determinant;
+		const Vector3f S = Origin - V0;
+		const float	   U = S.dot(P) * InvDeterminant;
+		if (U < 0.f || U > 1.f)
+			return false;
+		const Vector3f Q = S.cross(Edge1);
+		const float	   V = Direction.dot(Q) * InvDeterminant;
+		if (V < 0.f || U + V > 1.f)
+			return false;
+		const float T = Edge2.dot(Q) * InvDeterminant;
+		if (T < TMin || T >= TMax)
+			return false;
+		TMax = T;
+		OutU = U;
+		OutV = V;
+		return true;
+	}
+
+protected:
+	TArray<Vector3f> Positions;
+	TArray<Vector3i> Triangles;
+	CpuBVH			 BVH;
+	int				 NumRefits = 0;
+
+	[[nodiscard]] TArray<AlignedBox3f> TriangleBounds() const
+	{
+		TArray<AlignedBox3f> Bounds(Triangles.size());
+		for (int i = 0; i < NumTriangles(); i++)
+		{
+			Bounds[i].extend(Positions[Triangles[i][0]]);
+			Bounds[i].extend(Positions[Triangles[i][1]]);
+			Bounds[i].extend(Positions[Triangles[i][2]]);
+		}
+		return Bounds;
+	}
+};
+
+struct FCpuMaterial
+{
+	Vector3f BaseColor = Vector3f::Constant(0.8f);
+	float	 Alpha = 1.f;
+};
+
+struct FCpuInstance
+{
+	int		 Mesh = -1;
+	int		 Material = -1;
+	bool	 Dynamic = false; // Moved since the scene was built, lives in the dynamic top level BVH
+	Affine3f ObjectToWorld = Affine3f::Identity();
+	Affine3f WorldToObject = Affine3f::Identity();
+	Matrix3f NormalToWorld = Matrix3f::Identity();
+
+	void SetTransform(const Affine3f& Transform)
+	{
+		ObjectToWorld = Transform;
+		WorldToObject = Transform.inverse();
+		NormalToWorld = Transform.linear().inverse().transpose();
+	}
+};
+
+// One sided rectangular emitter, facing Normal
+struct FCpuAreaLight
+{
+	Vector3f Center = Vector3f::Zero();
+	Vector3f EdgeU = Vector3f::UnitX();
+	Vector3f EdgeV = Vector3f::UnitY();
+	Vector3f Normal = -Vector3f::UnitZ();
+	Vector3f Radiance = Vector3f::Ones();
+
+	[[nodiscard]] float Area() const { return EdgeU.cross(EdgeV).norm(); }
+
+	// Distance to the light along the ray, infinity if missed or hit from behind
+	[[nodiscard]] float Intersect(const FCpuRay& Ray) const
+	{
+		float Facing = Ray.Direction.dot(Normal);
+		if (Facing >= 0.f)
+			return std::numeric_limits<float>::infinity();
+		float T = (Center - Ray.Origin).dot(Normal) / Facing;
+		if (T < Ray.TMin || T >= Ray.TMax)
+			return std::numeric_limits<float>::infinity();
+		Vector3f Local = Ray.Origin + Ray.Direction * T - Center;
+		if (std::abs(Local.dot(EdgeU)) > 0.5f * EdgeU.squaredNorm() || std::abs(Local.dot(EdgeV)) > 0.5f * EdgeV.squaredNorm())
+			return std::numeric_limits<float>::infinity();
+		return T;
+	}
+};
+
+struct FCpuCamera
+{
+	Vector3f Position = Vector3f::Zero();
+	Vector3f Forward = Vector3f::UnitX();
+	Vector3f Right = -Vector3f::UnitY();
+	Vector3f Up = Vector3f::UnitZ();
+	float	 FovH = 45.f; // Horizontal field of view in degrees, as CameraComponent::SetFovH
+
+	// Z is up in the engine
+	static FCpuCamera LookAt(const Vector3f& Position, const Vector3f& Target, float FovH)
+	{
+		FCpuCamera Camera;
+		Camera.Position = Position;
+		Camera.Forward = (Target - Position).normalized();
+		Camera.Right = Camera.Forward.cross(Vector3f::UnitZ()).normalized();
+		Camera.Up = Camera.Right.cross(Camera.Forward);
+		Camera.FovH = FovH;
+		return Camera;
+	}
+
+	// Ray through the image point (X, Y) in [0, 1]^2, Y pointing down
+	[[nodiscard]] FCpuRay GenerateRay(float X, float Y, float Aspect) const
+	{
+		float	TanHalf = std::tan(DegToRad(FovH) * 0.5f);
+		FCpuRay Ray;
+		Ray.Origin = Position;
+		Ray.Direction = (Forward + (2.f * X - 1.f) * TanHalf * Right + (1.f - 2.f * Y) * TanHalf / Aspect * Up).normalized();
+		return Ray;
+	}
+};
+
+/**
+ * Scene of the CPU renderer: meshes with their bottom level BVHs, instances under a top level BVH, and area lights.
+ * Built from a WorldSnapshot, so the same scene description renders on the GPU through the World and offline here.
+ */
+class CpuScene
+{
+public:
+	// Area light intensities are in the engine units, scaled to radiance so the Cornell box matches the classic (17, 12, 4)
+	static constexpr float LightIntensityScale = 0.1f;
+
+	// Acceleration structure work, accumulated over the lifetime of the scene. Asynchronous mesh updates count their job time
+	struct FBuildStats
+	{
+		double BlasSeconds = 0.;
+		double TlasSeconds = 0.;
+		int	   NumBlasBuilds = 0;
+		int	   NumBlasRefits = 0;
+		int	   NumTlasBuilds = 0;
+		int	   NumTlasRefits = 0;
+	};
+
+	int AddMesh(const FMeshBuffers& Mesh)
+	{
+		auto StartTime = std::chrono::steady_clock::now();
+		Meshes.push_back(std::make_unique<CpuMesh>(Mesh));
+		BuildStats.BlasSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+		BuildStats.NumBlasBuilds++;
+		return static_cast<int>(Meshes.size()) - 1;
+	}
+
+	int AddMaterial(const FCpuMaterial& Material)
+	{
+		Materials.push_back(Material);
+		return static_cast<int>(Materials.size()) - 1;
+	}
+
+	int AddInstance(int Mesh, int Material, const Affine3f& ObjectToWorld)
+	{
+		auto& Instance = Instances.emplace_back();
+		Instance.Mesh = Mesh;
+		Instance.Material = Material;
+		Instance.SetTransform(ObjectToWorld);
+		return static_cast<int>(Instances.size()) - 1;
+	}
+
+	void AddAreaLight(const FCpuAreaLight& Light) { AreaLights.push_back(Light); }
+
+	// Build the top level BVHs from scratch, call after adding instances
+	void Build()
+	{
+		PROFILE_SCOPE("CpuScene::Build");
+		TopLevels[0].Instances.clear();
+		TopLevels[1].Instances.clear();
+		for (int i = 0; i < NumInstances(); i++)
+			TopLevels[Instances[i].Dynamic ? 1 : 0].Instances.push_back(i);
+		for (auto& TopLevel : TopLevels)
+			BuildTopLevel(TopLevel, false);
+	}
+
+	/**
+	 * Move an instance, applied by the next Update. Instances start static, the first move turns them dynamic:
+	 * dynamic instances get their own top level BVH, which is refit when they move, so the static one is left alone.
+	 */
+	void SetInstanceTransform(int Index, const Affine3f& ObjectToWorld)
+	{
+		FCpuInstance& Instance = Instances[Index];
+		Instance.SetTransform(ObjectToWorld);
+		if (!Instance.Dynamic)
+		{
+			Instance.Dynamic = true;
+			InstancesMoved = true;
+		}
+		TopLevels[1].BoundsDirty = true;
+	}
+
+	/**
+	 * Replace the geometry of a mesh. The new BLAS is refit (same topology) or rebuilt (new topology) by a job
+	 * on a copy of the mesh, while the current one keeps answering queries. Update swaps it in.
+	 * Meshes are never modified in place, only replaced, so the job copies the current one without a lock.
+	 */
+	void UpdateMesh(int Mesh, FMeshBuffers Geometry, JobSystem& Jobs = JobSystem::Get())
+	{
+		auto Pending = std::make_shared<FPendingMesh>();
+		Pending->Mesh = Mesh;
+		PendingMeshes.push_back(Pending);
+		Jobs.Submit([Pending, Source = Meshes[Mesh], Geometry = std::move(Geometry)] {
+			PROFILE_SCOPE("CpuScene::UpdateMesh");
+			auto StartTime = std::chrono::steady_clock::now();
+			Pending->Result = std::make_unique<CpuMesh>(*Source);
+			Pending->Rebuilt = Pending->Result->SetGeometry(Geometry);
+			Pending->Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+			Pending->Remaining.store(0, std::memory_order_release);
+		});
+	}
+
+	/**
+	 * Apply the pending changes, once per frame while no queries are running: swap in the updated meshes,
+	 * then refit the top level BVHs whose instances moved, or rebuild them when instances changed level.
+	 */
+	void Update(JobSystem& Jobs = JobSystem::Get())
+	{
+		PROFILE_SCOPE("CpuScene::Update");
+		for (const auto& Pending : PendingMeshes)
+		{
+			Jobs.WaitFor(Pending->Remaining);
+			Meshes[Pending->Mesh] = std::move(Pending->Result);
+			BuildStats.BlasSeconds += Pending->Seconds;
+			(Pending->Rebuilt ? BuildStats.NumBlasBuilds : BuildStats.NumBlasRefits)++;
+			for (const auto& Instance : Instances)
+				if (Instance.Mesh == Pending->Mesh)
+					TopLevels[Instance.Dynamic ? 1 : 0].BoundsDirty = true;
+		}
+		PendingMeshes.clear();
+
+		if (InstancesMoved)
+		{
+			Build();
+			InstancesMoved = false;
+			return;
+		}
+		for (auto& TopLevel : TopLevels)
+			if (TopLevel.BoundsDirty)
+				BuildTopLevel(TopLevel, TopLevel.NumRefits < CpuMesh::MaxRefits);
+	}
+
+	[[nodiscard]] bool HasPendingUpdates() const { return !PendingMeshes.empty() || InstancesMoved || TopLevels[0].BoundsDirty || TopLevels[1].BoundsDirty; }
+
+	[[nodiscard]] const FBuildStats& GetBuildStats() const { return BuildStats; }
+
+	[[nodiscard]] const FCpuInstance& GetInstance(int Index) const { return Instances[Index]; }
+	[[nodiscard]] const FCpuMaterial& GetMaterial(int Index) const { return Materials[Index]; }
+	[[nodiscard]] const CpuMesh& GetMesh(int Index) const { return *Meshes[Index]; }
+	[[nodiscard]] const TArray<FCpuAreaLight>& GetAreaLights() const { return AreaLights; }
+	[[nodiscard]] int NumInstances() const { return static_cast<int>(Instances.size()); }
+	[[nodiscard]] int NumTriangles() const
+	{
+		int Result = 0;
+		for (const auto& Instance : Instances)
+			Result += Meshes[Instance.Mesh]->NumTriangles();
+		return Result;
+	}
+
+	// Closest hit, Ray.TMax is shrunk to the hit distance
+	bool Intersect(FCpuRay& Ray, FCpuHit& Hit) const
+	{
+		bool Found = false;
+		for (const auto& TopLevel : TopLevels)
+		{
+			Found |= TopLevel.BVH.Traverse(Ray, [&](int Primitive, FCpuRay& WorldRay) {
+				return IntersectInstance(TopLevel.Instances[Primitive], WorldRay, Hit, false);
+			});
+		}
+		return Found;
+	}
+
+	// Any hit between Ray.TMin and Ray.TMax
+	[[nodiscard]] bool Occluded(FCpuRay Ray) const
+	{
+		FCpuHit Hit;
+		for (const auto& TopLevel : TopLevels)
+		{
+			bool Found = TopLevel.BVH.Traverse(Ray, [&](int Primitive, FCpuRay& WorldRay) {
+				return IntersectInstance(TopLevel.Instances[Primitive], WorldRay, Hit, true);
+			}, true);
+			if (Found)
+				return true;
+		}
+		return false;
+	}
+
+	// Call OnHit(Hit) for every surface between Ray.TMin and Ray.TMax, in no particular order
+	template <class OnHitT>
+	void ForEachHit(FCpuRay Ray, OnHitT&& OnHit) const
+	{
+		for (const auto& TopLevel : TopLevels)
+		{
+			TopLevel.BVH.Traverse(Ray, [&](int Primitive, FCpuRay& WorldRay) {
+				const int			InstanceIndex = TopLevel.Instances[Primitive];
+				const FCpuInstance& Instance = Instances[InstanceIndex];
+				const CpuMesh&		Mesh = *Meshes[Instance.Mesh];
+				FCpuRay				LocalRay{ Instance.WorldToObject * WorldRay.Origin, Instance.WorldToObject.linear() * WorldRay.Direction, WorldRay.TMin, WorldRay.TMax };
+				Mesh.GetBVH().Traverse(LocalRay, [&](int Triangle, FCpuRay& Local) {
+					FCpuHit Hit;
+					Hit.T = Local.TMax;
+					if (Mesh.IntersectTriangle(Triangle, Local.Origin, Local.Direction, Local.TMin, Hit.T, Hit.U, Hit.V))
+					{
+						Hit.Instance = InstanceIndex;
+						Hit.Triangle = Triangle;
+						OnHit(Hit);
+					}
+					// Never shrink the ray, every hit is wanted
+					return false;
+				});
+				return false;
+			});
+		}
+	}
+
+	// Closest hits of a packet of coherent rays, e.g. the camera rays of a pixel block
+	template <int PacketSize>
+	void IntersectPacket(std::array<FCpuRay, PacketSize>& Rays, std::array<FCpuHit, PacketSize>& Hits) const
+	{
+		TCpuRayPacket<PacketSize> WorldPacket;
+		for (int Lane = 0; Lane < PacketSize; Lane++)
+			WorldPacket.Set(Lane, Rays[Lane]);
+
+		for (const auto& TopLevel : TopLevels)
+		{
+			TopLevel.BVH.TraversePacket(WorldPacket, [&](int Primitive, uint32_t LaneMask, TCpuRayPacket<PacketSize>& Packet) {
+				const int			InstanceIndex = TopLevel.Instances[Primitive];
+				const FCpuInstance& Instance = Instances[InstanceIndex];
+				const CpuMesh&		Mesh = *Meshes[Instance.Mesh];
+
+				// The object space rays keep their parametrization, so distances are shared with the world packet
+				std::array<Vector3f, PacketSize> Origins, Directions;
+				TCpuRayPacket<PacketSize>		 LocalPacket;
+				for (int Lane = 0; Lane < PacketSize; Lane++)
+				{
+					Origins[Lane] = Instance.WorldToObject * Rays[Lane].Origin;
+					Directions[Lane] = Instance.WorldToObject.linear() * Rays[Lane].Direction;
+					LocalPacket.Set(Lane, { Origins[Lane], Directions[Lane], Packet.TMin[Lane], Packet.TMax[Lane] });
+					if (!(LaneMask >> Lane & 1))
+						LocalPacket.TMax[Lane] = -1.f;
+				}
+
+				Mesh.GetBVH().TraversePacket(LocalPacket, [&](int Triangle, uint32_t TriangleLanes, TCpuRayPacket<PacketSize>& Local) {
+					for (int Lane = 0; Lane < PacketSize; Lane++)
+					{
+						if (TriangleLanes >> Lane & 1
+							&& Mesh.IntersectTriangle(Triangle, Origins[Lane], Directions[Lane], Local.TMin[Lane], Local.TMax[Lane], Hits[Lane].U, Hits[Lane].V))
+						{
+							Hits[Lane].T = Local.TMax[Lane];
+							Hits[Lane].Instance = InstanceIndex;
+							Hits[Lane].Triangle = Triangle;
+							Packet.TMax[Lane] = Local.TMax[Lane];
+						}
+					}
+				});
+			});
+		}
+		for (int Lane = 0; Lane < PacketSize; Lane++)
+			Rays[Lane].TMax = WorldPacket.TMax[Lane];
+	}
+
+	// World space geometric normal at a hit, not normalized
+	[[nodiscard]] Vector3f HitNormal(const FCpuHit& Hit) const
+	{
+		const FCpuInstance& Instance = Instances[Hit.Instance];
+		return Instance.NormalToWorld * Meshes[Instance.Mesh]->GeometricNormal(Hit.Triangle);
+	}
+
+	/**
+	 * Convert the static meshes and area lights of a snapshot, and the first camera into OutCamera.
+	 * Point lights are skipped, the snapshot does not carry their intensity.
+	 */
+	static CpuScene FromSnapshot(const WorldSnapshot& Snapshot, FCpuCamera* OutCamera = nullptr)
+	{
+		CpuScene		Scene;
+		TArray<int>		MeshIndices(Snapshot.NumMeshes(), -1);
+		bool			HasCamera = false;
+		// Actors with equal material parameters share one material, as when spawned. Scene material of each library entry
+		MaterialLibrary Materials;
+		TArray<int>		MaterialIndices;
+		for (const auto& Actor : Snapshot.GetActors())
+		{
+			Affine3f Transform = (Translation3d(Actor.Translation) * MMath::QuaternionFromEulerXYZ(Actor.Rotation) * Scaling(Actor.Scale)).cast<float>();
+			switch (Actor.Type)
+			{
+				case ESnapshotActorType::StaticMesh:
+				{
+					int& Mesh = MeshIndices[Actor.MeshIndex];
+					if (Mesh < 0)
+						Mesh = Scene.AddMesh(Snapshot.GetMeshBuffers(Actor.MeshIndex));
+					FMaterialParameters Parameters = Actor.GetMaterialParameters();
+					int					Material = Materials.IndexOf(Parameters);
+					if (Material == static_cast<int>(MaterialIndices.size()))
+					{
+						FCpuMaterial CpuMaterial;
+						if (Parameters.BaseColor)
+							CpuMaterial.BaseColor = Parameters.BaseColor->cast<float>();
+						CpuMaterial.Alpha = static_cast<float>(Parameters.Alpha.value_or(1.));
+						MaterialIndices.push_back(Scene.AddMaterial(CpuMaterial));
+					}
+					Scene.AddInstance(Mesh, MaterialIndices[Material], Transform);
+					break;
+				}
+				case ESnapshotActorType::AreaLight:
+				{
+					FCpuAreaLight Light;
+					Light.Center = Transform.translation();
+					Light.EdgeU = Transform.linear() * Vector3f(static_cast<float>(Actor.LightSize.x()), 0.f, 0.f);
+					Light.EdgeV = Transform.linear() * Vector3f(0.f, static_cast<float>(Actor.LightSize.y()), 0.f);
+					Light.Normal = (Transform.linear() * -Vector3f::UnitZ()).normalized();
+					Light.Radiance = Actor.Intensity.cast<float>() * LightIntensityScale;
+					Scene.AddAreaLight(Light);
+					break;
+				}
+				case ESnapshotActorType::Camera:
+					if (OutCamera && !HasCamera)
+					{
+						*OutCamera = FCpuCamera::LookAt(Actor.Translation.cast<float>(), Actor.LookAtTarget.cast<float>(),
+							Actor.FovH > 0. ? static_cast<float>(Actor.FovH) : 45.f);
+						HasCamera = true;
+					}
+					break;
+				case ESnapshotActorType::PointLight:
+					break;
+			}
+		}
+		Scene.Build();
+		return Scene;
+	}
+
+protected:
+	TArray<std::shared_ptr<const CpuMesh>> Meshes;
+	TArray<FCpuMaterial>				   Materials;
+	TArray<FCpuInstance>				   Instances;
+	TArray<FCpuAreaLight>				   AreaLights;
+	FBuildStats							   BuildStats;
+
+	// Top level BVH over a subset of the instances
+	struct FTopLevel
+	{
+		CpuBVH		BVH;
+		TArray<int> Instances;
+		bool		BoundsDirty = false;
+		int			NumRefits = 0;
+	};
+	// Static instances, then the dynamic ones
+	std::array<FTopLevel, 2> TopLevels;
+	bool					 InstancesMoved = false;
+
+	struct FPendingMesh
+	{
+		int						 Mesh = -1;
+		std::unique_ptr<CpuMesh> Result;
+		bool					 Rebuilt = false;
+		double					 Seconds = 0.;
+		std::atomic<int>		 Remaining = 1;
+	};
+	TArray<std::shared_ptr<FPendingMesh>> PendingMeshes;
+
+	void BuildTopLevel(FTopLevel& TopLevel, bool Refit)
+	{
+		auto				 StartTime = std::chrono::steady_clock::now();
+		TArray<AlignedBox3f> Bounds(TopLevel.Instances.size());
+		for (int i = 0; i < static_cast<int>(Bounds.size()); i++)
+		{
+			const FCpuInstance& Instance = Instances[TopLevel.Instances[i]];
+			AlignedBox3f		Local = Meshes[Instance.Mesh]->GetBounds();
+			if (Local.isEmpty())
+				continue;
+			for (int Corner = 0; Corner < 8; Corner++)
+				Bounds[i].extend(Instance.ObjectToWorld * Local.corner(static_cast<AlignedBox3f::CornerType>(Corner)));
+		}
+		if (Refit)
+		{
+			TopLevel.BVH.Refit(Bounds);
+			TopLevel.NumRefits++;
+			BuildStats.NumTlasRefits++;
+		}
+		else
+		{
+			TopLevel.BVH.Build(Bounds);
+			TopLevel.NumRefits = 0;
+			BuildStats.NumTlasBuilds++;
+		}
+		TopLevel.BoundsDirty = false;
+		BuildStats.TlasSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+	}
+
+	bool IntersectInstance(int InstanceIndex, FCpuRay& WorldRay, FCpuHit& Hit, bool AnyHit) const
+	{
+		const FCpuInstance& Instance = Instances[InstanceIndex];
+		const CpuMesh&		Mesh = *Meshes[Instance.Mesh];
+		FCpuRay				LocalRay{ Instance.WorldToObject * WorldRay.Origin, Instance.WorldToObject.linear() * WorldRay.Direction, WorldRay.TMin, WorldRay.TMax };
+		bool				Found = Mesh.GetBVH().Traverse(LocalRay, [&](int Triangle, FCpuRay& Ray) {
+			if (!Mesh.IntersectTriangle(Triangle, Ray.Origin, Ray.Direction, Ray.TMin, Ray.TMax, Hit.U, Hit.V))
+				return false;
+			Hit.T = Ray.TMax;
+			Hit.Instance = InstanceIndex;
+			Hit.Triangle = Triangle;
+			return true;
+		}, AnyHit);
+		WorldRay.TMax = LocalRay.TMax;
+		return Found;
+	}
+};
@@ -0,0 +1,238 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include "CoreMinimal.h"
+#include "CpuScene.h"
+#include "FrameArena.h"
+#include "JobSystem.h"
+
+enum class ETransparencyMode
+{
+	// Blend whole meshes back to front, sorted by the distance of their bounds. Wrong where meshes intersect or interleave
+	SortedObjects,
+	// Weighted blended order independent transparency (McGuire and Bavoil 2013): no sorting, approximate
+	WeightedBlended,
+	// Sort every fragment of the pixel by depth, as a per-pixel linked list would. Exact, used as the reference
+	PerPixelSorted,
+};
+
+inline const char* TransparencyModeName(ETransparencyMode Mode)
+{
+	switch (Mode)
+	{
+		case ETransparencyMode::SortedObjects: return "SortedObjects";
+		case ETransparencyMode::WeightedBlended: return "WeightedBlended";
+		case ETransparencyMode::PerPixelSorted: return "PerPixelSorted";
+	}
+	return "Unknown";
+}
+
+/**
+ * Preview renderer for scenes with alpha blended materials, e.g. SetAlpha(0.5) meshes layered over other geometry.
+ * Each pixel gathers every fragment along its camera ray, as a rasterizer would, shades it with a headlight
+ * and composes the fragments with one of the transparency modes. Materials with Alpha >= 1 are opaque.
+ * Render does both per pixel. GatherFrame and ComposeFrame split them into two passes over a stored frame,
+ * so the modes can be timed without the ray casting, which costs far more than any of them.
+ */
+class CpuTransparencyRenderer
+{
+public:
+	struct FStats
+	{
+		int64_t Fragments = 0; // Visible transparent fragments, in front of the opaque surface
+		double	Seconds = 0.;		 // Of the last Render
+		double	GatherSeconds = 0.;	 // Of the last GatherFrame
+		double	ComposeSeconds = 0.; // Of the last ComposeFrame
+	};
+
+	Vector3f Background = Vector3f::Constant(0.8f);
+
+	CpuTransparencyRenderer(const CpuScene& InScene, const FCpuCamera& InCamera, int InWidth, int InHeight)
+		: Scene(InScene), Camera(InCamera), Width(InWidth), Height(InHeight) {}
+
+	[[nodiscard]] const FStats& GetStats() const { return Stats; }
+
+	// Render one image, row major from the top left in linear color
+	TArray<Vector3f> Render(ETransparencyMode Mode, JobSystem& Jobs = JobSystem::Get())
+	{
+		auto StartTime = std::chrono::steady_clock::now();
+		if (Mode == ETransparencyMode::SortedObjects)
+			SortObjects();
+
+		TArray<Vector3f>	 Image(static_cast<size_t>(Width) * Height);
+		std::atomic<int64_t> Fragments = 0;
+		float				 Aspect = static_cast<float>(Width) / Height;
+		Jobs.ParallelFor(Height, [&](int Y) {
+			// Fragment lists come from the worker's arena and are released with the row
+			FArenaScope			   ArenaScope;
+			TArenaArray<FFragment> PixelFragments;
+			int64_t				   RowFragments = 0;
+			for (int X = 0; X < Width; X++)
+			{
+				FCpuRay	 Ray = Camera.GenerateRay((X + 0.5f) / Width, (Y + 0.5f) / Height, Aspect);
+				Vector3f Opaque = GatherFragments(Ray, PixelFragments);
+				RowFragments += static_cast<int64_t>(PixelFragments.size());
+				Image[static_cast<size_t>(Y) * Width + X] = Compose(Mode, PixelFragments, Opaque);
+			}
+			Fragments.fetch_add(RowFragments, std::memory_order_relaxed);
+		});
+		Stats.Fragments = Fragments.load();
+		Stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+		return Image;
+	}
+
+	// Gather and keep the fragments of every pixel, for ComposeFrame
+	void GatherFrame(JobSystem& Jobs = JobSystem::Get())
+	{
+		auto StartTime = std::chrono::steady_clock::now();
+		Rows.resize(Height);
+		std::atomic<int64_t> Fragments = 0;
+		float				 Aspect = static_cast<float>(Width) / Height;
+		Jobs.ParallelFor(Height, [&](int Y) {
+			FArenaScope			   ArenaScope;
+			TArenaArray<FFragment> PixelFragments;
+			FFragmentRow&		   Row = Rows[Y];
+			Row.Fragments.clear();
+			Row.Offsets.assign(1, 0);
+			Row.Opaque.resize(Width);
+			for (int X = 0; X < Width; X++)
+			{
+				FCpuRay Ray = Camera.GenerateRay((X + 0.5f) / Width, (Y + 0.5f) / Height, Aspect);
+				Row.Opaque[X] = GatherFragments(Ray, PixelFragments);
+				Row.Fragments.insert(Row.Fragments.end(), PixelFragments.begin(), PixelFragments.end());
+				Row.Offsets.push_back(static_cast<int>(Row.Fragments.size()));
+			}
+			Fragments.fetch_add(static_cast<int64_t>(Row.Fragments.size()), std::memory_order_relaxed);
+		});
+		Stats.Fragments = Fragments.load();
+		Stats.GatherSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+	}
+
+	// Compose the frame stored by GatherFrame, same image as Render. The stored fragments are left untouched,
+	// each pixel sorts a copy, so every mode starts from the gather order
+	TArray<Vector3f> ComposeFrame(ETransparencyMode Mode, JobSystem& Jobs = JobSystem::Get())
+	{
+		ASSERT(static_cast<int>(Rows.size()) == Height);
+		auto StartTime = std::chrono::steady_clock::now();
+		if (Mode == ETransparencyMode::SortedObjects)
+			SortObjects();
+
+		TArray<Vector3f> Image(static_cast<size_t>(Width) * Height);
+		Jobs.ParallelFor(Height, [&](int Y) {
+			FArenaScope			   ArenaScope;
+			TArenaArray<FFragment> PixelFragments;
+			const FFragmentRow&	   Row = Rows[Y];
+			for (int X = 0; X < Width; X++)
+			{
+				PixelFragments.assign(Row.Fragments.begin() + Row.Offsets[X], Row.Fragments.begin() + Row.Offsets[X + 1]);
+				Image[static_cast<size_t>(Y) * Width + X] = Compose(Mode, PixelFragments, Row.Opaque[X]);
+			}
+		});
+		Stats.ComposeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+		return Image;
+	}
+
+protected:
+	struct FFragment
+	{
+		float	 Depth;
+		int		 Instance;
+		int		 Triangle;
+		Vector3f Color;
+		float	 Alpha;
+	};
+
+	const CpuScene& Scene;
+	FCpuCamera		Camera;
+	int				Width, Height;
+	FStats			Stats;
+	// Back to front rank of each instance for SortedObjects
+	TArray<int> ObjectRanks;
+
+	// Fragments of one image row stored by GatherFrame, those of pixel X are [Offsets[X], Offsets[X + 1])
+	struct FFragmentRow
+	{
+		TArray<FFragment> Fragments;
+		TArray<int>		  Offsets;
+		TArray<Vector3f>  Opaque;
+	};
+	TArray<FFragmentRow> Rows;
+
+	void SortObjects()
+	{
+		TArray<std::pair<float, int>> Distances(Scene.NumInstances());
+		for (int i = 0; i < Scene.NumInstances(); i++)
+		{
+			const FCpuInstance& Instance = Scene.GetInstance(i);
+			Vector3f			Center = Instance.ObjectToWorld * Scene.GetMesh(Instance.Mesh).GetBounds().center();
+			Distances[i] = { -(Center - Camera.Position).squaredNorm(), i };
+		}
+		std::sort(Distances.begin(), Distances.end());
+		ObjectRanks.resize(Distances.size());
+		for (int Rank = 0; Rank < static_cast<int>(Distances.size()); Rank++)
+			ObjectRanks[Distances[Rank].second] = Rank;
+	}
+
+	// Collect the transparent fragments in front of the nearest opaque surface, return the color behind them
+	Vector3f GatherFragments(const FCpuRay& Ray, TArenaArray<FFragment>& OutFragments) const
+	{
+		OutFragments.clear();
+		FCpuHit NearestOpaque;
+		Scene.ForEachHit(Ray, [&](const FCpuHit& Hit) {
+			const FCpuMaterial& Material = Scene.GetMaterial(Scene.GetInstance(Hit.Instance).Material);
+			if (Material.Alpha >= 1.f)
+			{
+				if (Hit.T < NearestOpaque.T)
+					NearestOpaque = Hit;
+				return;
+			}
+			OutFragments.push_back({ Hit.T, Hit.Instance, Hit.Triangle, ShadeHit(Ray, Hit), Material.Alpha });
+		});
+		std::erase_if(OutFragments, [&](const FFragment& Fragment) { return Fragment.Depth >= NearestOpaque.T; });
+		return NearestOpaque.IsValid() ? ShadeHit(Ray, NearestOpaque) : Background;
+	}
+
+	// Base color lit by a headlight, enough to read the shapes in a preview
+	Vector3f ShadeHit(const FCpuRay& Ray, const FCpuHit& Hit) const
+	{
+		float CosTheta = std::abs(Scene.HitNormal(Hit).normalized().dot(Ray.Direction));
+		return Scene.GetMaterial(Scene.GetInstance(Hit.Instance).Material).BaseColor * (0.25f + 0.75f * CosTheta);
+	}
+
+	Vector3f Compose(ETransparencyMode Mode, TArenaArray<FFragment>& Fragments, const Vector3f& Opaque) const
+	{
+		if (Mode == ETransparencyMode::WeightedBlended)
+		{
+			// Equation 10 of the paper for the weight, with the fragment distance as depth
+			Vector3f Accumulation = Vector3f::Zero();
+			float	 AlphaAccumulation = 0.f, Revealage = 1.f;
+			for (const auto& Fragment : Fragments)
+			{
+				float Weight = Fragment.Alpha * std::clamp(10.f / (1e-5f + std::pow(Fragment.Depth / 5.f, 2.f) + std::pow(Fragment.Depth / 200.f, 6.f)), 1e-2f, 3e3f);
+				Accumulation += Fragment.Color * (Fragment.Alpha * Weight);
+				AlphaAccumulation += Fragment.Alpha * Weight;
+				Revealage *= 1.f - Fragment.Alpha;
+			}
+			if (Fragments.empty())
+				return Opaque;
+			return Accumulation / std::max(AlphaAccumulation, 1e-5f) * (1.f - Revealage) + Opaque * Revealage;
+		}
+
+		if (Mode == ETransparencyMode::SortedObjects)
+		{
+			// Object order, then triangle order inside an object as the draw calls would
+			std::sort(Fragments.begin(), Fragments.end(), [this](const FFragment& A, const FFragment& B) {
+				return ObjectRanks[A.Instance] != ObjectRanks[B.Instance] ? ObjectRanks[A.Instance] < ObjectRanks[B.Instance] : A.Triangle < B.Triangle;
+			});
+		}
+		else
+		{
+			std::sort(Fragments.begin(), Fragments.end(), [](const FFragment& A, const FFragment& B) { return A.Depth > B.Depth; });
+		}
+		Vector3f Color = Opaque;
+		for (const auto& Fragment : Fragments)
+			Color = Fragment.Color * Fragment.Alpha + Color * (1.f - Fragment.Alpha);
+		return Color;
+	}
+};
@@ -5,6 +5,7 @@
 #include "Materials/Material.h"
 #include "Render/GpuSceneInterface.h"
 #include "Render/material/disney_material.h"
+#include "ShaderCompileQueue.h"
 
 using luisa::compute::Float3;
 class my_shader : public Rendering::disney_material
@@ -31,20 +32,25 @@ inline auto CustomShaderExample()
 {
     return [](World& world)
     {
+        // Bindings are collected and compiled once at the end of the frame instead of once per binding
+        auto Shaders = std::make_shared<ShaderCompileQueue>();
+
         auto Mesh1 = world.SpawnActor<StaticMeshActor>("Mesh1", BasicShapesLibrary::GenerateCylinder(1., 0.5));
 
         auto Material = Mesh1->GetStaticMeshComponent()->GetMeshData()->GetMaterial();
-        Material->BindShader<my_shader>();
+        Shaders->BindShader<my_shader>(Material, "my_shader");
 
 
         auto Mesh2 = world.SpawnActor<StaticMeshActor>("Mesh2", BasicShapesLibrary::GenerateCapsule(1., 0.5));
         Mesh2->SetTranslation({0, 1., 0});
         auto Material2 = Mesh2->GetStaticMeshComponent()->GetMeshData()->GetMaterial();
-        Material2->BindShader<reverse_color_shader>();
+        Shaders->BindShader<reverse_color_shader>(Material2, "reverse_color_shader");
 
 
 
-        // Remember to recompile the shader after binding
-        world.GetScene()->CompileShader();
+        // Compile the initial bindings now so the first frame renders with them, later ones at the frame boundary,
+        // only when a new shader was bound
+        Shaders->Flush(world);
+        world.TickFunction = [Shaders](double DeltaTime, World& world) { Shaders->Flush(world); };
     };
 }
\ No newline at end of file
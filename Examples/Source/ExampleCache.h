@@ -0,0 +1,19 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Misc/Path.h"
+
+// Set by the build to a directory of the build tree, see Examples/CMakeLists.txt
+#ifndef EXAMPLES_CACHE_DIR
+	#define EXAMPLES_CACHE_DIR "ExampleCache"
+#endif
+
+/**
+ * Directory for the files the examples generate and reuse between runs, e.g. reference images.
+ * It lives in the build tree, generated files never go to the content directory under source control.
+ * Usage:
+ *	Path Reference = ExampleCacheDir() / "CornellBoxReference.pfm";
+ */
+inline Path ExampleCacheDir()
+{
+	return Path(EXAMPLES_CACHE_DIR);
+}
@@ -3,29 +3,77 @@
 //
 
 #pragma once
+#include "GeometryJobQueue.h"
 #include "LambdaUIWidget.h"
 #include "Game/World.h"
 #include "ImguiPlus.h"
 #include "Game/StaticMeshActor.h"
 #include "Mesh/StaticMesh.h"
+#include "MeshNormals.h"
 
 inline auto ExtrudeMeshExample()
 {
 	return [](World& world) {
 		auto Bunny = StaticMesh::LoadObj("stanford-bunny.obj");
-
 		auto OffsetNormal = world.SpawnActor<StaticMeshActor>("OffsetByNormal", Bunny);
-		world.AddWidget<LambdaUIWidget>([OffsetNormal, Bunny]() {
+
+		// The normals are computed once, and the dent only updates the ones around the moved vertices
+		auto Source = std::make_shared<FMeshBuffers>(FMeshBuffers::FromStaticMesh(*Bunny));
+		auto Normals = std::make_shared<MeshNormals>(MeshAdjacencyCache::Get().Find(Bunny, *Source), Source->Triangles);
+		Normals->Compute(Source->Vertices);
+
+		// Vertices around the top of the bunny, pushed in by the dent
+		auto Deformed = std::make_shared<FMeshBuffers>(*Source);
+		auto DentVertices = std::make_shared<TArray<int>>();
+		int	 Top = static_cast<int>(std::max_element(Source->Vertices.begin(), Source->Vertices.end(),
+			[](const FVector& A, const FVector& B) { return A.z() < B.z(); }) - Source->Vertices.begin());
+		for (int Vertex = 0; Vertex < Source->NumVertices(); Vertex++)
+			if ((Source->Vertices[Vertex] - Source->Vertices[Top]).norm() < 0.03)
+				DentVertices->push_back(Vertex);
+
+		// The offset mesh is built in the background. Jobs of a channel run one at a time, so they own Deformed and Normals
+		auto Jobs = std::make_shared<GeometryJobQueue>();
+		auto AppliedDent = std::make_shared<float>(0.f);
+		world.AddWidget<LambdaUIWidget>([=]() {
 			static float Offset = 0.;
+			static float Dent = 0.;
 			if(ImGui::Begin("Extrude Mesh Example", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
 			{
-				if(ImGui::InputFloat("Offeset by normal distance: ", &Offset, 0.01))
+				bool bChanged = ImGui::InputFloat("Offeset by normal distance: ", &Offset, 0.01);
+				bChanged |= ImGui::SliderFloat("Dent depth", &Dent, 0., 0.02);
+				if(bChanged)
 				{
-					auto OffsetMesh = NewObject<StaticMesh>(*Bunny)->OffsetVertex(Offset); // Copy the mesh and offset the vertices
-					OffsetNormal->GetStaticMeshComponent()->SetMeshData(OffsetMesh);
+					Jobs->Submit("Offset", [=, Offset = Offset, Dent = Dent](const FCancellationToken& Token) {
+						// Superseded jobs never ran, so compare with the dent last applied rather than the previous slider value
+						if (Dent != *AppliedDent)
+						{
+							for (int Vertex : *DentVertices)
+							{
+								double Falloff = 1. - (Source->Vertices[Vertex] - Source->Vertices[Top]).norm() / 0.03;
+								Deformed->Vertices[Vertex] = Source->Vertices[Vertex] - FVector::UnitZ() * (Dent * Falloff * Falloff);
+							}
+							Normals->Update(Deformed->Vertices, *DentVertices);
+							*AppliedDent = Dent;
+						}
+						// Plain buffers, the StaticMesh is created on the game thread when the result is delivered
+						FMeshBuffers OffsetMesh = *Deformed;
+						const auto&	 VertexNormals = Normals->GetVertexNormals();
+						for (int Vertex = 0; Vertex < OffsetMesh.NumVertices(); Vertex++)
+						{
+							if (Vertex % 4096 == 0 && Token.IsCancelled())
+								return FMeshBuffers();
+							OffsetMesh.Vertices[Vertex] += VertexNormals[Vertex] * Offset;
+						}
+						return OffsetMesh;
+					}, [Bunny, OffsetNormal](const FMeshBuffers& Result) {
+						auto Mesh = Result.ToStaticMesh();
+						Mesh->SetMaterial(Bunny->GetMaterial());
+						OffsetNormal->GetStaticMeshComponent()->SetMeshData(Mesh);
+					});
 				}
 				ImGui::End();
 			}
 		});
+		world.TickFunction = [Jobs](double, World&) { Jobs->Flush(); };
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,263 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "CoreMinimal.h"
+
+/**
+ * Linear allocator: allocations bump an offset in the current block, and everything is released at once by Reset.
+ * When it runs out of space it adds a block, and the next Reset merges the blocks into one,
+ * so once the arena has grown to the peak usage it stops touching the heap.
+ */
+class LinearArena
+{
+public:
+	struct FStats
+	{
+		size_t	BytesUsed = 0;			 // Since the last Reset
+		size_t	PeakBytes = 0;			 // Largest BytesUsed so far
+		size_t	Capacity = 0;
+		int64_t NumAllocations = 0;		 // Since the last Reset
+		int64_t NumBlockAllocations = 0; // Heap allocations made by the arena, in total
+	};
+
+	// Position to rewind to, see Rewind
+	struct FMark
+	{
+		int	   Block = 0;
+		size_t Offset = 0;
+		size_t BytesUsed = 0;
+	};
+
+	explicit LinearArena(size_t InitialCapacity = 64 << 10) { AddBlock(InitialCapacity); }
+
+	LinearArena(const LinearArena&) = delete;
+	LinearArena& operator=(const LinearArena&) = delete;
+
+	void* Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t))
+	{
+		while (true)
+		{
+			FBlock&	  Block = Blocks[Current];
+			uintptr_t Begin = reinterpret_cast<uintptr_t>(Block.Memory.get());
+			uintptr_t Aligned = (Begin + Offset + Alignment - 1) & ~(uintptr_t(Alignment) - 1);
+			if (Aligned + Size <= Begin + Block.Size)
+			{
+				Counters.BytesUsed += Aligned + Size - (Begin + Offset);
+				Counters.PeakBytes = std::max<size_t>(Counters.PeakBytes, Counters.BytesUsed);
+				Counters.NumAllocations += 1;
+				Offset = Aligned + Size - Begin;
+				return reinterpret_cast<void*>(Aligned);
+			}
+			// Blocks after the current one are left over from a rewind
+			if (Current + 1 == static_cast<int>(Blocks.size()))
+				AddBlock(std::max(Block.Size * 2, Size + Alignment));
+			Current++;
+			Offset = 0;
+		}
+	}
+
+	// Give the memory back if it is the last allocation, other frees wait for the Reset
+	void Free(void* Memory, size_t Size)
+	{
+		auto Top = reinterpret_cast<uintptr_t>(Blocks[Current].Memory.get()) + Offset;
+		if (reinterpret_cast<uintptr_t>(Memory) + Size == Top)
+		{
+			Offset -= Size;
+			Counters.BytesUsed -= Size;
+		}
+	}
+
+	[[nodiscard]] FMark GetMark() const { return { Current, Offset, Counters.BytesUsed }; }
+
+	// Release everything allocated after Mark was taken
+	void Rewind(const FMark& Mark)
+	{
+		Current = Mark.Block;
+		Offset = Mark.Offset;
+		Counters.BytesUsed = Mark.BytesUsed;
+	}
+
+	// Release everything. Memory from the arena must not be used after this
+	void Reset()
+	{
+		if (Blocks.size() > 1)
+		{
+			size_t Capacity = Counters.Capacity;
+			Blocks.clear();
+			Counters.Capacity = 0;
+			AddBlock(Capacity);
+		}
+		Current = 0;
+		Offset = 0;
+		Counters.BytesUsed = 0;
+		Counters.NumAllocations = 0;
+	}
+
+	// Can be called from any thread, the counters are read one by one while the owner may be allocating
+	[[nodiscard]] FStats GetStats() const
+	{
+		return { Counters.BytesUsed, Counters.PeakBytes, Counters.Capacity, Counters.NumAllocations, Counters.NumBlockAllocations };
+	}
+
+protected:
+	struct FBlock
+	{
+		std::unique_ptr<std::byte[]> Memory;
+		size_t						 Size;
+	};
+
+	// Written by the owning thread only. Relaxed atomics, so GetStats from another thread reads them without a data race
+	template <class T>
+	class TCounter
+	{
+	public:
+		operator T() const { return Value.load(std::memory_order_relaxed); }
+		TCounter& operator=(T InValue)
+		{
+			Value.store(InValue, std::memory_order_relaxed);
+			return *this;
+		}
+		// Load and store rather than fetch_add, there is a single writer
+		TCounter& operator+=(T Delta) { return *this = *this + Delta; }
+		TCounter& operator-=(T Delta) { return *this = *this - Delta; }
+
+	protected:
+		std::atomic<T> Value = 0;
+	};
+
+	struct FCounters
+	{
+		TCounter<size_t>  BytesUsed, PeakBytes, Capacity;
+		TCounter<int64_t> NumAllocations, NumBlockAllocations;
+	};
+
+	TArray<FBlock> Blocks;
+	int			   Current = 0;
+	size_t		   Offset = 0;
+	FCounters	   Counters;
+
+	void AddBlock(size_t Size)
+	{
+		Blocks.push_back({ std::make_unique_for_overwrite<std::byte[]>(Size), Size });
+		Counters.Capacity += Size;
+		Counters.NumBlockAllocations += 1;
+	}
+};
+
+/**
+ * Per-frame arenas, one for each thread so jobs allocate without locks.
+ * BeginFrame releases the arena of the game thread only, an arena is never reset by another thread while its owner
+ * may be allocating. Jobs release their allocations with an FArenaScope instead.
+ * They are for transient data only: containers must not be kept across frames, or used by work that outlives
+ * the frame (e.g. TAsyncRebuild).
+ * Usage:
+ *	world.TickFunction = [](double, World&) {
+ *		FrameArena::BeginFrame();
+ *		TArenaArray<FVector> Points; // Frame arena of the calling thread
+ *		...
+ *	};
+ *	Jobs.ParallelFor(Num, [](int i) {
+ *		FArenaScope ArenaScope; // Released when the job is done
+ *		TArenaArray<int> Scratch;
+ *	});
+ */
+class FrameArena
+{
+public:
+	// Arena of the calling thread
+	static LinearArena& Local()
+	{
+		thread_local std::shared_ptr<LinearArena> Arena;
+		if (!Arena)
+		{
+			Arena = std::make_shared<LinearArena>();
+			auto& Registry = GetRegistry();
+			std::lock_guard Lock(Registry.Mutex);
+			Registry.Arenas.push_back(Arena);
+		}
+		return *Arena;
+	}
+
+	// Reset the arena of the calling thread, call on the game thread at the frame boundary
+	static void BeginFrame() { Local().Reset(); }
+
+	// Counters summed over the threads, approximate while other threads allocate
+	static LinearArena::FStats GetStats()
+	{
+		auto& Registry = GetRegistry();
+		std::lock_guard		Lock(Registry.Mutex);
+		LinearArena::FStats Result;
+		for (const auto& Arena : Registry.Arenas)
+		{
+			LinearArena::FStats Stats = Arena->GetStats();
+			Result.BytesUsed += Stats.BytesUsed;
+			Result.PeakBytes += Stats.PeakBytes;
+			Result.Capacity += Stats.Capacity;
+			Result.NumAllocations += Stats.NumAllocations;
+			Result.NumBlockAllocations += Stats.NumBlockAllocations;
+		}
+		return Result;
+	}
+
+protected:
+	// Arenas of finished threads are kept, their memory is reused by nobody but stays valid until exit
+	struct FRegistry
+	{
+		std::mutex							 Mutex;
+		TArray<std::shared_ptr<LinearArena>> Arenas;
+	};
+
+	static FRegistry& GetRegistry()
+	{
+		static FRegistry Registry;
+		return Registry;
+	}
+};
+
+// Releases the arena allocations made in the scope, for transient data outside of a frame, e.g. in a one shot setup
+class FArenaScope
+{
+public:
+	explicit FArenaScope(LinearArena& InArena = FrameArena::Local()) : Arena(InArena), Mark(InArena.GetMark()) {}
+	~FArenaScope() { Arena.Rewind(Mark); }
+
+	FArenaScope(const FArenaScope&) = delete;
+	FArenaScope& operator=(const FArenaScope&) = delete;
+
+protected:
+	LinearArena&	   Arena;
+	LinearArena::FMark Mark;
+};
+
+/**
+ * Standard allocator on a LinearArena, the frame arena of the constructing thread by default.
+ * Deallocation is free and only gives memory back for the last allocation.
+ */
+template <class T>
+class TArenaAllocator
+{
+public:
+	using value_type = T;
+
+	TArenaAllocator() : Arena(&FrameArena::Local()) {}
+	explicit TArenaAllocator(LinearArena& InArena) : Arena(&InArena) {}
+	template <class U>
+	TArenaAllocator(const TArenaAllocator<U>& Other) : Arena(Other.GetArena()) {}
+
+	T*	 allocate(size_t Num) { return static_cast<T*>(Arena->Allocate(Num * sizeof(T), alignof(T))); }
+	void deallocate(T* Memory, size_t Num) { Arena->Free(Memory, Num * sizeof(T)); }
+
+	[[nodiscard]] LinearArena* GetArena() const { return Arena; }
+
+	template <class U>
+	bool operator==(const TArenaAllocator<U>& Other) const { return Arena == Other.GetArena(); }
+
+protected:
+	LinearArena* Arena;
+};
+
+// TArray on the frame arena of the constructing thread, for transient per-frame data
+template <class T>
+using TArenaArray = std::vector<T, TArenaAllocator<T>>;
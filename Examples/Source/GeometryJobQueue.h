@@ -0,0 +1,266 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include "CoreMinimal.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+/**
+ * Cancellation flag of a geometry job. Long operations can poll it between steps and return early,
+ * their result is discarded anyway.
+ */
+class FCancellationToken
+{
+public:
+	[[nodiscard]] bool IsCancelled() const { return Cancelled->load(std::memory_order_relaxed); }
+	void			   Cancel() const { Cancelled->store(true, std::memory_order_relaxed); }
+
+protected:
+	std::shared_ptr<std::atomic<bool>> Cancelled = std::make_shared<std::atomic<bool>>(false);
+};
+
+enum class EGeometryJobStatus : uint8_t
+{
+	Pending,
+	Ready,
+	Cancelled,
+	Failed // Compute threw, the message is in GetError
+};
+
+/**
+ * Result of a job submitted to a GeometryJobQueue. It becomes ready on the game thread, in GeometryJobQueue::Flush,
+ * so it can be read between frames without locking.
+ */
+template <class ResultT>
+class TGeometryFuture
+{
+public:
+	struct FState
+	{
+		FCancellationToken				 Token;
+		std::atomic<EGeometryJobStatus> Status = EGeometryJobStatus::Pending;
+		std::optional<ResultT>			 Result;
+		String							 Error;
+	};
+
+	TGeometryFuture() = default;
+	explicit TGeometryFuture(std::shared_ptr<FState> InState) : State(std::move(InState)) {}
+
+	[[nodiscard]] bool				 IsValid() const { return State != nullptr; }
+	[[nodiscard]] EGeometryJobStatus GetStatus() const { return State ? State->Status.load(std::memory_order_acquire) : EGeometryJobStatus::Cancelled; }
+	[[nodiscard]] bool				 IsReady() const { return GetStatus() == EGeometryJobStatus::Ready; }
+
+	[[nodiscard]] const ResultT& Get() const
+	{
+		ASSERT(IsReady());
+		return *State->Result;
+	}
+
+	[[nodiscard]] const String& GetError() const
+	{
+		ASSERT(GetStatus() == EGeometryJobStatus::Failed);
+		return State->Error;
+	}
+
+	void Cancel() const
+	{
+		if (State)
+			State->Token.Cancel();
+	}
+
+protected:
+	std::shared_ptr<FState> State;
+};
+
+/**
+ * Runs heavy geometry operations (booleans, solidify, remeshing...) off the game thread, so widgets stay responsive.
+ * Jobs go to channels: a channel runs one job at a time and keeps only the latest waiting one, submitting cancels the
+ * older jobs of the channel, so dragging a slider only computes the value it stops at. Results are delivered by Flush
+ * at the frame boundary, OnReady runs there on the game thread and is where engine objects are modified.
+ * Jobs of one channel never run concurrently, so they can share state that only they touch.
+ * Compute runs on a worker thread: it must not create or modify engine objects, NewObject is for the game thread only.
+ * It returns plain data such as FMeshBuffers, and OnReady builds the StaticMesh. Long computations poll the token between steps.
+ * A job that throws is delivered as Failed, with the message logged, and the channel goes on with its next job.
+ * Usage:
+ *	auto Jobs = std::make_shared<GeometryJobQueue>();
+ *	Jobs->Submit("Solidify", [Source, Normals, Thickness](const FCancellationToken& Token) { return SolidifyBuffers(*Source, Normals, Thickness, Token); },
+ *		[Actor](const FMeshBuffers& Result) { Actor->GetStaticMeshComponent()->SetMeshData(Result.ToStaticMesh()); });
+ *	world.TickFunction = [Jobs](double, World&) { Jobs->Flush(); };
+ */
+class GeometryJobQueue
+{
+public:
+	// Pool for the geometry jobs, separate from the shared one so a long job is never picked up by a ParallelFor of the game thread
+	static JobSystem& BackgroundJobs()
+	{
+		static JobSystem Instance(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2));
+		return Instance;
+	}
+
+	explicit GeometryJobQueue(JobSystem& InJobs = BackgroundJobs())
+		: Jobs(InJobs) {}
+
+	~GeometryJobQueue() { CancelAll(); }
+
+	GeometryJobQueue(const GeometryJobQueue&) = delete;
+	GeometryJobQueue& operator=(const GeometryJobQueue&) = delete;
+
+	/**
+	 * Run Compute(Token) in the background, replacing the previous job of Channel.
+	 * OnReady(Result) runs in the Flush after it finished, unless the job was cancelled or superseded meanwhile, or threw.
+	 */
+	template <class FunctionT, class ResultT = std::invoke_result_t<FunctionT&, const FCancellationToken&>>
+	TGeometryFuture<ResultT> Submit(const String& Channel, FunctionT&& Compute, std::type_identity_t<std::function<void(const ResultT&)>> OnReady = {})
+	{
+		auto State = std::make_shared<typename TGeometryFuture<ResultT>::FState>();
+		FJob Job;
+		Job.Execute = [State, Compute = std::forward<FunctionT>(Compute)]() mutable {
+			// Caught here, an exception escaping to the worker would leave the channel running forever
+			try
+			{
+				if (!State->Token.IsCancelled())
+					State->Result.emplace(Compute(State->Token));
+			}
+			catch (const std::exception& Exception)
+			{
+				State->Error = Exception.what();
+			}
+			catch (...)
+			{
+				State->Error = "unknown exception";
+			}
+		};
+		Job.Deliver = [State, OnReady = std::move(OnReady)]() {
+			// Superseded after finishing is still superseded, the newer result is on its way
+			if (State->Token.IsCancelled() || (!State->Result && State->Error.empty()))
+			{
+				State->Status.store(EGeometryJobStatus::Cancelled, std::memory_order_release);
+				return false;
+			}
+			if (!State->Result)
+			{
+				LOG_ERROR("Geometry job failed: {}", State->Error);
+				State->Status.store(EGeometryJobStatus::Failed, std::memory_order_release);
+				return false;
+			}
+			State->Status.store(EGeometryJobStatus::Ready, std::memory_order_release);
+			if (OnReady)
+				OnReady(*State->Result);
+			return true;
+		};
+
+		std::lock_guard Lock(Shared->Mutex);
+		FChannel& Target = Shared->Channels[Channel];
+		Target.Latest.Cancel();
+		Target.Latest = State->Token;
+		Shared->NumInFlight++;
+		if (Target.Waiting)
+			Shared->Completed.push_back(std::move(Target.Waiting->Deliver)); // Never ran, delivered as cancelled
+		if (Target.bRunning)
+			Target.Waiting = std::move(Job);
+		else
+		{
+			Target.bRunning = true;
+			Dispatch(Shared, Jobs, Channel, std::move(Job));
+		}
+		return TGeometryFuture<ResultT>(State);
+	}
+
+	void Cancel(const String& Channel)
+	{
+		std::lock_guard Lock(Shared->Mutex);
+		if (auto It = Shared->Channels.find(Channel); It != Shared->Channels.end())
+			It->second.Latest.Cancel();
+	}
+
+	void CancelAll()
+	{
+		std::lock_guard Lock(Shared->Mutex);
+		for (auto& [Name, Channel] : Shared->Channels)
+			Channel.Latest.Cancel();
+	}
+
+	/**
+	 * Deliver the finished jobs, call once per frame on the game thread.
+	 * @return the number of results handed to OnReady, cancelled and failed jobs are not counted
+	 */
+	int Flush()
+	{
+		PROFILE_SCOPE("GeometryJobQueue::Flush");
+		TArray<std::function<bool()>> Completed;
+		{
+			std::lock_guard Lock(Shared->Mutex);
+			Completed.swap(Shared->Completed);
+			Shared->NumInFlight -= static_cast<int>(Completed.size());
+		}
+		int NumDelivered = 0;
+		for (auto& Deliver : Completed)
+			NumDelivered += Deliver();
+		return NumDelivered;
+	}
+
+	// Jobs submitted and not delivered yet, e.g. to show a busy indicator
+	[[nodiscard]] int NumInFlight() const
+	{
+		std::lock_guard Lock(Shared->Mutex);
+		return Shared->NumInFlight;
+	}
+
+	[[nodiscard]] bool IsBusy() const { return NumInFlight() > 0; }
+
+protected:
+	struct FJob
+	{
+		std::function<void()> Execute; // Background, computes the result
+		std::function<bool()> Deliver; // Game thread, in Flush, false if cancelled or failed
+	};
+
+	struct FChannel
+	{
+		FCancellationToken	Latest;
+		bool				bRunning = false;
+		std::optional<FJob> Waiting;
+	};
+
+	// Outlives the queue while its jobs are running
+	struct FShared
+	{
+		mutable std::mutex					 Mutex;
+		std::unordered_map<String, FChannel> Channels;
+		TArray<std::function<bool()>>		 Completed;
+		int									 NumInFlight = 0;
+	};
+
+	JobSystem&				 Jobs;
+	std::shared_ptr<FShared> Shared = std::make_shared<FShared>();
+
+	// Run Job, then the job waiting on the channel if any. Called with the mutex held
+	static void Dispatch(const std::shared_ptr<FShared>& Shared, JobSystem& Jobs, const String& Channel, FJob Job)
+	{
+		Jobs.Submit([Shared, &Jobs, Channel, Job = std::move(Job)]() mutable {
+			{
+				PROFILE_SCOPE("GeometryJobQueue::Execute");
+				Job.Execute();
+			}
+			std::lock_guard Lock(Shared->Mutex);
+			Shared->Completed.push_back(std::move(Job.Deliver));
+			FChannel& Target = Shared->Channels[Channel];
+			if (Target.Waiting)
+			{
+				FJob Next = std::move(*Target.Waiting);
+				Target.Waiting.reset();
+				Dispatch(Shared, Jobs, Channel, std::move(Next));
+			}
+			else
+				Target.bRunning = false;
+		});
+	}
+};
@@ -13,6 +13,7 @@
 #include "Math/Intersect.h"
 #include "Mesh/BasicShapesLibrary.h"
 #include "spdlog/stopwatch.h"
+#include "TriangleIntersection.h"
 
 /****************************************************************************************
  *
@@ -35,25 +36,17 @@ inline auto IntersectionExample()
 
 		if(intersect)
 		{
+			// Candidate pairs of the broad phase, the exact test removes its false positives
+			TArray<Vector2i> Pairs(IntersectTriangles.rows());
 			for(int i = 0; i < IntersectTriangles.rows(); i ++)
-			{
-				auto Index1 = IntersectTriangles(i, 0);
-				auto Index2 = IntersectTriangles(i, 1);
-
-				auto Triangle1 = Mesh1->GetTriangle(Index1);
-				auto Triangle2 = Mesh2->GetTriangle(Index2);
-
-				auto VertexA0 = Mesh1->GetVertex(Triangle1.x());
-				auto VertexA1 = Mesh1->GetVertex(Triangle1.y());
-				auto VertexA2 = Mesh1->GetVertex(Triangle1.z());
+				Pairs[i] = IntersectTriangles.row(i).transpose();
 
-				auto VertexB0 = Mesh2->GetVertex(Triangle2.x());
-				auto VertexB1 = Mesh2->GetVertex(Triangle2.y());
-				auto VertexB2 = Mesh2->GetVertex(Triangle2.z());
-
-				auto[Result, SegA, SegB] = TriangleIntersectTriangle(VertexA0, VertexA1, VertexA2, VertexB0, VertexB1, VertexB2);
-				if(Result) // This check is necessary, because the result from MeshIntersectMesh may be false positive
-					World.DebugDrawLine(SegA, SegB, FVector(1, 0, 0) ,2);
+			TArray<FTriangleIntersection> Segments(Pairs.size());
+			TriangleIntersection::IntersectPairs(FMeshBuffers::FromStaticMesh(*Mesh1), FMeshBuffers::FromStaticMesh(*Mesh2), Pairs, Segments);
+			for(const auto& Segment : Segments)
+			{
+				if(Segment.Type == ETriangleIntersection::Segment)
+					World.DebugDrawLine(Segment.Start, Segment.End, FVector(1, 0, 0) ,2);
 			}
 		}
 	};
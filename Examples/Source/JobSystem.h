@@ -0,0 +1,202 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "CoreMinimal.h"
+#include "Profiler.h"
+
+/**
+ * Work-stealing thread pool.
+ * Each worker owns a deque, it pops its own jobs from the back and steals from the front of the others.
+ * Waiting threads run pending jobs instead of blocking, so ParallelFor can be nested and called from jobs.
+ */
+class JobSystem
+{
+public:
+	using FJob = std::function<void()>;
+
+	// Shared pool with one worker per hardware thread, minus the game thread
+	static JobSystem& Get()
+	{
+		static JobSystem Instance(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+		return Instance;
+	}
+
+	// At least one worker, Submit distributes over the worker queues
+	explicit JobSystem(int NumWorkers)
+	{
+		NumWorkers = std::max(1, NumWorkers);
+		for (int i = 0; i < NumWorkers; i++)
+			Queues.push_back(std::make_unique<FQueue>());
+		for (int i = 0; i < NumWorkers; i++)
+			Workers.emplace_back([this, i] { WorkerLoop(i); });
+	}
+
+	~JobSystem()
+	{
+		{
+			std::lock_guard Lock(SleepMutex);
+			Stopping = true;
+		}
+		WakeUp.notify_all();
+		for (auto& Worker : Workers)
+			Worker.join();
+	}
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	[[nodiscard]] int NumWorkers() const { return static_cast<int>(Workers.size()); }
+
+	// Queue a job, jobs submitted from a worker go to its own deque
+	void Submit(FJob Job)
+	{
+		int Index = LocalWorkerIndex();
+		if (Index < 0)
+			Index = static_cast<int>(NextQueue.fetch_add(1, std::memory_order_relaxed) % Queues.size());
+		{
+			std::lock_guard Lock(Queues[Index]->Mutex);
+			Queues[Index]->Jobs.push_back(std::move(Job));
+		}
+		Pending.fetch_add(1, std::memory_order_release);
+		{
+			// Pairs with the predicate check in WorkerLoop, so the wake up can not be lost
+			std::lock_guard Lock(SleepMutex);
+		}
+		WakeUp.notify_one();
+	}
+
+	// Run one pending job on the calling thread, return false if there was nothing to run
+	bool RunPendingJob()
+	{
+		FJob Job;
+		if (!TryPop(LocalWorkerIndex(), Job))
+			return false;
+		Job();
+		return true;
+	}
+
+	// Help with pending jobs until Counter drops to zero
+	void WaitFor(const std::atomic<int>& Counter)
+	{
+		while (Counter.load(std::memory_order_acquire) > 0)
+		{
+			if (!RunPendingJob())
+				std::this_thread::yield();
+		}
+	}
+
+	// Call Function(i) for i in [0, Num), in chunks of at least Grain iterations. The calling thread takes part
+	template <class FunctionT>
+	void ParallelFor(int Num, FunctionT&& Function, int Grain = 1)
+	{
+		if (Num <= 0)
+			return;
+		int NumChunks = std::min((Num + Grain - 1) / std::max(Grain, 1), (NumWorkers() + 1) * 4);
+		if (NumChunks <= 1)
+		{
+			for (int i = 0; i < Num; i++)
+				Function(i);
+			return;
+		}
+		std::atomic<int> Remaining = NumChunks;
+		auto RunChunk = [&](int Chunk) {
+			PROFILE_SCOPE("ParallelFor");
+			int Begin = static_cast<int>(int64_t(Num) * Chunk / NumChunks);
+			int End = static_cast<int>(int64_t(Num) * (Chunk + 1) / NumChunks);
+			for (int i = Begin; i < End; i++)
+				Function(i);
+			Remaining.fetch_sub(1, std::memory_order_acq_rel);
+		};
+		for (int Chunk = 1; Chunk < NumChunks; Chunk++)
+			Submit([&RunChunk, Chunk] { RunChunk(Chunk); });
+		RunChunk(0);
+		WaitFor(Remaining);
+	}
+
+protected:
+	struct FQueue
+	{
+		std::mutex		  Mutex;
+		std::deque<FJob> Jobs;
+	};
+
+	TArray<std::unique_ptr<FQueue>> Queues;
+	TArray<std::thread>				Workers;
+	std::atomic<uint32_t>			NextQueue = 0;
+	std::atomic<int>				Pending = 0;
+	std::mutex						SleepMutex;
+	std::condition_variable			WakeUp;
+	bool							Stopping = false;
+
+	struct FWorkerIdentity
+	{
+		const JobSystem* Pool = nullptr;
+		int				 Index = -1;
+	};
+
+	static FWorkerIdentity& LocalIdentity()
+	{
+		thread_local FWorkerIdentity Identity;
+		return Identity;
+	}
+
+	// Index of the calling thread in this pool, or -1 if it is not one of its workers
+	int LocalWorkerIndex() const
+	{
+		const FWorkerIdentity& Identity = LocalIdentity();
+		return Identity.Pool == this ? Identity.Index : -1;
+	}
+
+	bool TryPop(int Self, FJob& Job)
+	{
+		if (Pending.load(std::memory_order_acquire) <= 0)
+			return false;
+		int NumQueues = static_cast<int>(Queues.size());
+		for (int Offset = 0; Offset < NumQueues; Offset++)
+		{
+			bool	IsOwn = Self >= 0 && Offset == 0;
+			FQueue& Queue = *Queues[IsOwn ? Self : (std::max(Self, 0) + Offset) % NumQueues];
+			std::lock_guard Lock(Queue.Mutex);
+			if (Queue.Jobs.empty())
+				continue;
+			if (IsOwn)
+			{
+				Job = std::move(Queue.Jobs.back());
+				Queue.Jobs.pop_back();
+			}
+			else
+			{
+				Job = std::move(Queue.Jobs.front());
+				Queue.Jobs.pop_front();
+			}
+			Pending.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+		return false;
+	}
+
+	void WorkerLoop(int Index)
+	{
+		LocalIdentity() = { this, Index };
+		Profiler::Get().SetThreadName("Worker " + std::to_string(Index));
+		while (true)
+		{
+			FJob Job;
+			if (TryPop(Index, Job))
+			{
+				Job();
+				continue;
+			}
+			std::unique_lock Lock(SleepMutex);
+			WakeUp.wait(Lock, [this] { return Stopping || Pending.load(std::memory_order_acquire) > 0; });
+			if (Stopping)
+				return;
+		}
+	}
+};
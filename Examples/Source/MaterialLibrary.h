@@ -0,0 +1,110 @@
+#pragma once
+#include <optional>
+#include <unordered_map>
+#include "CoreMinimal.h"
+#include "ReflectionTable.h"
+#include "Materials/Material.h"
+#include "Mesh/StaticMesh.h"
+
+/**
+ * The material parameters set by the examples. Unset optionals keep the engine default.
+ */
+struct FMaterialParameters
+{
+	std::optional<FColor> BaseColor;
+	std::optional<double> Alpha;
+	bool				  ShowWireframe = false;
+
+	[[nodiscard]] uint64_t Hash() const
+	{
+		uint64_t Result = ReflectionTable::Hash(BaseColor ? "C" : "-");
+		auto	 HashBytes = [&Result](const auto& Value) {
+			Result = ReflectionTable::Hash(std::string_view(reinterpret_cast<const char*>(&Value), sizeof(Value)), Result);
+		};
+		if (BaseColor)
+			for (int i = 0; i < 3; i++)
+				HashBytes((*BaseColor)[i]);
+		HashBytes(Alpha.value_or(-1.));
+		HashBytes(ShowWireframe);
+		return Result;
+	}
+
+	bool operator==(const FMaterialParameters& Other) const
+	{
+		return BaseColor.has_value() == Other.BaseColor.has_value() && (!BaseColor || *BaseColor == *Other.BaseColor)
+			&& Alpha == Other.Alpha && ShowWireframe == Other.ShowWireframe;
+	}
+
+	[[nodiscard]] bool IsDefault() const { return !BaseColor && !Alpha && !ShowWireframe; }
+
+	void ApplyTo(Material& Target) const
+	{
+		if (BaseColor)
+			Target.SetBaseColor(*BaseColor);
+		if (Alpha)
+			Target.SetAlpha(*Alpha);
+		Target.SetShowWireframe(ShowWireframe);
+	}
+};
+
+/**
+ * Deduplicated materials: meshes with equal parameters share one Material instead of one copy each.
+ * Materials live in a compact table, the table index is stable and can address a bindless material buffer.
+ * IndexOf only fills the table, so code without the engine (e.g. CpuScene) shares the same deduplication.
+ * The Material objects are created on first use by GetMaterial, on the game thread.
+ * Shared materials must not be edited through one of their meshes, Assign other parameters to give a mesh its own.
+ * Every StaticMesh is created with a default Material of its own, Assign replaces it so the default is released.
+ */
+class MaterialLibrary
+{
+public:
+	// The shared material with the given parameters, created on first use
+	ObjectPtr<Material> FindOrCreate(const FMaterialParameters& Parameters)
+	{
+		return GetMaterial(IndexOf(Parameters));
+	}
+
+	// Table index of the material with the given parameters, added on first use
+	int IndexOf(const FMaterialParameters& Parameters)
+	{
+		auto& Bucket = Buckets[Parameters.Hash()];
+		for (int Index : Bucket)
+			if (Entries[Index].Parameters == Parameters)
+				return Index;
+
+		Entries.push_back({ Parameters, nullptr });
+		Bucket.push_back(NumMaterials() - 1);
+		return NumMaterials() - 1;
+	}
+
+	// Replace the material of a mesh by the shared one
+	void Assign(StaticMesh& Mesh, const FMaterialParameters& Parameters)
+	{
+		Mesh.SetMaterial(FindOrCreate(Parameters));
+	}
+
+	// Material of a table entry, created on first use
+	const ObjectPtr<Material>& GetMaterial(int Index)
+	{
+		auto& Entry = Entries[Index];
+		if (!Entry.Target)
+		{
+			Entry.Target = NewObject<Material>();
+			Entry.Parameters.ApplyTo(*Entry.Target);
+		}
+		return Entry.Target;
+	}
+
+	[[nodiscard]] int NumMaterials() const { return static_cast<int>(Entries.size()); }
+	[[nodiscard]] const FMaterialParameters& GetParameters(int Index) const { return Entries[Index].Parameters; }
+
+protected:
+	struct FEntry
+	{
+		FMaterialParameters Parameters;
+		ObjectPtr<Material> Target; // Null until GetMaterial
+	};
+
+	TArray<FEntry>							   Entries;
+	std::unordered_map<uint64_t, TArray<int>> Buckets;
+};
@@ -3,11 +3,17 @@
 //
 
 #pragma once
+#include <chrono>
 #include "Core/CoreMinimal.h"
+#include "GeometryJobQueue.h"
+#include "ImguiPlus.h"
+#include "LambdaUIWidget.h"
 #include "Game/StaticMeshActor.h"
 #include "Game/World.h"
 #include "Mesh/BasicShapesLibrary.h"
 #include "Mesh/MeshBoolean.h"
+#include "MeshRepair.h"
+#include "SparseSDF.h"
 
 inline auto MeshBooleanTest()
 {
@@ -17,6 +23,17 @@ inline auto MeshBooleanTest()
 		ObjectPtr<StaticMesh> Mesh1 = BasicShapesLibrary::GenerateCylinder(1., 0.5);
 		ObjectPtr<StaticMesh> Mesh2 = BasicShapesLibrary::GenerateSphere(0.5);
 		Mesh2->Translate({0,0,0.5});
+
+		// The booleans expect closed manifold inputs, repaired once and cached until the geometry changes
+		for (ObjectPtr<StaticMesh>* Input : {&Mesh1, &Mesh2})
+		{
+			auto Repaired = MeshRepairCache::Get().Find(*Input);
+			if (!Repaired->Report.IsClean(true))
+				LOG_WARNING("Boolean input is not clean after repair: {} holes, {} non manifold edges, {} self intersections",
+					Repaired->Report.NumHoles - Repaired->Report.NumFilledHoles, Repaired->Report.NumNonManifoldEdges,
+					Repaired->Report.NumRemainingSelfIntersections + Repaired->Report.NumShellIntersections);
+			*Input = Repaired->Mesh;
+		}
 		ObjectPtr<StaticMesh> MeshR1 = MeshBoolean::MeshUnion(Mesh1, Mesh2);
 		ObjectPtr<StaticMesh> MeshR2 = MeshBoolean::MeshMinus(Mesh1, Mesh2);
 		ObjectPtr<StaticMesh> MeshR3 = MeshBoolean::MeshConnect(Mesh1, Mesh2);
@@ -43,5 +60,58 @@ inline auto MeshBooleanTest()
 		Result3->GetStaticMeshComponent()->GetMeshData()->GetMaterial()->SetShowWireframe(true);
 		Result3->SetTranslation({0.,0.,2.});
 
+		// Drag to cut: the preview subtracts the cutter on a voxel grid in the background, the exact boolean only runs on Apply
+		auto Preview = World.SpawnActor<StaticMeshActor>("CutPreview");
+		Preview->SetTranslation({0.,2.,0.});
+		auto Jobs = std::make_shared<GeometryJobQueue>();
+		auto PreviewMilliseconds = std::make_shared<double>(0.);
+		World.AddWidget<LambdaUIWidget>([Mesh1, Preview, Jobs, PreviewMilliseconds]() {
+			static constexpr double CutterRadius = 0.5;
+			static float	 Center[3] = { 0.f, 0.f, 0.5f };
+			static float	 VoxelSize = 0.02f;
+			static bool		 bDirty = true;
+			if(ImGui::Begin("Approximate Boolean", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+			{
+				bDirty |= ImGui::SliderFloat3("Cutter center", Center, -1.f, 1.f);
+				bDirty |= ImGui::SliderFloat("Voxel size", &VoxelSize, 0.005f, 0.05f);
+				FVector CutterCenter(Center[0], Center[1], Center[2]);
+				if(bDirty)
+				{
+					// Superseded by the next change while dragging, only the value the slider stops at is extracted
+					Jobs->Submit("Preview", [Mesh1, CutterCenter, VoxelSize = static_cast<double>(VoxelSize)](const FCancellationToken& Token) {
+						auto Start = std::chrono::steady_clock::now();
+						auto Part = SparseSDFCache::Get().Find(Mesh1, VoxelSize);
+						if (Token.IsCancelled())
+							return std::make_pair(FMeshBuffers(), 0.);
+						auto Cutter = SparseSDF::FromSignedDistance(AlignedBox3d(CutterCenter.array() - CutterRadius, CutterCenter.array() + CutterRadius), VoxelSize,
+							[CutterCenter](const FVector& Point) { return (Point - CutterCenter).norm() - CutterRadius; });
+						if (Token.IsCancelled())
+							return std::make_pair(FMeshBuffers(), 0.);
+						FMeshBuffers Result = SparseSDF::Subtract(*Part, Cutter).Extract();
+						return std::make_pair(std::move(Result), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count());
+					}, [Mesh1, Preview, PreviewMilliseconds](const std::pair<FMeshBuffers, double>& Result) {
+						auto Mesh = Result.first.ToStaticMesh();
+						Mesh->SetMaterial(Mesh1->GetMaterial());
+						Preview->GetStaticMeshComponent()->SetMeshData(Mesh);
+						*PreviewMilliseconds = Result.second;
+					});
+					bDirty = false;
+				}
+				ImGui::Text("Preview: %.1f ms", *PreviewMilliseconds);
+				if(ImGui::Button("Apply exact"))
+				{
+					// The engine's booleans create their result with NewObject, which is for the game thread only,
+					// so the exact cut runs here on Apply while the voxel preview above stays in the background
+					ObjectPtr<StaticMesh> Cutter = BasicShapesLibrary::GenerateSphere(CutterRadius);
+					Cutter->Translate(CutterCenter);
+					Preview->GetStaticMeshComponent()->SetMeshData(MeshBoolean::MeshMinus(Mesh1, Cutter));
+				}
+				if(Jobs->IsBusy())
+					ImGui::Text("Computing...");
+				ImGui::End();
+			}
+		});
+		World.TickFunction = [Jobs](double, auto&) { Jobs->Flush(); };
+
 	};
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include "CoreMinimal.h"
+#include "ReflectionTable.h"
+#include "Mesh/StaticMesh.h"
+#include "Misc/Path.h"
+
+/**
+ * Plain vertex and triangle arrays of a StaticMesh.
+ * The geometry utilities in the examples work on these contiguous arrays, and convert back with ToStaticMesh.
+ */
+struct FMeshBuffers
+{
+	TArray<FVector>	 Vertices;
+	TArray<Vector3i> Triangles;
+
+	[[nodiscard]] int NumVertices() const { return static_cast<int>(Vertices.size()); }
+	[[nodiscard]] int NumTriangles() const { return static_cast<int>(Triangles.size()); }
+
+	// Hash of the triangles and the vertex positions, to tell whether data derived from the mesh is still valid
+	[[nodiscard]] uint64_t HashGeometry() const
+	{
+		uint64_t Result = ReflectionTable::Hash(std::string_view(reinterpret_cast<const char*>(Triangles.data()), Triangles.size() * sizeof(Vector3i)));
+		return ReflectionTable::Hash(std::string_view(reinterpret_cast<const char*>(Vertices.data()), Vertices.size() * sizeof(FVector)), Result);
+	}
+
+	static FMeshBuffers FromStaticMesh(const StaticMesh& Mesh)
+	{
+		FMeshBuffers Result;
+		Result.Vertices.resize(Mesh.GetVertexNum());
+		Result.Triangles.resize(Mesh.GetFaceNum());
+		for (int i = 0; i < Result.NumVertices(); i++)
+			Result.Vertices[i] = Mesh.GetVertex(i);
+		for (int i = 0; i < Result.NumTriangles(); i++)
+			Result.Triangles[i] = Mesh.GetTriangle(i);
+		return Result;
+	}
+
+	/**
+	 * Positions and faces of an OBJ file, polygons are split into fans. Texture coordinates, normals and groups are ignored.
+	 * The counterpart of StaticMesh::LoadObj for code that runs without the engine, empty when the file cannot be read.
+	 */
+	static std::optional<FMeshBuffers> LoadObj(const Path& File)
+	{
+		std::ifstream InFile(File);
+		if (!InFile)
+			return std::nullopt;
+		FMeshBuffers Result;
+		String		 Line;
+		while (std::getline(InFile, Line))
+		{
+			std::istringstream Stream(Line);
+			String			   Keyword;
+			Stream >> Keyword;
+			if (Keyword == "v")
+			{
+				FVector Vertex;
+				Stream >> Vertex.x() >> Vertex.y() >> Vertex.z();
+				Result.Vertices.push_back(Vertex);
+			}
+			else if (Keyword == "f")
+			{
+				// "i", "i/t", "i//n" or "i/t/n", negative indices count from the last vertex
+				TArray<int> Face;
+				for (String Corner; Stream >> Corner;)
+				{
+					int Index = std::atoi(Corner.c_str());
+					Index = Index < 0 ? Result.NumVertices() + Index : Index - 1;
+					if (Index < 0 || Index >= Result.NumVertices())
+					{
+						LOG_ERROR("Invalid vertex index {} in {}", Corner, File.string());
+						return std::nullopt;
+					}
+					Face.push_back(Index);
+				}
+				for (int i = 2; i < static_cast<int>(Face.size()); i++)
+					Result.Triangles.emplace_back(Face[0], Face[i - 1], Face[i]);
+			}
+		}
+		return Result;
+	}
+
+	[[nodiscard]] ObjectPtr<StaticMesh> ToStaticMesh() const
+	{
+		MatrixX3d VerM(NumVertices(), 3);
+		MatrixX3i TriM(NumTriangles(), 3);
+		for (int i = 0; i < NumVertices(); i++)
+			VerM.row(i) = Vertices[i].transpose();
+		for (int i = 0; i < NumTriangles(); i++)
+			TriM.row(i) = Triangles[i].transpose();
+		return NewObject<StaticMesh>(VerM, TriM);
+	}
+};
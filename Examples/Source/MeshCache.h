@@ -0,0 +1,49 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "CoreMinimal.h"
+#include "Mesh/StaticMesh.h"
+
+/**
+ * Data derived from a StaticMesh, one value per mesh, kept while the mesh is alive and built again when Key changes,
+ * e.g. the geometry hash of the mesh and the settings the value was built with. The mesh caches of the examples use it.
+ * The lock only covers the lookup, Build runs without it. Find is safe from several threads only when Build is,
+ * a Build that creates engine objects makes the cache game thread only.
+ * Usage:
+ *	TMeshCache<FMeshAdjacency> Cache;
+ *	auto Adjacency = Cache.Find(Mesh, Buffers.HashGeometry(), [&] { return FMeshAdjacency::Build(...); });
+ */
+template <class ValueT, class KeyT = uint64_t>
+class TMeshCache
+{
+public:
+	template <class BuildT>
+	std::shared_ptr<const ValueT> Find(const ObjectPtr<StaticMesh>& Mesh, const KeyT& Key, BuildT&& Build)
+	{
+		{
+			std::lock_guard Lock(Mutex);
+			auto			It = Entries.find(Mesh.get());
+			if (It != Entries.end() && It->second.Owner.lock() == Mesh && It->second.Key == Key)
+				return It->second.Value;
+		}
+
+		auto			Value = std::make_shared<const ValueT>(Build());
+		std::lock_guard Lock(Mutex);
+		// Entries of destroyed meshes go here, their address may be reused by a new mesh
+		std::erase_if(Entries, [](const auto& Entry) { return Entry.second.Owner.expired(); });
+		Entries[Mesh.get()] = { Mesh, Key, Value };
+		return Value;
+	}
+
+protected:
+	struct FEntry
+	{
+		WeakObjectPtr<StaticMesh>	  Owner;
+		KeyT						  Key;
+		std::shared_ptr<const ValueT> Value;
+	};
+
+	std::mutex									  Mutex;
+	std::unordered_map<const StaticMesh*, FEntry> Entries;
+};
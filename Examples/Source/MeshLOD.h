@@ -0,0 +1,92 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "MeshCache.h"
+#include "MeshLayout.h"
+#include "MeshSimplifier.h"
+
+/**
+ * Levels of detail of a mesh, level 0 is the mesh itself and each next level has about half the triangles.
+ * Error is the geometric error of a level in mesh units, used to pick the coarsest level that stays under a pixel threshold.
+ */
+struct FMeshLODChain
+{
+	struct FLevel
+	{
+		ObjectPtr<StaticMesh> Mesh;
+		int					  NumTriangles = 0;
+		double				  Error = 0.;
+	};
+
+	TArray<FLevel> Levels;
+
+	[[nodiscard]] int NumLevels() const { return static_cast<int>(Levels.size()); }
+
+	// Pixels covered by one mesh unit at Distance from a perspective camera, FovRadians along the ScreenPixels axis
+	static double PixelsPerUnit(double Distance, double ScreenPixels, double FovRadians)
+	{
+		return ScreenPixels / (2. * std::max(Distance, 1e-6) * std::tan(FovRadians * 0.5));
+	}
+
+	// Coarsest level whose error projects to at most MaxPixelError pixels
+	[[nodiscard]] int SelectLevel(double PixelsPerUnit, double MaxPixelError) const
+	{
+		int Level = 0;
+		while (Level + 1 < NumLevels() && Levels[Level + 1].Error * PixelsPerUnit <= MaxPixelError)
+			Level++;
+		return Level;
+	}
+
+	/**
+	 * Simplify Mesh, whose buffers are Buffers, level by level, halving the triangle count (times Ratio) until MinTriangles or until the simplifier gets stuck.
+	 * The levels share the material of Mesh, and get the vertex cache friendly layout of MeshLayout.
+	 * Game thread only, the levels are created as StaticMesh objects.
+	 */
+	static FMeshLODChain Build(const ObjectPtr<StaticMesh>& Mesh, const FMeshBuffers& Buffers, int MinTriangles = 64, double Ratio = 0.5)
+	{
+		FMeshLODChain Result;
+		Result.Levels.push_back({ Mesh, Mesh->GetFaceNum(), 0. });
+
+		MeshSimplifier Simplifier(Buffers);
+		while (true)
+		{
+			int Target = static_cast<int>(Result.Levels.back().NumTriangles * Ratio);
+			if (Target < MinTriangles)
+				break;
+			FMeshBuffers Simplified = Simplifier.Simplify(Target);
+			// Stuck on collapses that would break the mesh, the level would be no cheaper
+			if (Simplified.NumTriangles() > Result.Levels.back().NumTriangles * (1. + Ratio) * 0.5)
+				break;
+			MeshLayout::Optimize(Simplified);
+			auto Level = Simplified.ToStaticMesh();
+			Level->SetMaterial(Mesh->GetMaterial());
+			Result.Levels.push_back({ Level, Simplified.NumTriangles(), Simplifier.GetMaxError() });
+		}
+		return Result;
+	}
+};
+
+/**
+ * LOD chains cached per StaticMesh, built on first use and rebuilt only when the mesh geometry changes,
+ * so actors sharing a mesh share its levels. Game thread only, like FMeshLODChain::Build.
+ * Usage:
+ *	auto Chain = MeshLODCache::Get().Find(Mesh);
+ *	int Level = Chain->SelectLevel(FMeshLODChain::PixelsPerUnit(Distance, 1080, FovY), 1.);
+ */
+class MeshLODCache
+{
+public:
+	static MeshLODCache& Get()
+	{
+		static MeshLODCache Instance;
+		return Instance;
+	}
+
+	std::shared_ptr<const FMeshLODChain> Find(const ObjectPtr<StaticMesh>& Mesh)
+	{
+		FMeshBuffers Buffers = FMeshBuffers::FromStaticMesh(*Mesh);
+		return Chains.Find(Mesh, Buffers.HashGeometry(), [&] { return FMeshLODChain::Build(Mesh, Buffers); });
+	}
+
+protected:
+	TMeshCache<FMeshLODChain> Chains;
+};
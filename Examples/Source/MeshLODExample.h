@@ -0,0 +1,80 @@
+#pragma once
+#include <imgui.h>
+#include "Actors/CameraActor.h"
+#include "Game/StaticMeshActor.h"
+#include "Game/World.h"
+#include "LambdaUIWidget.h"
+#include "MeshLOD.h"
+#include "Misc/Path.h"
+
+/****************************************************************************************
+ * MeshLODExample
+ * A field of bunnies sharing one mesh. Its LOD chain is simplified once and cached,
+ * every frame each bunny shows the coarsest level whose error stays under the pixel
+ * threshold from the camera, so the far bunnies are drawn with a fraction of the triangles.
+ * Move the camera or change the threshold to see the levels switch.
+ ****************************************************************************************/
+
+inline auto MeshLODExample()
+{
+	return [](World& world)
+	{
+		constexpr int NumRows = 12;
+		constexpr int NumColumns = 6;
+		// Screen height and vertical field of view the errors are projected with
+		constexpr double ScreenPixels = 1080.;
+		constexpr double FovRadians = M_PI / 4.;
+
+		auto Camera = world.SpawnActor<CameraActor>("MainCamera");
+		Camera->SetTranslation({-3, 0, 1}); Camera->LookAt({6, 0, 0});
+
+		auto Bunny = MeshLayoutCache::Get().Load(Path::ProjectContentDir() / "stanford-bunny.obj");
+		if (!Bunny)
+			return;
+		Bunny->Normalize();
+		auto Chain = MeshLODCache::Get().Find(Bunny);
+		auto Bunnies = std::make_shared<TArray<ObjectPtr<StaticMeshActor>>>();
+		auto Levels = std::make_shared<TArray<int>>(NumRows * NumColumns, 0);
+		for (int Row = 0; Row < NumRows; Row++)
+		{
+			for (int Column = 0; Column < NumColumns; Column++)
+			{
+				auto Actor = world.SpawnActor<StaticMeshActor>("Bunny", Bunny);
+				Actor->SetTranslation({Row * 1.5, (Column - NumColumns * 0.5) * 1.5, 0});
+				Bunnies->push_back(Actor);
+			}
+		}
+
+		auto MaxPixelError = std::make_shared<float>(1.f);
+		world.AddWidget<LambdaUIWidget>([Chain, Levels, MaxPixelError]() {
+			ImGui::Begin("Mesh LOD", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+			ImGui::SliderFloat("Max pixel error", MaxPixelError.get(), 0.1f, 20.f);
+			int NumTriangles = 0;
+			for (int Level : *Levels)
+				NumTriangles += Chain->Levels[Level].NumTriangles;
+			ImGui::Text("Triangles drawn: %d of %d", NumTriangles, Chain->Levels[0].NumTriangles * static_cast<int>(Levels->size()));
+			for (int Level = 0; Level < Chain->NumLevels(); Level++)
+			{
+				int NumActors = static_cast<int>(std::count(Levels->begin(), Levels->end(), Level));
+				ImGui::Text("LOD %d: %d triangles, error %.2e, %d bunnies", Level, Chain->Levels[Level].NumTriangles, Chain->Levels[Level].Error, NumActors);
+			}
+			ImGui::End();
+		});
+
+		world.TickFunction = [Camera, Chain, Bunnies, Levels, MaxPixelError](double, World&) {
+			FVector Eye = Camera->GetTranslation();
+			for (int i = 0; i < static_cast<int>(Bunnies->size()); i++)
+			{
+				const auto& Actor = (*Bunnies)[i];
+				double		Distance = (Actor->GetTranslation() - Eye).norm();
+				int			Level = Chain->SelectLevel(FMeshLODChain::PixelsPerUnit(Distance, ScreenPixels, FovRadians), *MaxPixelError);
+				// Swap the mesh only when the level changes
+				if (Level != (*Levels)[i])
+				{
+					(*Levels)[i] = Level;
+					Actor->GetStaticMeshComponent()->SetMeshData(Chain->Levels[Level].Mesh);
+				}
+			}
+		};
+	};
+}
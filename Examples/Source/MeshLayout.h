@@ -0,0 +1,320 @@
+#pragma once
+#include <array>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include "CoreMinimal.h"
+#include "MeshBuffers.h"
+#include "Misc/Path.h"
+
+/**
+ * Memory layout of a triangle mesh for the GPU and CPU traversals.
+ * Triangles are reordered for the post-transform vertex cache (Forsyth's linear-speed vertex cache optimization),
+ * then vertices are renumbered in the order the triangles first use them, so vertex fetches walk the buffer forward.
+ * Both only permute the buffers, the surface is unchanged.
+ */
+namespace MeshLayout
+{
+	constexpr int CacheSize = 32;
+
+	// Score of a vertex by its position in the simulated LRU cache and its number of triangles left to draw
+	inline float VertexScore(int CachePosition, int RemainingTriangles)
+	{
+		if (RemainingTriangles == 0)
+			return -1.f;
+		float Score = 0.f;
+		if (CachePosition >= 0)
+		{
+			// The last triangle's vertices get a fixed score, so the next triangle does not just reuse them
+			if (CachePosition < 3)
+				Score = 0.75f;
+			else
+				Score = std::pow(1.f - static_cast<float>(CachePosition - 3) / (CacheSize - 3), 1.5f);
+		}
+		// Favor vertices with few triangles left, so they leave the cache for good
+		return Score + 2.f / std::sqrt(static_cast<float>(RemainingTriangles));
+	}
+
+	// Reorder the triangles of Mesh for the post-transform vertex cache
+	inline void OptimizeVertexCache(FMeshBuffers& Mesh)
+	{
+		int NumVertices = Mesh.NumVertices(), NumTriangles = Mesh.NumTriangles();
+		if (NumTriangles == 0)
+			return;
+
+		// Triangles of each vertex, the first Remaining[Vertex] entries are the ones not drawn yet
+		TArray<int> Offsets(NumVertices + 1, 0), Remaining(NumVertices, 0), VertexTriangles(NumTriangles * 3);
+		for (const Vector3i& Triangle : Mesh.Triangles)
+			for (int Corner = 0; Corner < 3; Corner++)
+				Offsets[Triangle[Corner] + 1]++;
+		for (int Vertex = 0; Vertex < NumVertices; Vertex++)
+			Offsets[Vertex + 1] += Offsets[Vertex];
+		for (int Triangle = 0; Triangle < NumTriangles; Triangle++)
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				int Vertex = Mesh.Triangles[Triangle][Corner];
+				VertexTriangles[Offsets[Vertex] + Remaining[Vertex]++] = Triangle;
+			}
+
+		TArray<float>	VertexScores(NumVertices), TriangleScores(NumTriangles, 0.f);
+		TArray<int>		CachePositions(NumVertices, -1);
+		TArray<uint8_t> Emitted(NumTriangles, 0);
+		for (int Vertex = 0; Vertex < NumVertices; Vertex++)
+			VertexScores[Vertex] = VertexScore(-1, Remaining[Vertex]);
+		int Best = 0;
+		for (int Triangle = 0; Triangle < NumTriangles; Triangle++)
+		{
+			for (int Corner = 0; Corner < 3; Corner++)
+				TriangleScores[Triangle] += VertexScores[Mesh.Triangles[Triangle][Corner]];
+			if (TriangleScores[Triangle] > TriangleScores[Best])
+				Best = Triangle;
+		}
+
+		TArray<Vector3i> Result;
+		Result.reserve(NumTriangles);
+		TArray<int> Cache, NextCache;
+		int			NextUnemitted = 0;
+		while (static_cast<int>(Result.size()) < NumTriangles)
+		{
+			// Nothing in the cache has triangles left, continue with the next triangle in the input order
+			if (Best < 0)
+			{
+				while (Emitted[NextUnemitted])
+					NextUnemitted++;
+				Best = NextUnemitted;
+			}
+			const Vector3i& Triangle = Mesh.Triangles[Best];
+			Result.push_back(Triangle);
+			Emitted[Best] = 1;
+
+			NextCache.assign(Triangle.data(), Triangle.data() + 3);
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				int	 Vertex = Triangle[Corner];
+				int* Begin = VertexTriangles.data() + Offsets[Vertex];
+				std::swap(*std::find(Begin, Begin + Remaining[Vertex], Best), Begin[Remaining[Vertex] - 1]);
+				Remaining[Vertex]--;
+			}
+			for (int Vertex : Cache)
+				if (Vertex != Triangle[0] && Vertex != Triangle[1] && Vertex != Triangle[2])
+					NextCache.push_back(Vertex);
+			std::swap(Cache, NextCache);
+
+			// Rescore the cached vertices and the evicted ones, and their triangles
+			for (int i = 0; i < static_cast<int>(Cache.size()); i++)
+			{
+				int Vertex = Cache[i];
+				CachePositions[Vertex] = i < CacheSize ? i : -1;
+				float Delta = VertexScore(CachePositions[Vertex], Remaining[Vertex]) - VertexScores[Vertex];
+				VertexScores[Vertex] += Delta;
+				for (int j = Offsets[Vertex]; j < Offsets[Vertex] + Remaining[Vertex]; j++)
+					TriangleScores[VertexTriangles[j]] += Delta;
+			}
+			if (static_cast<int>(Cache.size()) > CacheSize)
+				Cache.resize(CacheSize);
+
+			Best = -1;
+			float BestScore = -std::numeric_limits<float>::max();
+			for (int Vertex : Cache)
+				for (int j = Offsets[Vertex]; j < Offsets[Vertex] + Remaining[Vertex]; j++)
+					if (TriangleScores[VertexTriangles[j]] > BestScore)
+					{
+						Best = VertexTriangles[j];
+						BestScore = TriangleScores[Best];
+					}
+		}
+		Mesh.Triangles = std::move(Result);
+	}
+
+	// Move the per vertex values of Attribute to their new index, Remap as returned by OptimizeVertexFetch
+	template <class T>
+	void RemapVertexAttribute(TArray<T>& Attribute, const TArray<int>& Remap)
+	{
+		TArray<T> Remapped(Attribute.size());
+		for (size_t Vertex = 0; Vertex < Attribute.size(); Vertex++)
+			Remapped[Remap[Vertex]] = std::move(Attribute[Vertex]);
+		Attribute = std::move(Remapped);
+	}
+
+	/**
+	 * Renumber the vertices in the order of their first use by the triangles, unused vertices go last.
+	 * Per vertex attributes kept outside of Mesh (UVs, colors, normals...) are passed along and renumbered the same way.
+	 * Returns the new index of each old vertex
+	 */
+	template <class... AttributeTs>
+	TArray<int> OptimizeVertexFetch(FMeshBuffers& Mesh, TArray<AttributeTs>&... Attributes)
+	{
+		TArray<int> Remap(Mesh.NumVertices(), -1);
+		int			NumUsed = 0;
+		for (Vector3i& Triangle : Mesh.Triangles)
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				int& NewIndex = Remap[Triangle[Corner]];
+				if (NewIndex < 0)
+					NewIndex = NumUsed++;
+				Triangle[Corner] = NewIndex;
+			}
+		for (int& NewIndex : Remap)
+			if (NewIndex < 0)
+				NewIndex = NumUsed++;
+
+		RemapVertexAttribute(Mesh.Vertices, Remap);
+		([&] {
+			ASSERT(Attributes.size() == Remap.size());
+			RemapVertexAttribute(Attributes, Remap);
+		}(), ...);
+		return Remap;
+	}
+
+	// Both passes, with the per vertex attributes of Mesh if any. Used by MeshLayoutCache and the LOD levels
+	template <class... AttributeTs>
+	void Optimize(FMeshBuffers& Mesh, TArray<AttributeTs>&... Attributes)
+	{
+		OptimizeVertexCache(Mesh);
+		OptimizeVertexFetch(Mesh, Attributes...);
+	}
+
+	struct FCacheStats
+	{
+		double ACMR = 0.; // Average cache miss ratio, transformed vertices per triangle, 0.5 at best on large meshes
+		double ATVR = 0.; // Average transformed to vertex ratio, 1 at best
+	};
+
+	// Post-transform cache misses of drawing Mesh with a FIFO cache of CacheEntries vertices, as on most GPUs
+	inline FCacheStats AnalyzeVertexCache(const FMeshBuffers& Mesh, int CacheEntries = 16)
+	{
+		FCacheStats Result;
+		if (Mesh.NumTriangles() == 0)
+			return Result;
+		TArray<int> Timestamps(Mesh.NumVertices(), -CacheEntries - 1);
+		int			Misses = 0;
+		for (const Vector3i& Triangle : Mesh.Triangles)
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				// A FIFO entry is evicted CacheEntries misses after it was loaded, hits do not refresh it
+				if (Misses - Timestamps[Triangle[Corner]] > CacheEntries)
+					Timestamps[Triangle[Corner]] = ++Misses;
+			}
+		Result.ACMR = static_cast<double>(Misses) / Mesh.NumTriangles();
+		Result.ATVR = static_cast<double>(Misses) / Mesh.NumVertices();
+		return Result;
+	}
+} // namespace MeshLayout
+
+/**
+ * Vertex positions quantized to 16 bits per axis over the mesh bounds, a quarter of the size of the double positions.
+ * The error is at most half a step, GetMaxError.
+ */
+struct FQuantizedPositions
+{
+	FVector								 Min = FVector::Zero();
+	FVector								 Step = FVector::Zero();
+	TArray<std::array<uint16_t, 3>> Positions;
+
+	static FQuantizedPositions Encode(const TArray<FVector>& Vertices)
+	{
+		FQuantizedPositions Result;
+		if (Vertices.empty())
+			return Result;
+		AlignedBox3d Bounds;
+		for (const FVector& Vertex : Vertices)
+			Bounds.extend(Vertex);
+		Result.Min = Bounds.min();
+		Result.Step = Bounds.sizes() / 65535.;
+		Result.Positions.reserve(Vertices.size());
+		for (const FVector& Vertex : Vertices)
+		{
+			FVector Scaled = (Vertex - Result.Min).cwiseQuotient(Result.Step.cwiseMax(1e-300)).array().round().min(65535.).matrix();
+			Result.Positions.push_back({ static_cast<uint16_t>(Scaled.x()), static_cast<uint16_t>(Scaled.y()), static_cast<uint16_t>(Scaled.z()) });
+		}
+		return Result;
+	}
+
+	[[nodiscard]] FVector Decode(int Vertex) const
+	{
+		const auto& Position = Positions[Vertex];
+		return Min + FVector(Position[0], Position[1], Position[2]).cwiseProduct(Step);
+	}
+
+	[[nodiscard]] double GetMaxError() const { return Step.norm() * 0.5; }
+};
+
+/**
+ * Meshes loaded from the content folder with an optimized layout, loaded and optimized once per file
+ * until the file changes. Game thread only, loading and Load's result are StaticMesh objects.
+ * Each Load returns a new mesh built from the cached buffers, so callers can edit it (e.g. Normalize) without
+ * affecting the others. The buffers only hold positions and triangles: files with texture coordinates or normals
+ * would lose them, so they are loaded as they are, without the layout pass.
+ * Usage:
+ *	auto Bunny = MeshLayoutCache::Get().Load(Path("stanford-bunny.obj"));
+ */
+class MeshLayoutCache
+{
+public:
+	static MeshLayoutCache& Get()
+	{
+		static MeshLayoutCache Instance;
+		return Instance;
+	}
+
+	ObjectPtr<StaticMesh> Load(const Path& File)
+	{
+		std::error_code				  Error;
+		std::filesystem::file_time_type WriteTime = std::filesystem::last_write_time(File, Error);
+		std::shared_ptr<const FEntry>	Entry;
+		{
+			std::lock_guard Lock(Mutex);
+			auto			It = Entries.find(File.string());
+			if (It != Entries.end() && It->second->WriteTime == WriteTime)
+				Entry = It->second;
+		}
+
+		if (!Entry)
+		{
+			auto Source = StaticMesh::LoadObj(File);
+			if (!Source)
+			{
+				LOG_ERROR("Failed to load mesh: {}", File.string());
+				return nullptr;
+			}
+			if (HasVertexAttributes(File))
+			{
+				LOG_WARNING("{} has texture coordinates or normals, loaded without the layout pass", File.string());
+				return Source;
+			}
+			auto Optimized = std::make_shared<FEntry>(FEntry{ FMeshBuffers::FromStaticMesh(*Source), Source->GetMaterial(), WriteTime });
+			MeshLayout::Optimize(Optimized->Buffers);
+			Entry = Optimized;
+
+			std::lock_guard Lock(Mutex);
+			Entries[File.string()] = Entry;
+		}
+		auto Mesh = Entry->Buffers.ToStaticMesh();
+		Mesh->SetMaterial(Entry->SourceMaterial);
+		return Mesh;
+	}
+
+protected:
+	// Whether the OBJ file has "vt" or "vn" lines
+	static bool HasVertexAttributes(const Path& File)
+	{
+		std::ifstream InFile(File);
+		String		  Line;
+		while (std::getline(InFile, Line))
+			if (Line.size() > 2 && Line[0] == 'v' && (Line[1] == 't' || Line[1] == 'n') && std::isspace(static_cast<unsigned char>(Line[2])))
+				return true;
+		return false;
+	}
+
+	struct FEntry
+	{
+		FMeshBuffers					Buffers;
+		ObjectPtr<Material>				SourceMaterial; // Shared by the copies, like the levels of a LOD chain
+		std::filesystem::file_time_type WriteTime;
+	};
+
+	std::mutex												  Mutex;
+	std::unordered_map<String, std::shared_ptr<const FEntry>> Entries;
+};
@@ -0,0 +1,188 @@
+#pragma once
+#include <span>
+#include "CoreMinimal.h"
+#include "JobSystem.h"
+#include "MeshBuffers.h"
+#include "MeshCache.h"
+#include "ReflectionTable.h"
+
+/**
+ * Faces around each vertex in compressed rows: the faces of vertex V are Faces[Offsets[V]] to Faces[Offsets[V + 1]].
+ * Lets the per vertex kernels gather from the faces instead of scattering into the vertices, so they run in parallel without atomics.
+ */
+struct FMeshAdjacency
+{
+	TArray<int>		Offsets;
+	TArray<int>		Faces;
+	TArray<uint8_t> Corners; // Corner of the vertex in each face
+
+	[[nodiscard]] int NumVertices() const { return static_cast<int>(Offsets.size()) - 1; }
+
+	[[nodiscard]] std::span<const int> FacesOf(int Vertex) const
+	{
+		return { Faces.data() + Offsets[Vertex], Faces.data() + Offsets[Vertex + 1] };
+	}
+
+	// Hash of the triangle indices, changes with the topology only
+	static uint64_t HashTopology(const TArray<Vector3i>& Triangles, int NumVertices)
+	{
+		uint64_t Result = ReflectionTable::Hash(std::string_view(reinterpret_cast<const char*>(Triangles.data()), Triangles.size() * sizeof(Vector3i)));
+		return ReflectionTable::Hash(std::string_view(reinterpret_cast<const char*>(&Result), sizeof(Result)), NumVertices);
+	}
+
+	static FMeshAdjacency Build(const TArray<Vector3i>& Triangles, int NumVertices)
+	{
+		FMeshAdjacency Result;
+		Result.Offsets.assign(NumVertices + 1, 0);
+		for (const Vector3i& Triangle : Triangles)
+			for (int Corner = 0; Corner < 3; Corner++)
+				Result.Offsets[Triangle[Corner] + 1]++;
+		for (int Vertex = 0; Vertex < NumVertices; Vertex++)
+			Result.Offsets[Vertex + 1] += Result.Offsets[Vertex];
+
+		// Faces in increasing order around each vertex, so the sums below do not depend on the thread count
+		TArray<int> Fill(Result.Offsets.begin(), Result.Offsets.end() - 1);
+		Result.Faces.resize(Triangles.size() * 3);
+		Result.Corners.resize(Triangles.size() * 3);
+		for (int Face = 0; Face < static_cast<int>(Triangles.size()); Face++)
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				int Index = Fill[Triangles[Face][Corner]]++;
+				Result.Faces[Index] = Face;
+				Result.Corners[Index] = static_cast<uint8_t>(Corner);
+			}
+		return Result;
+	}
+};
+
+/**
+ * Vertex to face adjacency cached per StaticMesh, built on first use and rebuilt only when the mesh topology changes,
+ * so deforming a mesh every frame reuses it. Safe to call from several threads.
+ * Usage:
+ *	auto Adjacency = MeshAdjacencyCache::Get().Find(Mesh, Buffers);
+ */
+class MeshAdjacencyCache
+{
+public:
+	static MeshAdjacencyCache& Get()
+	{
+		static MeshAdjacencyCache Instance;
+		return Instance;
+	}
+
+	// Buffers are the current buffers of Mesh, as given by FMeshBuffers::FromStaticMesh
+	std::shared_ptr<const FMeshAdjacency> Find(const ObjectPtr<StaticMesh>& Mesh, const FMeshBuffers& Buffers)
+	{
+		return Adjacencies.Find(Mesh, FMeshAdjacency::HashTopology(Buffers.Triangles, Buffers.NumVertices()),
+			[&] { return FMeshAdjacency::Build(Buffers.Triangles, Buffers.NumVertices()); });
+	}
+
+protected:
+	TMeshCache<FMeshAdjacency> Adjacencies;
+};
+
+/**
+ * Face, vertex and corner normals of a triangle mesh, computed in parallel on the JobSystem.
+ * Vertex normals are the area weighted average of the face normals, gathered over the adjacency.
+ * After a deformation Update recomputes only the faces around the moved vertices and the vertices of those faces.
+ * Usage:
+ *	MeshNormals Normals(Adjacency, Buffers.Triangles);
+ *	Normals.Compute(Buffers.Vertices);
+ *	... move some vertices ...
+ *	Normals.Update(Buffers.Vertices, MovedVertices);
+ *	Buffers.Vertices[i] += Normals.GetVertexNormals()[i] * Offset;
+ */
+class MeshNormals
+{
+public:
+	static constexpr int Grain = 1024;
+
+	MeshNormals(std::shared_ptr<const FMeshAdjacency> InAdjacency, TArray<Vector3i> InTriangles)
+		: Adjacency(std::move(InAdjacency)), Triangles(std::move(InTriangles)), AreaNormals(Triangles.size()), VertexNormals(Adjacency->NumVertices()),
+		  FaceStamps(Triangles.size(), 0), VertexStamps(Adjacency->NumVertices(), 0)
+	{
+	}
+
+	void Compute(const TArray<FVector>& Vertices, JobSystem& Jobs = JobSystem::Get())
+	{
+		Jobs.ParallelFor(static_cast<int>(Triangles.size()), [&](int Face) { UpdateFace(Vertices, Face); }, Grain);
+		Jobs.ParallelFor(static_cast<int>(VertexNormals.size()), [&](int Vertex) { UpdateVertex(Vertex); }, Grain);
+	}
+
+	// Recompute the normals affected by moving MovedVertices to their new position in Vertices
+	void Update(const TArray<FVector>& Vertices, std::span<const int> MovedVertices, JobSystem& Jobs = JobSystem::Get())
+	{
+		// Stamps rather than sets, a stamp array is reset for free by incrementing the stamp
+		Stamp++;
+		DirtyFaces.clear();
+		DirtyVertices.clear();
+		for (int Vertex : MovedVertices)
+			for (int Face : Adjacency->FacesOf(Vertex))
+				if (FaceStamps[Face] != Stamp)
+				{
+					FaceStamps[Face] = Stamp;
+					DirtyFaces.push_back(Face);
+				}
+		for (int Face : DirtyFaces)
+			for (int Corner = 0; Corner < 3; Corner++)
+				if (int Vertex = Triangles[Face][Corner]; VertexStamps[Vertex] != Stamp)
+				{
+					VertexStamps[Vertex] = Stamp;
+					DirtyVertices.push_back(Vertex);
+				}
+
+		Jobs.ParallelFor(static_cast<int>(DirtyFaces.size()), [&](int i) { UpdateFace(Vertices, DirtyFaces[i]); }, Grain);
+		Jobs.ParallelFor(static_cast<int>(DirtyVertices.size()), [&](int i) { UpdateVertex(DirtyVertices[i]); }, Grain);
+	}
+
+	[[nodiscard]] FVector GetFaceNormal(int Face) const { return AreaNormals[Face].normalized(); }
+	[[nodiscard]] const TArray<FVector>& GetVertexNormals() const { return VertexNormals; }
+
+	/**
+	 * Normal of each face corner, Result[Face * 3 + Corner]: the average of the faces around the corner's vertex
+	 * that meet the face at less than CreaseAngle (radians), so sharp edges stay sharp and smooth areas are smooth.
+	 */
+	[[nodiscard]] TArray<FVector> ComputeCornerNormals(double CreaseAngle, JobSystem& Jobs = JobSystem::Get()) const
+	{
+		TArray<FVector> Result(Triangles.size() * 3);
+		double			CosCrease = std::cos(CreaseAngle);
+		Jobs.ParallelFor(static_cast<int>(VertexNormals.size()), [&](int Vertex) {
+			auto Faces = Adjacency->FacesOf(Vertex);
+			for (int i = 0; i < static_cast<int>(Faces.size()); i++)
+			{
+				FVector FaceNormal = AreaNormals[Faces[i]].normalized();
+				FVector Sum = FVector::Zero();
+				for (int Other : Faces)
+					if (AreaNormals[Other].normalized().dot(FaceNormal) >= CosCrease)
+						Sum += AreaNormals[Other];
+				// Each corner belongs to one vertex, so the writes do not overlap
+				Result[Faces[i] * 3 + Adjacency->Corners[Adjacency->Offsets[Vertex] + i]] = Sum.normalized();
+			}
+		}, Grain);
+		return Result;
+	}
+
+protected:
+	std::shared_ptr<const FMeshAdjacency> Adjacency;
+	TArray<Vector3i>					  Triangles;
+	TArray<FVector>						  AreaNormals; // Cross product of the edges, twice the area long
+	TArray<FVector>						  VertexNormals;
+	TArray<uint32_t>					  FaceStamps, VertexStamps;
+	TArray<int>							  DirtyFaces, DirtyVertices;
+	uint32_t							  Stamp = 0;
+
+	void UpdateFace(const TArray<FVector>& Vertices, int Face)
+	{
+		const Vector3i& Triangle = Triangles[Face];
+		const FVector&	V0 = Vertices[Triangle[0]];
+		AreaNormals[Face] = (Vertices[Triangle[1]] - V0).cross(Vertices[Triangle[2]] - V0);
+	}
+
+	void UpdateVertex(int Vertex)
+	{
+		FVector Sum = FVector::Zero();
+		for (int Face : Adjacency->FacesOf(Vertex))
+			Sum += AreaNormals[Face];
+		VertexNormals[Vertex] = Sum.normalized();
+	}
+};
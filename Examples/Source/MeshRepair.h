@@ -0,0 +1,550 @@
+#pragma once
+#include <algorithm>
+#include <unordered_map>
+#include "CoreMinimal.h"
+#include "CpuBVH.h"
+#include "JobSystem.h"
+#include "MeshBuffers.h"
+#include "MeshCache.h"
+#include "TriangleIntersection.h"
+
+struct FMeshRepairSettings
+{
+	double WeldTolerance = 1e-6;		  // Relative to the diagonal of the mesh bounds
+	int	   MaxFilledHoleEdges = 0;		  // Holes of the input up to this many edges are filled, 0 keeps them open
+	bool   bResolveSelfIntersections = true;
+	int	   MaxResolveRounds = 4;
+
+	bool operator==(const FMeshRepairSettings& Other) const = default;
+};
+
+struct FMeshRepairReport
+{
+	int	 NumWeldedVertices = 0;
+	int	 NumDegenerateFaces = 0;
+	int	 NumDuplicateFaces = 0;
+	int	 NumHoles = 0;
+	int	 NumFilledHoles = 0;
+	int	 NumSelfIntersections = 0;		   // Intersecting triangle pairs of the input
+	int	 NumRemovedIntersectingFaces = 0;
+	int	 NumRemainingSelfIntersections = 0;
+	int	 NumShellIntersections = 0; // Pairs in separate connected shells, left for MeshBoolean::MeshUnion
+	int	 NumNonManifoldEdges = 0;
+	bool bClosed = false;
+
+	// Manifold and free of self intersections, and closed if the consumer needs it: booleans do, parametrization takes open patches
+	[[nodiscard]] bool IsClean(bool bRequireClosed) const
+	{
+		return (bClosed || !bRequireClosed) && NumNonManifoldEdges == 0 && NumRemainingSelfIntersections == 0 && NumShellIntersections == 0;
+	}
+};
+
+/**
+ * Repair stages for meshes from scans or files, each usable on its own:
+ * weld vertices closer than a tolerance, remove degenerate and duplicate faces, find holes (and fill the small ones),
+ * and resolve self intersections by cutting out the intersecting faces and closing the cut.
+ * The cut and cap is a crude fallback, not a remesh: it removes geometry around the intersections and closes the cuts with fans,
+ * which can leave dents, and a cap of a non planar cut can fold over and be cut again. Check the report before trusting the result.
+ * The per vertex and per face work runs in parallel on the JobSystem.
+ */
+namespace MeshRepair
+{
+	// Merge the vertices closer than Tolerance into the one with the smallest index, return the number of vertices removed
+	inline int WeldVertices(FMeshBuffers& Mesh, double Tolerance, JobSystem& Jobs = JobSystem::Get())
+	{
+		int NumVertices = Mesh.NumVertices();
+		if (NumVertices == 0)
+			return 0;
+		AlignedBox3d Bounds;
+		for (const FVector& Vertex : Mesh.Vertices)
+			Bounds.extend(Vertex);
+
+		// Spatial hash: cells at least Tolerance wide, 21 bits per axis packed in the key, so neighbors are within the 27 cells around
+		double	  CellSize = std::max({ Tolerance, Bounds.sizes().maxCoeff() / ((1 << 20) - 1), 1e-300 });
+		auto	  CellOf = [&](const FVector& Position) { return ((Position - Bounds.min()) / CellSize).cast<int64_t>().eval(); };
+		auto	  KeyOf = [](const Eigen::Matrix<int64_t, 3, 1>& Cell) { return static_cast<uint64_t>(Cell.x()) << 42 | static_cast<uint64_t>(Cell.y()) << 21 | static_cast<uint64_t>(Cell.z()); };
+		TArray<std::pair<uint64_t, int>> Keys(NumVertices);
+		Jobs.ParallelFor(NumVertices, [&](int Vertex) { Keys[Vertex] = { KeyOf(CellOf(Mesh.Vertices[Vertex])), Vertex }; }, 4096);
+		std::sort(Keys.begin(), Keys.end());
+
+		// Each vertex points to the smallest vertex within Tolerance, then the chains are followed in increasing order
+		TArray<int> Representative(NumVertices);
+		Jobs.ParallelFor(NumVertices, [&](int Vertex) {
+			auto Cell = CellOf(Mesh.Vertices[Vertex]);
+			int	 Smallest = Vertex;
+			for (int Neighbor = 0; Neighbor < 27; Neighbor++)
+			{
+				Eigen::Matrix<int64_t, 3, 1> Offset(Neighbor % 3 - 1, Neighbor / 3 % 3 - 1, Neighbor / 9 - 1);
+				auto						 Other = (Cell + Offset).eval();
+				if ((Other.array() < 0).any())
+					continue;
+				auto It = std::lower_bound(Keys.begin(), Keys.end(), std::pair<uint64_t, int>(KeyOf(Other), 0));
+				for (; It != Keys.end() && It->first == KeyOf(Other); ++It)
+					if (It->second < Smallest && (Mesh.Vertices[It->second] - Mesh.Vertices[Vertex]).norm() <= Tolerance)
+						Smallest = It->second;
+			}
+			Representative[Vertex] = Smallest;
+		}, 1024);
+
+		TArray<int>		NewIndices(NumVertices);
+		TArray<FVector> Vertices;
+		for (int Vertex = 0; Vertex < NumVertices; Vertex++)
+		{
+			Representative[Vertex] = Representative[Representative[Vertex]];
+			if (Representative[Vertex] == Vertex)
+			{
+				NewIndices[Vertex] = static_cast<int>(Vertices.size());
+				Vertices.push_back(Mesh.Vertices[Vertex]);
+			}
+			else
+				NewIndices[Vertex] = NewIndices[Representative[Vertex]];
+		}
+		for (Vector3i& Triangle : Mesh.Triangles)
+			for (int Corner = 0; Corner < 3; Corner++)
+				Triangle[Corner] = NewIndices[Triangle[Corner]];
+		int NumWelded = NumVertices - static_cast<int>(Vertices.size());
+		Mesh.Vertices = std::move(Vertices);
+		return NumWelded;
+	}
+
+	/**
+	 * Remove the faces with a repeated vertex or with no area (AreaTolerance, relative to the squared bounds diagonal),
+	 * and the faces on the same three vertices as an earlier face
+	 */
+	inline void RemoveDegenerateFaces(FMeshBuffers& Mesh, double AreaTolerance, int& OutNumDegenerate, int& OutNumDuplicate, JobSystem& Jobs = JobSystem::Get())
+	{
+		AlignedBox3d Bounds;
+		for (const FVector& Vertex : Mesh.Vertices)
+			Bounds.extend(Vertex);
+		double MinDoubleArea = 2. * AreaTolerance * Bounds.diagonal().squaredNorm();
+
+		int				 NumTriangles = Mesh.NumTriangles();
+		TArray<uint8_t>	 Degenerate(NumTriangles);
+		TArray<std::pair<Vector3i, int>> Sorted(NumTriangles);
+		Jobs.ParallelFor(NumTriangles, [&](int Face) {
+			const Vector3i& Triangle = Mesh.Triangles[Face];
+			FVector			V0 = Mesh.Vertices[Triangle[0]];
+			Degenerate[Face] = Triangle[0] == Triangle[1] || Triangle[1] == Triangle[2] || Triangle[2] == Triangle[0]
+				|| (Mesh.Vertices[Triangle[1]] - V0).cross(Mesh.Vertices[Triangle[2]] - V0).norm() <= MinDoubleArea;
+			Vector3i Key = Triangle;
+			std::sort(Key.data(), Key.data() + 3);
+			Sorted[Face] = { Key, Face };
+		}, 4096);
+
+		auto Less = [](const std::pair<Vector3i, int>& A, const std::pair<Vector3i, int>& B) {
+			return std::lexicographical_compare(A.first.data(), A.first.data() + 3, B.first.data(), B.first.data() + 3) || (A.first == B.first && A.second < B.second);
+		};
+		std::sort(Sorted.begin(), Sorted.end(), Less);
+		TArray<uint8_t> Duplicate(NumTriangles, 0);
+		for (int i = 1; i < NumTriangles; i++)
+			Duplicate[Sorted[i].second] = Sorted[i].first == Sorted[i - 1].first;
+
+		OutNumDegenerate = OutNumDuplicate = 0;
+		TArray<Vector3i> Triangles;
+		for (int Face = 0; Face < NumTriangles; Face++)
+		{
+			OutNumDegenerate += Degenerate[Face];
+			OutNumDuplicate += !Degenerate[Face] && Duplicate[Face];
+			if (!Degenerate[Face] && !Duplicate[Face])
+				Triangles.push_back(Mesh.Triangles[Face]);
+		}
+		Mesh.Triangles = std::move(Triangles);
+	}
+
+	inline void RemoveUnreferencedVertices(FMeshBuffers& Mesh)
+	{
+		TArray<int> NewIndices(Mesh.NumVertices(), -1);
+		for (const Vector3i& Triangle : Mesh.Triangles)
+			for (int Corner = 0; Corner < 3; Corner++)
+				NewIndices[Triangle[Corner]] = 0;
+		TArray<FVector> Vertices;
+		for (int Vertex = 0; Vertex < Mesh.NumVertices(); Vertex++)
+			if (NewIndices[Vertex] == 0)
+			{
+				NewIndices[Vertex] = static_cast<int>(Vertices.size());
+				Vertices.push_back(Mesh.Vertices[Vertex]);
+			}
+		for (Vector3i& Triangle : Mesh.Triangles)
+			for (int Corner = 0; Corner < 3; Corner++)
+				Triangle[Corner] = NewIndices[Triangle[Corner]];
+		Mesh.Vertices = std::move(Vertices);
+	}
+
+	inline uint64_t EdgeKey(int From, int To) { return static_cast<uint64_t>(From) << 32 | static_cast<uint32_t>(To); }
+
+	/**
+	 * Boundary loops: the half edges without an opposite half edge, chained head to tail.
+	 * Each loop runs along the faces' orientation, so a cap has to use its edges reversed.
+	 * A vertex where the boundary touches itself splits the walk into separate loops. Chains that do not close, where faces
+	 * disagree on orientation, are not holes and are left out, their edges are counted as non manifold.
+	 */
+	inline TArray<TArray<int>> FindHoles(const FMeshBuffers& Mesh, int* OutNumNonManifoldEdges = nullptr)
+	{
+		TArray<uint64_t> HalfEdges;
+		HalfEdges.reserve(Mesh.Triangles.size() * 3);
+		for (const Vector3i& Triangle : Mesh.Triangles)
+			for (int Corner = 0; Corner < 3; Corner++)
+				HalfEdges.push_back(EdgeKey(Triangle[Corner], Triangle[(Corner + 1) % 3]));
+		std::sort(HalfEdges.begin(), HalfEdges.end());
+
+		if (OutNumNonManifoldEdges)
+		{
+			// An undirected edge used by more than two faces, or twice in the same direction
+			TArray<uint64_t> Undirected(HalfEdges.size());
+			for (size_t i = 0; i < HalfEdges.size(); i++)
+			{
+				uint32_t From = HalfEdges[i] >> 32, To = HalfEdges[i] & 0xFFFFFFFFu;
+				Undirected[i] = EdgeKey(std::min(From, To), std::max(From, To));
+			}
+			std::sort(Undirected.begin(), Undirected.end());
+			*OutNumNonManifoldEdges = 0;
+			for (size_t Begin = 0, End = 0; Begin < Undirected.size(); Begin = End)
+			{
+				while (End < Undirected.size() && Undirected[End] == Undirected[Begin])
+					End++;
+				*OutNumNonManifoldEdges += End - Begin > 2;
+			}
+			for (size_t i = 1; i < HalfEdges.size(); i++)
+				*OutNumNonManifoldEdges += HalfEdges[i] == HalfEdges[i - 1];
+		}
+
+		std::unordered_multimap<int, int> Next;
+		for (uint64_t HalfEdge : HalfEdges)
+		{
+			int From = static_cast<int>(HalfEdge >> 32), To = static_cast<int>(HalfEdge & 0xFFFFFFFFu);
+			if (!std::binary_search(HalfEdges.begin(), HalfEdges.end(), EdgeKey(To, From)))
+				Next.emplace(From, To);
+		}
+		TArray<TArray<int>> Loops;
+		while (!Next.empty())
+		{
+			// Walk until a vertex of the chain comes again, the part from there closes a loop and the walk goes on from that vertex
+			TArray<int>					 Chain = { Next.begin()->first };
+			std::unordered_map<int, int> Position = { { Chain.front(), 0 } };
+			while (true)
+			{
+				auto It = Next.find(Chain.back());
+				if (It == Next.end())
+					break;
+				int To = It->second;
+				Next.erase(It);
+				if (auto Visited = Position.find(To); Visited != Position.end())
+				{
+					int Begin = Visited->second;
+					Loops.emplace_back(Chain.begin() + Begin, Chain.end());
+					for (size_t i = Begin + 1; i < Chain.size(); i++)
+						Position.erase(Chain[i]);
+					Chain.resize(Begin + 1);
+				}
+				else
+				{
+					Position[To] = static_cast<int>(Chain.size());
+					Chain.push_back(To);
+				}
+			}
+		}
+		return Loops;
+	}
+
+	// Faces on an edge used by more than two faces, or by two faces in the same direction
+	inline TArray<int> FindNonManifoldFaces(const FMeshBuffers& Mesh)
+	{
+		TArray<std::pair<uint64_t, int>> Edges;
+		for (int Face = 0; Face < Mesh.NumTriangles(); Face++)
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				int From = Mesh.Triangles[Face][Corner], To = Mesh.Triangles[Face][(Corner + 1) % 3];
+				// Direction in the lowest bit, so equal directions can be told apart in a group
+				Edges.emplace_back(EdgeKey(std::min(From, To), std::max(From, To)) << 1 | (From > To), Face);
+			}
+		std::sort(Edges.begin(), Edges.end());
+		TArray<int> Result;
+		for (size_t Begin = 0, End = 0; Begin < Edges.size(); Begin = End)
+		{
+			while (End < Edges.size() && Edges[End].first >> 1 == Edges[Begin].first >> 1)
+				End++;
+			bool bSameDirection = End - Begin == 2 && Edges[Begin].first == Edges[Begin + 1].first;
+			if (End - Begin > 2 || bSameDirection)
+				for (size_t i = Begin; i < End; i++)
+					Result.push_back(Edges[i].second);
+		}
+		return Result;
+	}
+
+	// Connected shell of each face, faces sharing a vertex are connected
+	inline TArray<int> FindShells(const FMeshBuffers& Mesh)
+	{
+		TArray<int> Parent(Mesh.NumVertices());
+		for (int Vertex = 0; Vertex < Mesh.NumVertices(); Vertex++)
+			Parent[Vertex] = Vertex;
+		auto Root = [&Parent](int Vertex) {
+			while (Parent[Vertex] != Vertex)
+				Vertex = Parent[Vertex] = Parent[Parent[Vertex]];
+			return Vertex;
+		};
+		for (const Vector3i& Triangle : Mesh.Triangles)
+			for (int Corner = 1; Corner < 3; Corner++)
+				Parent[Root(Triangle[Corner])] = Root(Triangle[0]);
+		TArray<int> Result(Mesh.NumTriangles());
+		for (int Face = 0; Face < Mesh.NumTriangles(); Face++)
+			Result[Face] = Root(Mesh.Triangles[Face][0]);
+		return Result;
+	}
+
+	// Close a hole with a fan around its centroid, a single triangle for three edges
+	inline void FillHole(FMeshBuffers& Mesh, const TArray<int>& Loop)
+	{
+		if (Loop.size() < 3)
+			return;
+		if (Loop.size() == 3)
+		{
+			Mesh.Triangles.emplace_back(Loop[2], Loop[1], Loop[0]);
+			return;
+		}
+		FVector Centroid = FVector::Zero();
+		for (int Vertex : Loop)
+			Centroid += Mesh.Vertices[Vertex];
+		int Center = Mesh.NumVertices();
+		Mesh.Vertices.push_back(Centroid / static_cast<double>(Loop.size()));
+		for (size_t i = 0; i < Loop.size(); i++)
+			Mesh.Triangles.emplace_back(Loop[(i + 1) % Loop.size()], Loop[i], Center);
+	}
+
+	// Whether a direction lies in the wedge between two edges leaving a vertex, all of unit length. Strict leaves out the edges
+	inline bool InWedge(const FVector& Direction, const FVector& Edge1, const FVector& Edge2, bool bStrict)
+	{
+		double E12 = Edge1.dot(Edge2), D1 = Edge1.dot(Direction), D2 = Edge2.dot(Direction);
+		double Determinant = 1. - E12 * E12;
+		if (Determinant <= 0.)
+			return false;
+		double A = (D1 - E12 * D2) / Determinant, B = (D2 - E12 * D1) / Determinant;
+		constexpr double Epsilon = 1e-12;
+		return bStrict ? A > Epsilon && B > Epsilon : A >= -Epsilon && B >= -Epsilon;
+	}
+
+	/**
+	 * Whether two faces sharing one or two vertices also meet away from them, a fold over between neighbors.
+	 * Faces on an edge only overlap when they are coplanar with the third vertices on the same side. Faces on a vertex meet
+	 * along the line where their planes cross, both have to extend from the vertex in the same direction along it.
+	 */
+	inline bool OverlapsBeyondShared(const FMeshBuffers& Mesh, const Vector3i& Triangle, const Vector3i& Other)
+	{
+		int SharedCorners[3], OwnCorners[3], OtherCorners[3];
+		int NumShared = 0, NumOwn = 0, NumOther = 0;
+		for (int Corner = 0; Corner < 3; Corner++)
+		{
+			if ((Other.array() == Triangle[Corner]).any())
+				SharedCorners[NumShared++] = Triangle[Corner];
+			else
+				OwnCorners[NumOwn++] = Triangle[Corner];
+			if (!(Triangle.array() == Other[Corner]).any())
+				OtherCorners[NumOther++] = Other[Corner];
+		}
+		if (NumShared == 3)
+			return true;
+
+		auto	Vertex = [&Mesh](int Index) -> const FVector& { return Mesh.Vertices[Index]; };
+		FVector Normal = (Vertex(Triangle[1]) - Vertex(Triangle[0])).cross(Vertex(Triangle[2]) - Vertex(Triangle[0]));
+		FVector OtherNormal = (Vertex(Other[1]) - Vertex(Other[0])).cross(Vertex(Other[2]) - Vertex(Other[0]));
+		double	Scale = Normal.norm() * OtherNormal.norm();
+		if (Scale == 0.)
+			return false; // Degenerate faces are removed by RemoveDegenerateFaces
+		FVector Crossing = Normal.cross(OtherNormal);
+		bool	bCoplanar = Crossing.norm() <= 1e-9 * Scale;
+
+		const FVector& Shared = Vertex(SharedCorners[0]);
+		if (NumShared == 2)
+		{
+			FVector Edge = Vertex(SharedCorners[1]) - Shared;
+			return bCoplanar && Edge.cross(Vertex(OwnCorners[0]) - Shared).dot(Edge.cross(Vertex(OtherCorners[0]) - Shared)) > 0.;
+		}
+
+		FVector Own1 = (Vertex(OwnCorners[0]) - Shared).normalized(), Own2 = (Vertex(OwnCorners[1]) - Shared).normalized();
+		FVector Other1 = (Vertex(OtherCorners[0]) - Shared).normalized(), Other2 = (Vertex(OtherCorners[1]) - Shared).normalized();
+		if (bCoplanar)
+		{
+			// Two wedges around the same vertex overlap when an edge of one is inside the other, or when they are the same
+			bool bSame = (Own1.cross(Other1).norm() <= 1e-12 && Own2.cross(Other2).norm() <= 1e-12 && Own1.dot(Other1) > 0. && Own2.dot(Other2) > 0.)
+				|| (Own1.cross(Other2).norm() <= 1e-12 && Own2.cross(Other1).norm() <= 1e-12 && Own1.dot(Other2) > 0. && Own2.dot(Other1) > 0.);
+			return bSame || InWedge(Other1, Own1, Own2, true) || InWedge(Other2, Own1, Own2, true)
+				|| InWedge(Own1, Other1, Other2, true) || InWedge(Own2, Other1, Other2, true);
+		}
+		FVector Direction = Crossing.normalized();
+		auto	Side = [&Direction](const FVector& Edge1, const FVector& Edge2) {
+			return InWedge(Direction, Edge1, Edge2, false) ? 1 : InWedge(-Direction, Edge1, Edge2, false) ? -1 : 0;
+		};
+		int OwnSide = Side(Own1, Own2);
+		return OwnSide != 0 && OwnSide == Side(Other1, Other2);
+	}
+
+	/**
+	 * Pairs of faces that intersect, found with a BVH over the faces and decided exactly by TriangleIntersection.
+	 * Faces sharing vertices always touch there, they are tested by OverlapsBeyondShared for fold overs instead.
+	 */
+	inline TArray<Vector2i> FindSelfIntersections(const FMeshBuffers& Mesh, JobSystem& Jobs = JobSystem::Get())
+	{
+		int					 NumTriangles = Mesh.NumTriangles();
+		TArray<AlignedBox3f> Bounds(NumTriangles);
+		Jobs.ParallelFor(NumTriangles, [&](int Face) {
+			AlignedBox3d Box;
+			for (int Corner = 0; Corner < 3; Corner++)
+				Box.extend(Mesh.Vertices[Mesh.Triangles[Face][Corner]]);
+			// Rounded outwards to float, so touching boxes still overlap
+			Vector3d Margin = Box.sizes() * 1e-6 + Box.min().cwiseAbs().cwiseMax(Box.max().cwiseAbs()) * 1e-6;
+			Bounds[Face] = AlignedBox3f((Box.min() - Margin).cast<float>(), (Box.max() + Margin).cast<float>());
+		}, 4096);
+		CpuBVH BVH;
+		BVH.Build(Bounds);
+
+		TArray<TArray<Vector2i>> FacePairs(NumTriangles), FoldedPairs(NumTriangles);
+		Jobs.ParallelFor(NumTriangles, [&](int Face) {
+			const Vector3i& Triangle = Mesh.Triangles[Face];
+			BVH.TraverseBox(Bounds[Face], [&](int Other) {
+				if (Other <= Face)
+					return;
+				const Vector3i& OtherTriangle = Mesh.Triangles[Other];
+				bool			bShared = false;
+				for (int Corner = 0; Corner < 3; Corner++)
+					bShared |= (OtherTriangle.array() == Triangle[Corner]).any();
+				if (!bShared)
+					FacePairs[Face].emplace_back(Face, Other);
+				else if (OverlapsBeyondShared(Mesh, Triangle, OtherTriangle))
+					FoldedPairs[Face].emplace_back(Face, Other);
+			});
+		}, 256);
+		TArray<Vector2i> Candidates;
+		for (const auto& Pairs : FacePairs)
+			Candidates.insert(Candidates.end(), Pairs.begin(), Pairs.end());
+
+		TArray<FTriangleIntersection> Intersections(Candidates.size());
+		TriangleIntersection::IntersectPairs(Mesh, Mesh, Candidates, Intersections, Jobs);
+		TArray<Vector2i> Result;
+		for (size_t i = 0; i < Candidates.size(); i++)
+			if (Intersections[i].Intersects())
+				Result.push_back(Candidates[i]);
+		for (const auto& Pairs : FoldedPairs)
+			Result.insert(Result.end(), Pairs.begin(), Pairs.end());
+		return Result;
+	}
+
+	// All the stages, in order
+	inline FMeshBuffers Repair(FMeshBuffers Mesh, const FMeshRepairSettings& Settings, FMeshRepairReport& OutReport, JobSystem& Jobs = JobSystem::Get())
+	{
+		OutReport = {};
+		AlignedBox3d Bounds;
+		for (const FVector& Vertex : Mesh.Vertices)
+			Bounds.extend(Vertex);
+		OutReport.NumWeldedVertices = WeldVertices(Mesh, Settings.WeldTolerance * Bounds.diagonal().norm(), Jobs);
+		RemoveDegenerateFaces(Mesh, 1e-16, OutReport.NumDegenerateFaces, OutReport.NumDuplicateFaces, Jobs);
+
+		TArray<TArray<int>> Holes = FindHoles(Mesh);
+		OutReport.NumHoles = static_cast<int>(Holes.size());
+		for (const auto& Hole : Holes)
+			if (static_cast<int>(Hole.size()) <= Settings.MaxFilledHoleEdges)
+			{
+				FillHole(Mesh, Hole);
+				OutReport.NumFilledHoles++;
+			}
+
+		if (Settings.bResolveSelfIntersections)
+		{
+			// The boundary left open on purpose, the caps of the cuts must not close it
+			TArray<uint64_t> OpenEdges;
+			for (const auto& Hole : FindHoles(Mesh))
+				for (size_t i = 0; i < Hole.size(); i++)
+					OpenEdges.push_back(EdgeKey(Hole[i], Hole[(i + 1) % Hole.size()]));
+			std::sort(OpenEdges.begin(), OpenEdges.end());
+
+			// Only the intersections within a shell are cut, two shells passing through each other need a union instead
+			auto FindShellSelfIntersections = [&Mesh, &Jobs, &OutReport]() {
+				TArray<Vector2i> Result;
+				TArray<int>		 Shells = FindShells(Mesh);
+				OutReport.NumShellIntersections = 0;
+				for (const Vector2i& Pair : FindSelfIntersections(Mesh, Jobs))
+				{
+					if (Shells[Pair.x()] == Shells[Pair.y()])
+						Result.push_back(Pair);
+					else
+						OutReport.NumShellIntersections++;
+				}
+				return Result;
+			};
+			TArray<Vector2i> Intersections = FindShellSelfIntersections();
+			OutReport.NumSelfIntersections = static_cast<int>(Intersections.size()) + OutReport.NumShellIntersections;
+			// The caps of cuts that meet at a vertex can share an edge, those faces are cut again in the next round
+			TArray<int> NonManifold;
+			for (int Round = 0; Round < Settings.MaxResolveRounds && (!Intersections.empty() || (Round > 0 && !NonManifold.empty())); Round++)
+			{
+				TArray<uint8_t> Removed(Mesh.NumTriangles(), 0);
+				for (const Vector2i& Pair : Intersections)
+					Removed[Pair.x()] = Removed[Pair.y()] = 1;
+				for (int Face : NonManifold)
+					Removed[Face] = 1;
+				TArray<Vector3i> Triangles;
+				for (int Face = 0; Face < Mesh.NumTriangles(); Face++)
+				{
+					if (Removed[Face])
+						OutReport.NumRemovedIntersectingFaces++;
+					else
+						Triangles.push_back(Mesh.Triangles[Face]);
+				}
+				Mesh.Triangles = std::move(Triangles);
+				for (const auto& Hole : FindHoles(Mesh))
+				{
+					bool bOpen = false;
+					for (size_t i = 0; i < Hole.size() && !bOpen; i++)
+						bOpen = std::binary_search(OpenEdges.begin(), OpenEdges.end(), EdgeKey(Hole[i], Hole[(i + 1) % Hole.size()]));
+					if (!bOpen)
+						FillHole(Mesh, Hole);
+				}
+				Intersections = FindShellSelfIntersections();
+				NonManifold = FindNonManifoldFaces(Mesh);
+			}
+			OutReport.NumRemainingSelfIntersections = static_cast<int>(Intersections.size());
+		}
+
+		RemoveUnreferencedVertices(Mesh);
+		OutReport.bClosed = FindHoles(Mesh, &OutReport.NumNonManifoldEdges).empty();
+		return Mesh;
+	}
+} // namespace MeshRepair
+
+/**
+ * Repaired meshes cached per StaticMesh and settings, repaired on first use and again only when the mesh geometry changes.
+ * Algorithms that need clean input can take the repaired mesh and check Report.IsClean(bRequireClosed) once instead of guarding every step.
+ * Game thread only, the repaired mesh is created as a StaticMesh.
+ * Usage:
+ *	auto Repaired = MeshRepairCache::Get().Find(Mesh);
+ *	if (Repaired->Report.IsClean(true)) MeshBoolean::MeshUnion(Repaired->Mesh, ...);
+ */
+class MeshRepairCache
+{
+public:
+	struct FRepaired
+	{
+		ObjectPtr<StaticMesh> Mesh;
+		FMeshRepairReport	  Report;
+	};
+
+	static MeshRepairCache& Get()
+	{
+		static MeshRepairCache Instance;
+		return Instance;
+	}
+
+	std::shared_ptr<const FRepaired> Find(const ObjectPtr<StaticMesh>& Mesh, const FMeshRepairSettings& Settings = {})
+	{
+		FMeshBuffers Buffers = FMeshBuffers::FromStaticMesh(*Mesh);
+		uint64_t	 GeometryHash = Buffers.HashGeometry();
+		return Repaired.Find(Mesh, { GeometryHash, Settings }, [&] {
+			FRepaired	 Result;
+			FMeshBuffers RepairedBuffers = MeshRepair::Repair(std::move(Buffers), Settings, Result.Report);
+			Result.Mesh = RepairedBuffers.ToStaticMesh();
+			Result.Mesh->SetMaterial(Mesh->GetMaterial());
+			return Result;
+		});
+	}
+
+protected:
+	TMeshCache<FRepaired, std::pair<uint64_t, FMeshRepairSettings>> Repaired;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "MeshBuffers.h"
+
+/**
+ * Basic shapes built directly as FMeshBuffers, centered on the origin like the ones of BasicShapesLibrary.
+ * They create no engine object, so the headless modes and the jobs can use them before or without the editor.
+ * Usage:
+ *	CpuScene Scene;
+ *	int Box = Scene.AddMesh(MeshShapes::GenerateCuboid(FVector{ 1., 1., 1. }));
+ */
+struct MeshShapes
+{
+	// Box of size Extents, 8 vertices shared by the faces
+	static FMeshBuffers GenerateCuboid(const FVector& Extents)
+	{
+		FMeshBuffers Result;
+		for (int Corner = 0; Corner < 8; Corner++)
+			Result.Vertices.emplace_back((Corner & 1 ? 0.5 : -0.5) * Extents.x(), (Corner & 2 ? 0.5 : -0.5) * Extents.y(), (Corner & 4 ? 0.5 : -0.5) * Extents.z());
+		Result.Triangles = {
+			{ 0, 2, 1 }, { 1, 2, 3 }, { 4, 5, 6 }, { 5, 7, 6 }, // -Z, +Z
+			{ 0, 1, 4 }, { 1, 5, 4 }, { 2, 6, 3 }, { 3, 6, 7 }, // -Y, +Y
+			{ 0, 4, 2 }, { 2, 4, 6 }, { 1, 3, 5 }, { 3, 7, 5 }	// -X, +X
+		};
+		return Result;
+	}
+
+	// UV sphere with Segments around the Z axis and Segments / 2 rings, one vertex at each pole
+	static FMeshBuffers GenerateSphere(double Radius, int Segments = 32)
+	{
+		Segments = std::max(Segments, 3);
+		int			 Rings = std::max(Segments / 2, 2);
+		FMeshBuffers Result;
+		Result.Vertices.emplace_back(0., 0., -Radius);
+		for (int Ring = 1; Ring < Rings; Ring++)
+		{
+			double Polar = M_PI * Ring / Rings;
+			for (int Segment = 0; Segment < Segments; Segment++)
+			{
+				double Azimuth = 2. * M_PI * Segment / Segments;
+				Result.Vertices.emplace_back(Radius * std::sin(Polar) * std::cos(Azimuth), Radius * std::sin(Polar) * std::sin(Azimuth), -Radius * std::cos(Polar));
+			}
+		}
+		Result.Vertices.emplace_back(0., 0., Radius);
+
+		int	 Top = Result.NumVertices() - 1;
+		auto Index = [Segments](int Ring, int Segment) { return 1 + (Ring - 1) * Segments + Segment % Segments; };
+		for (int Segment = 0; Segment < Segments; Segment++)
+		{
+			Result.Triangles.emplace_back(0, Index(1, Segment + 1), Index(1, Segment));
+			for (int Ring = 1; Ring + 1 < Rings; Ring++)
+			{
+				Result.Triangles.emplace_back(Index(Ring, Segment), Index(Ring, Segment + 1), Index(Ring + 1, Segment + 1));
+				Result.Triangles.emplace_back(Index(Ring, Segment), Index(Ring + 1, Segment + 1), Index(Ring + 1, Segment));
+			}
+			Result.Triangles.emplace_back(Top, Index(Rings - 1, Segment), Index(Rings - 1, Segment + 1));
+		}
+		return Result;
+	}
+
+	// Closed cylinder along the Z axis, Segments around it, the caps are fans around their center
+	static FMeshBuffers GenerateCylinder(double Radius, double Height, int Segments = 32)
+	{
+		Segments = std::max(Segments, 3);
+		FMeshBuffers Result;
+		for (double Z : { -0.5 * Height, 0.5 * Height })
+			for (int Segment = 0; Segment < Segments; Segment++)
+			{
+				double Azimuth = 2. * M_PI * Segment / Segments;
+				Result.Vertices.emplace_back(Radius * std::cos(Azimuth), Radius * std::sin(Azimuth), Z);
+			}
+		int Bottom = Result.NumVertices(), Top = Bottom + 1;
+		Result.Vertices.emplace_back(0., 0., -0.5 * Height);
+		Result.Vertices.emplace_back(0., 0., 0.5 * Height);
+
+		for (int Segment = 0; Segment < Segments; Segment++)
+		{
+			int Next = (Segment + 1) % Segments;
+			Result.Triangles.emplace_back(Segment, Next, Next + Segments);
+			Result.Triangles.emplace_back(Segment, Next + Segments, Segment + Segments);
+			Result.Triangles.emplace_back(Bottom, Next, Segment);
+			Result.Triangles.emplace_back(Top, Segment + Segments, Next + Segments);
+		}
+		return Result;
+	}
+};
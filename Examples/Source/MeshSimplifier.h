@@ -0,0 +1,418 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <queue>
+#include "CoreMinimal.h"
+#include "JobSystem.h"
+#include "MeshBuffers.h"
+
+/**
+ * Symmetric 4x4 error quadric of Garland and Heckbert, the sum of squared distances to a set of planes.
+ */
+struct FQuadric
+{
+	// a2 ab ac ad b2 bc bd c2 cd d2
+	double Q[10] = {};
+
+	static FQuadric FromPlane(const FVector& Normal, double D, double Weight)
+	{
+		FQuadric Result;
+		double	 A = Normal.x(), B = Normal.y(), C = Normal.z();
+		double	 Coefficients[10] = { A * A, A * B, A * C, A * D, B * B, B * C, B * D, C * C, C * D, D * D };
+		for (int i = 0; i < 10; i++)
+			Result.Q[i] = Coefficients[i] * Weight;
+		return Result;
+	}
+
+	FQuadric& operator+=(const FQuadric& Other)
+	{
+		for (int i = 0; i < 10; i++)
+			Q[i] += Other.Q[i];
+		return *this;
+	}
+
+	friend FQuadric operator+(FQuadric A, const FQuadric& B) { return A += B; }
+
+	[[nodiscard]] double Evaluate(const FVector& P) const
+	{
+		double X = P.x(), Y = P.y(), Z = P.z();
+		return Q[0] * X * X + 2. * Q[1] * X * Y + 2. * Q[2] * X * Z + 2. * Q[3] * X
+			 + Q[4] * Y * Y + 2. * Q[5] * Y * Z + 2. * Q[6] * Y
+			 + Q[7] * Z * Z + 2. * Q[8] * Z + Q[9];
+	}
+
+	// Position of least error, false when the quadric is singular (e.g. a flat or straight neighborhood)
+	bool Minimize(FVector& OutPosition) const
+	{
+		Matrix3d A;
+		A << Q[0], Q[1], Q[2], Q[1], Q[4], Q[5], Q[2], Q[5], Q[7];
+		double Determinant = A.determinant();
+		if (std::abs(Determinant) < 1e-12 * std::max(1., A.squaredNorm() * A.norm()))
+			return false;
+		OutPosition = A.inverse() * -FVector(Q[3], Q[6], Q[8]);
+		return true;
+	}
+};
+
+/**
+ * Quadric edge collapse simplification.
+ * The mesh is first split by a grid into cells simplified in parallel: a cell only collapses edges whose triangles
+ * are all inside the cell, so the cells never touch the same data. A serial pass over the whole mesh then
+ * collapses across the cell seams down to the target. Collapses that would flip a triangle or make the mesh
+ * non-manifold are rejected, and boundary edges are held in place by perpendicular planes.
+ * Usage:
+ *	MeshSimplifier Simplifier(FMeshBuffers::FromStaticMesh(*Mesh));
+ *	FMeshBuffers Simplified = Simplifier.Simplify(Mesh->GetFaceNum() / 4);
+ */
+class MeshSimplifier
+{
+public:
+	static constexpr double BoundaryWeight = 100.;
+	static constexpr int	MaxParallelRounds = 4;
+	static constexpr int	MinParallelTriangles = 4096;
+
+	explicit MeshSimplifier(const FMeshBuffers& Mesh)
+		: Positions(Mesh.Vertices), Triangles(Mesh.Triangles), Quadrics(Mesh.NumVertices()), VertexTriangles(Mesh.NumVertices()),
+		  TriangleAlive(Mesh.NumTriangles(), 1), VertexAlive(Mesh.NumVertices(), 1), Versions(Mesh.NumVertices(), 0)
+	{
+		for (int Triangle = 0; Triangle < Mesh.NumTriangles(); Triangle++)
+		{
+			// Zero area triangles have no plane, but are still listed so that collapses carry them along
+			const Vector3i& Indices = Triangles[Triangle];
+			for (int Corner = 0; Corner < 3; Corner++)
+				VertexTriangles[Indices[Corner]].push_back(Triangle);
+			FVector Normal = (Positions[Indices[1]] - Positions[Indices[0]]).cross(Positions[Indices[2]] - Positions[Indices[0]]);
+			double	Area = Normal.norm() * 0.5;
+			if (Area <= 0.)
+				continue;
+			Normal.normalize();
+			FQuadric Plane = FQuadric::FromPlane(Normal, -Normal.dot(Positions[Indices[0]]), Area);
+			for (int Corner = 0; Corner < 3; Corner++)
+				Quadrics[Indices[Corner]] += Plane;
+		}
+		AddBoundaryQuadrics();
+		NumAliveTriangles = Mesh.NumTriangles();
+	}
+
+	[[nodiscard]] int NumTriangles() const { return NumAliveTriangles; }
+
+	// Largest distance error of an accepted collapse so far, estimated from the quadric error
+	[[nodiscard]] double GetMaxError() const { return MaxError; }
+
+	/**
+	 * Collapse edges until at most TargetTriangles remain, or no valid collapse is left.
+	 * Can be called again with a smaller target, e.g. to build a chain of levels of detail.
+	 */
+	FMeshBuffers Simplify(int TargetTriangles, JobSystem& Jobs = JobSystem::Get(), int GridResolution = 4)
+	{
+		// Parallel rounds on shifted grids so the seams of one round are inside the cells of the next,
+		// until a round has little left to do
+		for (int Round = 0; Round < MaxParallelRounds && GridResolution > 1; Round++)
+		{
+			int NumToRemove = NumAliveTriangles - TargetTriangles;
+			if (NumToRemove < std::max(MinParallelTriangles, NumAliveTriangles / 16))
+				break;
+			AssignCells(GridResolution, static_cast<double>(Round) / MaxParallelRounds);
+			int	   NumCells = GridResolution * GridResolution * GridResolution;
+			double MaxCost = EstimateCostThreshold(NumToRemove, Jobs);
+			TArray<int>	   CellTriangles(NumCells, 0), Removed(NumCells, 0);
+			TArray<double> CellErrors(NumCells, 0.);
+			for (int Triangle = 0; Triangle < static_cast<int>(Triangles.size()); Triangle++)
+				if (int Cell = TriangleCell(Triangle); TriangleAlive[Triangle] && Cell >= 0)
+					CellTriangles[Cell]++;
+			// A cell only touches its own vertices and triangles, the ones next to other cells are locked.
+			// The cells share a cost threshold rather than a triangle count, so the error stays even across them
+			double Ratio = static_cast<double>(TargetTriangles) / NumAliveTriangles;
+			Jobs.ParallelFor(NumCells, [&](int Cell) {
+				int CellToRemove = CellTriangles[Cell] - static_cast<int>(CellTriangles[Cell] * Ratio);
+				Removed[Cell] = CollapseRegion(Cell, CellToRemove, CellErrors[Cell], MaxCost);
+			});
+			for (int Cell = 0; Cell < NumCells; Cell++)
+			{
+				NumAliveTriangles -= Removed[Cell];
+				MaxError = std::max(MaxError, CellErrors[Cell]);
+			}
+		}
+		// Seams and what the cells could not reach
+		NumAliveTriangles -= CollapseRegion(-1, NumAliveTriangles - TargetTriangles, MaxError);
+		return GetMesh();
+	}
+
+	// The current mesh, without the removed vertices and triangles
+	[[nodiscard]] FMeshBuffers GetMesh() const
+	{
+		FMeshBuffers Result;
+		TArray<int>	 Remap(Positions.size(), -1);
+		for (int Triangle = 0; Triangle < static_cast<int>(Triangles.size()); Triangle++)
+		{
+			if (!TriangleAlive[Triangle])
+				continue;
+			Vector3i Indices = Triangles[Triangle];
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				int& Index = Remap[Indices[Corner]];
+				if (Index < 0)
+				{
+					Index = Result.NumVertices();
+					Result.Vertices.push_back(Positions[Indices[Corner]]);
+				}
+				Indices[Corner] = Index;
+			}
+			Result.Triangles.push_back(Indices);
+		}
+		return Result;
+	}
+
+protected:
+	TArray<FVector>		Positions;
+	TArray<Vector3i>	Triangles;
+	TArray<FQuadric>	Quadrics;
+	TArray<TArray<int>> VertexTriangles; // May list dead triangles, skip them
+	TArray<uint8_t>		TriangleAlive;
+	TArray<uint8_t>		VertexAlive;
+	TArray<uint32_t>	Versions; // Bumped when a vertex moves, invalidates its queued edges
+	TArray<int>			VertexCell;
+	TArray<uint8_t>		Locked; // Vertices with a triangle reaching into another cell
+	int					NumAliveTriangles = 0;
+	double				MaxError = 0.;
+
+	struct FCollapse
+	{
+		double	 Cost;
+		int		 Keep, Remove;
+		uint32_t KeepVersion, RemoveVersion;
+		FVector	 Position;
+
+		bool operator<(const FCollapse& Other) const { return Cost > Other.Cost; }
+	};
+
+	void AddBoundaryQuadrics()
+	{
+		// Edges used by a single triangle, found by counting the directed edges both ways
+		TArray<std::pair<uint64_t, int>> Edges;
+		for (int Triangle = 0; Triangle < static_cast<int>(Triangles.size()); Triangle++)
+		{
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				uint32_t A = Triangles[Triangle][Corner], B = Triangles[Triangle][(Corner + 1) % 3];
+				Edges.emplace_back(static_cast<uint64_t>(std::min(A, B)) << 32 | std::max(A, B), Triangle * 3 + Corner);
+			}
+		}
+		std::sort(Edges.begin(), Edges.end());
+		for (size_t i = 0; i < Edges.size(); i++)
+		{
+			bool bShared = (i > 0 && Edges[i - 1].first == Edges[i].first) || (i + 1 < Edges.size() && Edges[i + 1].first == Edges[i].first);
+			if (bShared)
+				continue;
+			int		 Triangle = Edges[i].second / 3, Corner = Edges[i].second % 3;
+			int		 A = Triangles[Triangle][Corner], B = Triangles[Triangle][(Corner + 1) % 3];
+			FVector	 Edge = Positions[B] - Positions[A];
+			FVector	 FaceNormal = (Positions[Triangles[Triangle][1]] - Positions[Triangles[Triangle][0]]).cross(Positions[Triangles[Triangle][2]] - Positions[Triangles[Triangle][0]]);
+			FVector	 Normal = Edge.cross(FaceNormal).normalized();
+			if (!Normal.allFinite())
+				continue;
+			FQuadric Plane = FQuadric::FromPlane(Normal, -Normal.dot(Positions[A]), BoundaryWeight * Edge.squaredNorm());
+			Quadrics[A] += Plane;
+			Quadrics[B] += Plane;
+		}
+	}
+
+	// Bin the vertices in a grid over the mesh bounds, shifted by Offset cells
+	void AssignCells(int GridResolution, double Offset)
+	{
+		AlignedBox3d Bounds;
+		for (int Vertex = 0; Vertex < static_cast<int>(Positions.size()); Vertex++)
+			if (VertexAlive[Vertex])
+				Bounds.extend(Positions[Vertex]);
+		FVector Scale = (Bounds.sizes().array().max(1e-12).inverse() * GridResolution).matrix();
+		Bounds.min() -= Bounds.sizes() * (Offset / GridResolution);
+		VertexCell.resize(Positions.size());
+		for (int Vertex = 0; Vertex < static_cast<int>(Positions.size()); Vertex++)
+		{
+			Vector3i Cell = ((Positions[Vertex] - Bounds.min()).cwiseProduct(Scale)).cast<int>().cwiseMax(0).cwiseMin(GridResolution - 1);
+			VertexCell[Vertex] = (Cell.z() * GridResolution + Cell.y()) * GridResolution + Cell.x();
+		}
+		Locked.assign(Positions.size(), 0);
+		for (int Triangle = 0; Triangle < static_cast<int>(Triangles.size()); Triangle++)
+		{
+			if (TriangleAlive[Triangle] && TriangleCell(Triangle) < 0)
+				for (int Corner = 0; Corner < 3; Corner++)
+					Locked[Triangles[Triangle][Corner]] = 1;
+		}
+	}
+
+	// Cell of the triangle, -1 when its vertices are in different cells
+	int TriangleCell(int Triangle) const
+	{
+		const Vector3i& Indices = Triangles[Triangle];
+		int				Cell = VertexCell[Indices[0]];
+		return VertexCell[Indices[1]] == Cell && VertexCell[Indices[2]] == Cell ? Cell : -1;
+	}
+
+	bool IsCollapsible(int Vertex, int Cell) const
+	{
+		return VertexAlive[Vertex] && (Cell < 0 || (VertexCell[Vertex] == Cell && !Locked[Vertex]));
+	}
+
+	FCollapse ComputeCollapse(int Keep, int Remove) const
+	{
+		FQuadric Quadric = Quadrics[Keep] + Quadrics[Remove];
+		FVector	 Position;
+		if (!Quadric.Minimize(Position))
+		{
+			// Best of the end points and the midpoint
+			FVector Candidates[3] = { Positions[Keep], Positions[Remove], (Positions[Keep] + Positions[Remove]) * 0.5 };
+			Position = *std::min_element(std::begin(Candidates), std::end(Candidates),
+				[&](const FVector& A, const FVector& B) { return Quadric.Evaluate(A) < Quadric.Evaluate(B); });
+		}
+		return { std::max(0., Quadric.Evaluate(Position)), Keep, Remove, Versions[Keep], Versions[Remove], Position };
+	}
+
+	// Queue the edges of Vertex, only those to higher indices when bOnlyHigher (each edge once when queueing all vertices)
+	void PushEdges(int Vertex, int Cell, bool bOnlyHigher, std::priority_queue<FCollapse>& Queue) const
+	{
+		for (int Triangle : VertexTriangles[Vertex])
+		{
+			if (!TriangleAlive[Triangle])
+				continue;
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				int Other = Triangles[Triangle][Corner];
+				if (Other == Vertex || (bOnlyHigher && Other < Vertex) || !IsCollapsible(Other, Cell))
+					continue;
+				Queue.push(ComputeCollapse(Vertex, Other));
+			}
+		}
+	}
+
+	// The collapse keeps the mesh a manifold and flips no triangle
+	bool IsValid(const FCollapse& Collapse) const
+	{
+		// Link condition: the shared neighbors of the two vertices are exactly the opposite vertices of the shared triangles
+		TArray<int> NeighborsKeep, NeighborsRemove;
+		int			NumShared = 0;
+		for (int Vertex : { Collapse.Keep, Collapse.Remove })
+		{
+			for (int Triangle : VertexTriangles[Vertex])
+			{
+				if (!TriangleAlive[Triangle])
+					continue;
+				const Vector3i& Indices = Triangles[Triangle];
+				bool			bShared = (Indices.array() == Collapse.Keep).any() && (Indices.array() == Collapse.Remove).any();
+				if (bShared && Vertex == Collapse.Keep)
+					NumShared++;
+				for (int Corner = 0; Corner < 3; Corner++)
+					if (Indices[Corner] != Collapse.Keep && Indices[Corner] != Collapse.Remove)
+						(Vertex == Collapse.Keep ? NeighborsKeep : NeighborsRemove).push_back(Indices[Corner]);
+
+				// The triangles that stay must not flip or degenerate when their vertex moves
+				if (bShared)
+					continue;
+				FVector Corners[3] = { Positions[Indices[0]], Positions[Indices[1]], Positions[Indices[2]] };
+				FVector Before = (Corners[1] - Corners[0]).cross(Corners[2] - Corners[0]);
+				// A zero area triangle has no orientation to flip
+				if (Before.squaredNorm() == 0.)
+					continue;
+				for (int Corner = 0; Corner < 3; Corner++)
+					if (Indices[Corner] == Vertex)
+						Corners[Corner] = Collapse.Position;
+				FVector After = (Corners[1] - Corners[0]).cross(Corners[2] - Corners[0]);
+				if (After.dot(Before) <= 0.2 * Before.norm() * After.norm())
+					return false;
+			}
+		}
+		std::sort(NeighborsKeep.begin(), NeighborsKeep.end());
+		NeighborsKeep.erase(std::unique(NeighborsKeep.begin(), NeighborsKeep.end()), NeighborsKeep.end());
+		std::sort(NeighborsRemove.begin(), NeighborsRemove.end());
+		NeighborsRemove.erase(std::unique(NeighborsRemove.begin(), NeighborsRemove.end()), NeighborsRemove.end());
+		TArray<int> Common;
+		std::set_intersection(NeighborsKeep.begin(), NeighborsKeep.end(), NeighborsRemove.begin(), NeighborsRemove.end(), std::back_inserter(Common));
+		return NumShared > 0 && static_cast<int>(Common.size()) == NumShared;
+	}
+
+	/**
+	 * Cost under which about NumToRemove triangles can be collapsed, from the current edge costs.
+	 * Collapses raise the costs of the edges around them, so this underestimates and the serial pass does the rest
+	 */
+	double EstimateCostThreshold(int NumToRemove, JobSystem& Jobs) const
+	{
+		TArray<TArray<double>> VertexCosts(Positions.size());
+		Jobs.ParallelFor(static_cast<int>(Positions.size()), [&](int Vertex) {
+			if (!VertexAlive[Vertex])
+				return;
+			for (int Triangle : VertexTriangles[Vertex])
+			{
+				for (int Corner = 0; Corner < 3 && TriangleAlive[Triangle]; Corner++)
+					if (int Other = Triangles[Triangle][Corner]; Other > Vertex)
+						VertexCosts[Vertex].push_back(ComputeCollapse(Vertex, Other).Cost);
+			}
+		}, 1024);
+		TArray<double> Costs;
+		for (const auto& Vertex : VertexCosts)
+			Costs.insert(Costs.end(), Vertex.begin(), Vertex.end());
+		if (Costs.empty())
+			return 0.;
+		// Each collapse removes two triangles, and each edge is listed once per adjacent triangle
+		size_t Index = std::min(Costs.size() - 1, static_cast<size_t>(NumToRemove));
+		std::nth_element(Costs.begin(), Costs.begin() + Index, Costs.end());
+		return Costs[Index];
+	}
+
+	// Collapse the cheapest edges of a cell (all vertices when Cell < 0) until NumToRemove triangles are gone
+	// or the cheapest edge costs more than MaxCost, return the number removed
+	int CollapseRegion(int Cell, int NumToRemove, double& InOutMaxError, double MaxCost = std::numeric_limits<double>::max())
+	{
+		if (NumToRemove <= 0)
+			return 0;
+		std::priority_queue<FCollapse> Queue;
+		for (int Vertex = 0; Vertex < static_cast<int>(Positions.size()); Vertex++)
+			if (IsCollapsible(Vertex, Cell))
+				PushEdges(Vertex, Cell, true, Queue);
+
+		int NumRemoved = 0;
+		while (NumRemoved < NumToRemove && !Queue.empty())
+		{
+			FCollapse Collapse = Queue.top();
+			Queue.pop();
+			if (Collapse.Cost > MaxCost)
+				break;
+			if (!VertexAlive[Collapse.Keep] || !VertexAlive[Collapse.Remove] || Versions[Collapse.Keep] != Collapse.KeepVersion
+				|| Versions[Collapse.Remove] != Collapse.RemoveVersion || !IsValid(Collapse))
+				continue;
+
+			// Move Keep, hand the triangles of Remove over to it and drop the ones that become degenerate
+			Positions[Collapse.Keep] = Collapse.Position;
+			Quadrics[Collapse.Keep] += Quadrics[Collapse.Remove];
+			for (int Triangle : VertexTriangles[Collapse.Remove])
+			{
+				if (!TriangleAlive[Triangle])
+					continue;
+				Vector3i& Indices = Triangles[Triangle];
+				if ((Indices.array() == Collapse.Keep).any())
+				{
+					TriangleAlive[Triangle] = 0;
+					NumRemoved++;
+					continue;
+				}
+				for (int Corner = 0; Corner < 3; Corner++)
+					if (Indices[Corner] == Collapse.Remove)
+						Indices[Corner] = Collapse.Keep;
+				VertexTriangles[Collapse.Keep].push_back(Triangle);
+			}
+			std::erase_if(VertexTriangles[Collapse.Keep], [this](int Triangle) { return !TriangleAlive[Triangle]; });
+			TArray<int>().swap(VertexTriangles[Collapse.Remove]);
+			VertexAlive[Collapse.Remove] = 0;
+			Versions[Collapse.Keep]++;
+			InOutMaxError = std::max(InOutMaxError, std::sqrt(Collapse.Cost / std::max(1e-30, QuadricWeight(Collapse.Keep))));
+			PushEdges(Collapse.Keep, Cell, false, Queue);
+		}
+		return NumRemoved;
+	}
+
+	// Total plane weight of a quadric, the quadric error divided by it is a mean squared distance
+	double QuadricWeight(int Vertex) const
+	{
+		const FQuadric& Quadric = Quadrics[Vertex];
+		return Quadric.Q[0] + Quadric.Q[4] + Quadric.Q[7];
+	}
+};
@@ -8,21 +8,53 @@
 #include "Game/World.h"
 #include "Game/StaticMeshActor.h"
 #include "Mesh/BasicShapesLibrary.h"
+#include "Profiler.h"
+#include "PropertyDirtyTracker.h"
+#include "ReflectionTable.h"
 
 MCLASS(MyCylinder)
 class MyCylinder : public StaticMeshActor
 {
 	REFLECTION_BODY(MyCylinder)
-	MyCylinder() = default;
+	MyCylinder()
+	{
+		DirtyTracker.Invalidates(NAME(Radius), DirtyMesh)
+			.Invalidates(NAME(Length), DirtyMesh)
+			.Invalidates(NAME(Samples), DirtyMesh);
+	}
 
 public:
+	// Compile-time counterpart of the MPROPERTY declarations below, checked against them in Init
+	static constexpr auto PropertyTable()
+	{
+		using namespace ReflectionTable;
+		return MakeTable(
+			REFLECTION_PROPERTY(MyCylinder, Radius, Slide{ 0.1, 1. }, Category{ "MyProperty" }),
+			REFLECTION_PROPERTY(MyCylinder, Length, Step{ 0.5, 2. }, Category{ "MyProperty" }),
+			REFLECTION_PROPERTY(MyCylinder, Samples, Slide{ 4, 64 }, Category{ "MyProperty" }));
+	}
+
 	// Init the cylinder
 	virtual void Init() override
 	{
 		StaticMeshActor::Init();
+		static const bool bTableMatches = ReflectionTable::MatchesReflection(*this);
+		ASSERT(bTableMatches);
 		GetStaticMeshComponent()->SetMeshData(BasicShapesLibrary::GenerateCylinder(Length, Radius, Samples));
 	}
 
+	// Rebuild the mesh at most once per frame, however many edits were made since the last one
+	virtual void Tick(double DeltaTime) override
+	{
+		StaticMeshActor::Tick(DeltaTime);
+		// The engine generator creates the StaticMesh, with its normals and UVs, so it runs here on the game thread
+		if (DirtyTracker.Consume(DirtyMesh))
+		{
+			PROFILE_SCOPE("MyCylinder::GenerateCylinder");
+			GetStaticMeshComponent()->SetMeshData(BasicShapesLibrary::GenerateCylinder(Length, Radius, Samples));
+		}
+	}
+
 protected:
 	MPROPERTY(Slide_(0.1f, 1.f), Category_("MyProperty"))
 	float Radius = 0.3f;
@@ -33,12 +65,27 @@ protected:
 	MPROPERTY(Slide_(4, 64), Category_("MyProperty"))
 	int Samples = 8;
 
-	// When the property is edited, update the mesh data
+	// When the property is edited, only mark the mesh data dirty, it will be rebuilt in Tick
 	virtual void PostEdit(Reflection::FieldAccessor& Field) override
 	{
-		if (Field == NAME(Radius) || Field == NAME(Length) || Field == NAME(Samples))
-			GetStaticMeshComponent()->SetMeshData(BasicShapesLibrary::GenerateCylinder(Length, Radius, Samples));
+		DirtyTracker.MarkDirty(Field);
 	}
+
+public:
+	// Same for the properties changed by ReflectionTable::Load
+	void PostLoadProperty(std::string_view Name)
+	{
+		DirtyTracker.MarkDirty(Name);
+	}
+
+protected:
+	// Derived data invalidated by the properties above
+	enum : PropertyDirtyTracker::FDirtyMask
+	{
+		DirtyMesh = 1 << 0
+	};
+
+	PropertyDirtyTracker DirtyTracker;
 };
 
 inline auto MetaDataExample()
@@ -47,21 +94,28 @@ inline auto MetaDataExample()
 	{
 		auto Object = World.SpawnActor<MyCylinder>("MyCylinder");
 
-		// Iterate all properties
-		for(auto Property : Object->GetAllPropertyAccessors())
-		{
-			MechEngine::LOG_TEMP("Property type:{} name:{}", Property.getTypeName(), Property.getFieldName());
-			for (auto Tag : Property.GetPropertyTags())
-			{
-				if (auto Slide = dynamic_cast<const Slide_*>(Tag))
-				{
-					MechEngine::LOG_TEMP("Drag tag, min:{} max:{}", Slide->GetMin(), Slide->GetMax());
-				}
-				if (auto Category = dynamic_cast<const Category_*>(Tag))
-				{
-					MechEngine::LOG_TEMP("Category tag, category:{}", Category->ParseCategory()[0]);
-				}
-			}
-		}
+		// Iterate all properties, the tags are typed values so no dynamic_cast is needed
+		constexpr auto Table = MyCylinder::PropertyTable();
+		Table.ForEach([](const auto& Property) {
+			MechEngine::LOG_TEMP("Property type:{} name:{}", Property.GetTypeName(), Property.Name);
+		});
+		Table.ForEachWithTag<ReflectionTable::Slide>([](const auto& Property, const ReflectionTable::Slide& Slide) {
+			MechEngine::LOG_TEMP("{} drag tag, min:{} max:{}", Property.Name, Slide.Min, Slide.Max);
+		});
+		Table.ForEachWithTag<ReflectionTable::Category>([](const auto& Property, const ReflectionTable::Category& Category) {
+			MechEngine::LOG_TEMP("{} category tag, category:{}", Property.Name, Category.Name);
+		});
+
+		// Lookup by name is resolved at compile time for constant names
+		static_assert(Table.IndexOf("Samples") == 2);
+
+		// Round trip the properties through the binary serializer
+		TArray<uint8_t> Buffer;
+		const MyCylinder* Objects[] = { Object.get() };
+		ReflectionTable::Save<MyCylinder>(Objects, Buffer);
+		std::span<const uint8_t> Data = Buffer;
+		MyCylinder* LoadTargets[] = { Object.get() };
+		bool Loaded = ReflectionTable::Load<MyCylinder>(LoadTargets, Data);
+		MechEngine::LOG_TEMP("Serialized {} bytes, load {}", Buffer.size(), Loaded ? "succeeded" : "failed");
 	};
 };
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+#include <algorithm>
+#include <span>
+#include "CoreMinimal.h"
+
+// Slot index plus the generation of the slot when the object was created, stale once the object is destroyed
+template <class T>
+struct TPoolHandle
+{
+	static constexpr uint32_t InvalidIndex = ~0u;
+
+	uint32_t Index = InvalidIndex;
+	uint32_t Generation = 0;
+
+	[[nodiscard]] bool IsValid() const { return Index != InvalidIndex; }
+	bool operator==(const TPoolHandle& Other) const = default;
+};
+
+/**
+ * Pool of objects of one type, stored by value in a dense array and addressed by generational handles.
+ * Iteration walks the dense array, so all objects of the type are visited in one linear pass.
+ * Destroying moves the last object into the hole, so object addresses are not stable: keep handles, not pointers.
+ * A handle to a destroyed object is detected by its generation, even after its slot has been reused.
+ * Usage:
+ *	TObjectPool<FParticle> Particles;
+ *	auto Handle = Particles.Create(Position);
+ *	for (FParticle& Particle : Particles) ...
+ *	if (FParticle* Particle = Particles.Get(Handle)) ...
+ */
+template <class T>
+class TObjectPool
+{
+public:
+	using FHandle = TPoolHandle<T>;
+
+	void Reserve(int Num)
+	{
+		Objects.reserve(Num);
+		DenseToSlot.reserve(Num);
+		Slots.reserve(Num);
+	}
+
+	template <class... ArgsT>
+	FHandle Create(ArgsT&&... Args)
+	{
+		uint32_t Slot;
+		if (!FreeSlots.empty())
+		{
+			Slot = FreeSlots.back();
+			FreeSlots.pop_back();
+		}
+		else
+		{
+			Slot = static_cast<uint32_t>(Slots.size());
+			Slots.push_back({});
+		}
+		Slots[Slot].Dense = static_cast<uint32_t>(Objects.size());
+		Objects.emplace_back(std::forward<ArgsT>(Args)...);
+		DenseToSlot.push_back(Slot);
+		return { Slot, Slots[Slot].Generation };
+	}
+
+	[[nodiscard]] bool IsValid(FHandle Handle) const
+	{
+		return Handle.Index < Slots.size() && Slots[Handle.Index].Generation == Handle.Generation && Slots[Handle.Index].Dense != Dead;
+	}
+
+	// Null for a stale handle. The pointer is valid until the next Create or Destroy
+	[[nodiscard]] T* Get(FHandle Handle) { return IsValid(Handle) ? &Objects[Slots[Handle.Index].Dense] : nullptr; }
+	[[nodiscard]] const T* Get(FHandle Handle) const { return IsValid(Handle) ? &Objects[Slots[Handle.Index].Dense] : nullptr; }
+
+	bool Destroy(FHandle Handle)
+	{
+		if (!IsValid(Handle))
+			return false;
+		uint32_t Dense = Slots[Handle.Index].Dense;
+		if (Dense + 1 != Objects.size())
+		{
+			Objects[Dense] = std::move(Objects.back());
+			DenseToSlot[Dense] = DenseToSlot.back();
+			Slots[DenseToSlot[Dense]].Dense = Dense;
+		}
+		Objects.pop_back();
+		DenseToSlot.pop_back();
+		Release(Handle.Index);
+		return true;
+	}
+
+	/**
+	 * Destroy many objects at once, e.g. all the actors of a level, with one compaction pass instead of a move per object.
+	 * The surviving objects keep their order. Stale handles are skipped, returns the number of objects destroyed
+	 */
+	int Destroy(std::span<const FHandle> Handles)
+	{
+		int NumDestroyed = 0;
+		for (const FHandle& Handle : Handles)
+		{
+			if (!IsValid(Handle))
+				continue;
+			Slots[Handle.Index].Dense = Dead;
+			NumDestroyed++;
+		}
+		if (NumDestroyed == 0)
+			return 0;
+
+		uint32_t Write = 0;
+		for (uint32_t Read = 0; Read < Objects.size(); Read++)
+		{
+			uint32_t Slot = DenseToSlot[Read];
+			if (Slots[Slot].Dense == Dead)
+			{
+				Release(Slot);
+				continue;
+			}
+			if (Write != Read)
+			{
+				Objects[Write] = std::move(Objects[Read]);
+				DenseToSlot[Write] = Slot;
+			}
+			Slots[Slot].Dense = Write++;
+		}
+		Objects.erase(Objects.begin() + Write, Objects.end());
+		DenseToSlot.resize(Write);
+		return NumDestroyed;
+	}
+
+	void Clear()
+	{
+		for (uint32_t Slot : DenseToSlot)
+			Release(Slot);
+		Objects.clear();
+		DenseToSlot.clear();
+	}
+
+	[[nodiscard]] int Num() const { return static_cast<int>(Objects.size()); }
+
+	// Handle of the object at a dense index, e.g. while iterating
+	[[nodiscard]] FHandle GetHandle(int DenseIndex) const
+	{
+		uint32_t Slot = DenseToSlot[DenseIndex];
+		return { Slot, Slots[Slot].Generation };
+	}
+
+	auto begin() { return Objects.begin(); }
+	auto end() { return Objects.end(); }
+	auto begin() const { return Objects.begin(); }
+	auto end() const { return Objects.end(); }
+
+protected:
+	static constexpr uint32_t Dead = ~0u;
+
+	struct FSlot
+	{
+		uint32_t Dense = Dead;
+		uint32_t Generation = 0;
+	};
+
+	TArray<T>		 Objects;
+	TArray<uint32_t> DenseToSlot;
+	TArray<FSlot>	 Slots;
+	TArray<uint32_t> FreeSlots;
+
+	// The generation bump invalidates the handles to the slot
+	void Release(uint32_t Slot)
+	{
+		Slots[Slot].Dense = Dead;
+		Slots[Slot].Generation++;
+		FreeSlots.push_back(Slot);
+	}
+};
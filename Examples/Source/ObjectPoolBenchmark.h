@@ -0,0 +1,198 @@
+#pragma once
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include "CommandLine.h"
+#include "CoreMinimal.h"
+#include "ObjectPool.h"
+
+/**
+ * Spawn, tick and destroy NumActors actor-like objects, each with a root transform component,
+ * stored as separate reference counted heap objects (as NewObject does) and in type segregated object pools.
+ * Reported as JSON, the phases are timed separately, best of three runs.
+ * Run it with
+ *	MechEngineExamples --pool-benchmark [--actors N] [--out result.json]
+ */
+namespace ObjectPoolBenchmark
+{
+	struct FTransformComponent
+	{
+		FVector Translation = FVector::Zero();
+		FQuat	Rotation = FQuat::Identity();
+		FVector Scale = FVector::Ones();
+	};
+
+	struct FSharedActor
+	{
+		std::shared_ptr<FTransformComponent> Root;
+		FVector								 Velocity;
+	};
+
+	struct FPooledActor
+	{
+		TPoolHandle<FTransformComponent> Root;
+		FVector							 Velocity;
+	};
+
+	struct FPhaseSeconds
+	{
+		double Spawn = std::numeric_limits<double>::max();
+		double Tick = std::numeric_limits<double>::max();
+		double Destroy = std::numeric_limits<double>::max();
+		double Respawn = std::numeric_limits<double>::max();
+	};
+
+	constexpr int NumTicks = 10;
+
+	inline FVector MakeVelocity(int i) { return FVector(i % 7, i % 11, i % 13) * 1e-3; }
+
+	// Time Function in seconds, keeping the minimum in Best
+	template <class FunctionT>
+	void Time(double& Best, FunctionT&& Function)
+	{
+		auto StartTime = std::chrono::steady_clock::now();
+		Function();
+		Best = std::min(Best, std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count());
+	}
+
+	inline FPhaseSeconds RunShared(int NumActors, double& Checksum)
+	{
+		FPhaseSeconds Result;
+		for (int Run = 0; Run < 3; Run++)
+		{
+			TArray<std::shared_ptr<FSharedActor>> Actors;
+			Time(Result.Spawn, [&] {
+				for (int i = 0; i < NumActors; i++)
+					Actors.push_back(std::make_shared<FSharedActor>(FSharedActor{ std::make_shared<FTransformComponent>(), MakeVelocity(i) }));
+			});
+			Time(Result.Tick, [&] {
+				for (int Tick = 0; Tick < NumTicks; Tick++)
+					for (const auto& Actor : Actors)
+						Actor->Root->Translation += Actor->Velocity;
+			});
+			// Every other actor, as a level unload would
+			Time(Result.Destroy, [&] {
+				int Write = 0;
+				for (int i = 0; i < static_cast<int>(Actors.size()); i++)
+					if (i % 2)
+						Actors[Write++] = std::move(Actors[i]);
+				Actors.resize(Write);
+			});
+			Time(Result.Respawn, [&] {
+				for (int i = 0; i < NumActors / 2; i++)
+					Actors.push_back(std::make_shared<FSharedActor>(FSharedActor{ std::make_shared<FTransformComponent>(), MakeVelocity(i) }));
+			});
+			Checksum = 0.;
+			for (const auto& Actor : Actors)
+				Checksum += Actor->Root->Translation.sum();
+		}
+		return Result;
+	}
+
+	inline FPhaseSeconds RunPooled(int NumActors, double& Checksum)
+	{
+		FPhaseSeconds Result;
+		for (int Run = 0; Run < 3; Run++)
+		{
+			TObjectPool<FPooledActor>		 Actors;
+			TObjectPool<FTransformComponent> Components;
+			TArray<TPoolHandle<FPooledActor>> Handles;
+			Time(Result.Spawn, [&] {
+				for (int i = 0; i < NumActors; i++)
+					Handles.push_back(Actors.Create(FPooledActor{ Components.Create(), MakeVelocity(i) }));
+			});
+			Time(Result.Tick, [&] {
+				for (int Tick = 0; Tick < NumTicks; Tick++)
+					for (const FPooledActor& Actor : Actors)
+						Components.Get(Actor.Root)->Translation += Actor.Velocity;
+			});
+			Time(Result.Destroy, [&] {
+				TArray<TPoolHandle<FPooledActor>>		  DeadActors;
+				TArray<TPoolHandle<FTransformComponent>> DeadComponents;
+				for (int i = 0; i < NumActors; i += 2)
+				{
+					DeadActors.push_back(Handles[i]);
+					DeadComponents.push_back(Actors.Get(Handles[i])->Root);
+				}
+				Actors.Destroy(DeadActors);
+				Components.Destroy(DeadComponents);
+			});
+			Time(Result.Respawn, [&] {
+				for (int i = 0; i < NumActors / 2; i++)
+					Actors.Create(FPooledActor{ Components.Create(), MakeVelocity(i) });
+			});
+			Checksum = 0.;
+			for (const auto& Component : Components)
+				Checksum += Component.Translation.sum();
+		}
+		return Result;
+	}
+
+	inline void WritePhases(std::ostringstream& Json, const char* Name, const FPhaseSeconds& Seconds, double Checksum)
+	{
+		Json << "\t\t{ \"Storage\": \"" << Name << "\", \"SpawnSeconds\": " << Seconds.Spawn << ", \"TickSeconds\": " << Seconds.Tick
+			 << ", \"DestroySeconds\": " << Seconds.Destroy << ", \"RespawnSeconds\": " << Seconds.Respawn << ", \"Checksum\": " << Checksum << " }";
+	}
+} // namespace ObjectPoolBenchmark
+
+inline String RunObjectPoolBenchmark(int NumActors)
+{
+	using namespace ObjectPoolBenchmark;
+	double		  SharedChecksum = 0., PooledChecksum = 0.;
+	FPhaseSeconds Shared = RunShared(NumActors, SharedChecksum);
+	FPhaseSeconds Pooled = RunPooled(NumActors, PooledChecksum);
+
+	std::ostringstream Json;
+	Json.precision(9);
+	Json << "{\n"
+		 << "\t\"Actors\": " << NumActors << ",\n"
+		 << "\t\"Ticks\": " << NumTicks << ",\n"
+		 << "\t\"Storages\": [\n";
+	WritePhases(Json, "SharedPtr", Shared, SharedChecksum);
+	Json << ",\n";
+	WritePhases(Json, "ObjectPool", Pooled, PooledChecksum);
+	Json << "\n\t]\n}\n";
+	return Json.str();
+}
+
+// Entry point of the --pool-benchmark command line mode, prints the result as JSON
+inline int ObjectPoolBenchmarkMain(int argc, char* argv[])
+{
+	auto PrintUsage = [] {
+		std::cerr << "Usage: MechEngineExamples --pool-benchmark [--actors N] [--out result.json]\n";
+		return 1;
+	};
+	int	 NumActors = 100000;
+	Path Output;
+	for (int i = 2; i < argc; i++)
+	{
+		String Option = argv[i];
+		if (Option == "--actors" && i + 1 < argc)
+		{
+			if (!ParseArgument("--actors", argv[++i], NumActors, 1))
+				return PrintUsage();
+		}
+		else if (Option == "--out" && i + 1 < argc)
+			Output = argv[++i];
+		else
+		{
+			LOG_ERROR("Unknown benchmark option: {}", Option);
+			return PrintUsage();
+		}
+	}
+
+	String Json = RunObjectPoolBenchmark(NumActors);
+	std::cout << Json;
+	if (!Output.empty())
+	{
+		std::ofstream OutFile(Output);
+		if (!(OutFile << Json))
+		{
+			LOG_ERROR("Failed to write benchmark result: {}", Output.string());
+			return 1;
+		}
+	}
+	return 0;
+}
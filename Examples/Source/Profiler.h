@@ -0,0 +1,299 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include "CoreMinimal.h"
+#include "Misc/Path.h"
+
+/**
+ * Scoped zone profiler for the hot paths.
+ * Every thread records its zones into its own ring buffer, written without locks and read concurrently
+ * by the timeline and the trace export. When the profiler is disabled a zone costs one relaxed load,
+ * and defining MECH_PROFILER to 0 compiles the zones out entirely.
+ * Usage:
+ *	void Rebuild() { PROFILE_SCOPE("Rebuild"); ... }
+ *	Profiler::Get().SetEnabled(true);
+ *	Profiler::Get().ExportChromeTrace("trace.json"); // Open in chrome://tracing or ui.perfetto.dev
+ */
+class Profiler
+{
+public:
+	// Events kept per thread, older events are overwritten
+	static constexpr uint32_t RingCapacity = 1 << 15;
+	static constexpr int	  MaxFrames = 256;
+
+	struct FEvent
+	{
+		const char* Name; // Must outlive the profiler, usually a string literal
+		int64_t		Begin;
+		int64_t		End;
+		int			Depth;
+		int			Thread;
+	};
+
+	static Profiler& Get()
+	{
+		static Profiler Instance;
+		return Instance;
+	}
+
+	[[nodiscard]] bool IsEnabled() const { return Enabled.load(std::memory_order_relaxed); }
+	void SetEnabled(bool bEnabled) { Enabled.store(bEnabled, std::memory_order_relaxed); }
+
+	// Nanoseconds since the profiler was created
+	[[nodiscard]] int64_t Now() const
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Epoch).count();
+	}
+
+	// Name the calling thread in the timeline and the trace. Cheap, the buffer of a thread is only created by its first zone
+	void SetThreadName(const String& Name)
+	{
+		std::lock_guard Lock(Mutex);
+		LocalThreadName() = Name;
+		if (LocalBufferPtr())
+			LocalBufferPtr()->Name = Name;
+	}
+
+	// Mark the start of a frame on the game thread, the timeline shows whole frames
+	void BeginFrame()
+	{
+		if (!IsEnabled())
+			return;
+		std::lock_guard Lock(Mutex);
+		FrameStarts[NumFrames++ % MaxFrames] = Now();
+	}
+
+	void Record(const char* Name, int64_t Begin, int64_t End, int Depth)
+	{
+		FThreadBuffer& Buffer = LocalBuffer();
+		uint64_t	   Index = Buffer.WriteIndex.load(std::memory_order_relaxed);
+		FSlot&		   Slot = Buffer.Slots[Index % RingCapacity];
+		// Invalidate the slot first, so a concurrent reader never pairs the old name with new times
+		Slot.Sequence.store(~0ull, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		Slot.Name.store(Name, std::memory_order_relaxed);
+		Slot.Begin.store(Begin, std::memory_order_relaxed);
+		Slot.End.store(End, std::memory_order_relaxed);
+		Slot.Depth.store(Depth, std::memory_order_relaxed);
+		Slot.Sequence.store(Index, std::memory_order_release);
+		Buffer.WriteIndex.store(Index + 1, std::memory_order_release);
+	}
+
+	// Events of all threads ending in [Begin, End], sorted by begin time
+	[[nodiscard]] TArray<FEvent> Collect(int64_t Begin = 0, int64_t End = INT64_MAX) const
+	{
+		TArray<FEvent> Result;
+		Collect(Result, Begin, End);
+		return Result;
+	}
+
+	// Collect into any array of events, e.g. a TArenaArray to keep the timeline off the heap
+	template <class ArrayT>
+	void Collect(ArrayT& Result, int64_t Begin = 0, int64_t End = INT64_MAX) const
+	{
+		Result.clear();
+		// Only the registration of new threads waits for the lock, the writers never take it
+		std::lock_guard Lock(Mutex);
+		for (int Thread = 0; Thread < static_cast<int>(Threads.size()); Thread++)
+		{
+			const FThreadBuffer& Buffer = *Threads[Thread];
+			uint64_t			 Write = Buffer.WriteIndex.load(std::memory_order_acquire);
+			for (uint64_t Index = Write > RingCapacity ? Write - RingCapacity : 0; Index < Write; Index++)
+			{
+				const FSlot& Slot = Buffer.Slots[Index % RingCapacity];
+				if (Slot.Sequence.load(std::memory_order_acquire) != Index)
+					continue;
+				FEvent Event{ Slot.Name.load(std::memory_order_relaxed), Slot.Begin.load(std::memory_order_relaxed),
+					Slot.End.load(std::memory_order_relaxed), Slot.Depth.load(std::memory_order_relaxed), Thread };
+				// Overwritten while reading
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (Slot.Sequence.load(std::memory_order_relaxed) != Index)
+					continue;
+				if (Event.End >= Begin && Event.End <= End)
+					Result.push_back(Event);
+			}
+		}
+		std::sort(Result.begin(), Result.end(), [](const FEvent& A, const FEvent& B) { return A.Begin < B.Begin; });
+	}
+
+	[[nodiscard]] TArray<String> GetThreadNames() const
+	{
+		std::lock_guard Lock(Mutex);
+		TArray<String>	Names;
+		for (const auto& Buffer : Threads)
+			Names.push_back(Buffer->Name);
+		return Names;
+	}
+
+	// Begin of the Count-th last complete frame and the begin of the current frame, both zero if there is none
+	[[nodiscard]] std::pair<int64_t, int64_t> GetFrameRange(int Count = 1) const
+	{
+		std::lock_guard Lock(Mutex);
+		Count = std::min(Count, std::min(NumFrames, MaxFrames) - 1);
+		if (Count <= 0)
+			return { 0, 0 };
+		return { FrameStarts[(NumFrames - 1 - Count) % MaxFrames], FrameStarts[(NumFrames - 1) % MaxFrames] };
+	}
+
+	// Write the recorded events in the Chrome trace event format
+	bool ExportChromeTrace(const Path& FilePath) const
+	{
+		TArray<FEvent> Events = Collect();
+		TArray<String> Names = GetThreadNames();
+		std::ofstream  OutFile(FilePath);
+		if (!OutFile.is_open())
+		{
+			LOG_ERROR("Failed to open file: {}", FilePath.string());
+			return false;
+		}
+		// Entries are separated rather than terminated, there may be thread names without events or the other way around
+		const char* Separator = "\n";
+		OutFile << "{\"traceEvents\":[";
+		for (int Thread = 0; Thread < static_cast<int>(Names.size()); Thread++)
+		{
+			OutFile << Separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << Thread << ",\"args\":{\"name\":";
+			WriteJsonString(OutFile, Names[Thread]);
+			OutFile << "}}";
+			Separator = ",\n";
+		}
+		OutFile.precision(3);
+		OutFile << std::fixed;
+		for (const FEvent& Event : Events)
+		{
+			OutFile << Separator << "{\"name\":";
+			WriteJsonString(OutFile, Event.Name);
+			OutFile << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << Event.Thread
+					<< ",\"ts\":" << Event.Begin * 1e-3 << ",\"dur\":" << (Event.End - Event.Begin) * 1e-3 << "}";
+			Separator = ",\n";
+		}
+		OutFile << "\n]}\n";
+		return OutFile.good();
+	}
+
+	// Zone nesting depth of the calling thread
+	static int& LocalDepth()
+	{
+		thread_local int Depth = 0;
+		return Depth;
+	}
+
+protected:
+	// Quoted and escaped, zone and thread names are free text
+	static void WriteJsonString(std::ostream& Out, std::string_view Text)
+	{
+		Out << '"';
+		for (char Char : Text)
+		{
+			switch (Char)
+			{
+				case '"': Out << "\\\""; break;
+				case '\\': Out << "\\\\"; break;
+				case '\n': Out << "\\n"; break;
+				case '\r': Out << "\\r"; break;
+				case '\t': Out << "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(Char) < 0x20)
+						Out << "\\u00" << "0123456789abcdef"[Char >> 4] << "0123456789abcdef"[Char & 15];
+					else
+						Out << Char;
+			}
+		}
+		Out << '"';
+	}
+
+	struct FSlot
+	{
+		std::atomic<uint64_t>	 Sequence = ~0ull;
+		std::atomic<const char*> Name = nullptr;
+		std::atomic<int64_t>	 Begin = 0;
+		std::atomic<int64_t>	 End = 0;
+		std::atomic<int>		 Depth = 0;
+	};
+
+	struct FThreadBuffer
+	{
+		String					 Name;
+		std::atomic<uint64_t>	 WriteIndex = 0;
+		std::unique_ptr<FSlot[]> Slots = std::make_unique<FSlot[]>(RingCapacity);
+	};
+
+	const std::chrono::steady_clock::time_point Epoch = std::chrono::steady_clock::now();
+	std::atomic<bool>							Enabled = false;
+	mutable std::mutex							Mutex;
+	TArray<std::shared_ptr<FThreadBuffer>>		Threads;
+	int64_t										FrameStarts[MaxFrames] = {};
+	int											NumFrames = 0;
+
+	static String& LocalThreadName()
+	{
+		thread_local String Name;
+		return Name;
+	}
+
+	// Buffers are shared with the registry, so events of finished threads can still be exported
+	static std::shared_ptr<FThreadBuffer>& LocalBufferPtr()
+	{
+		thread_local std::shared_ptr<FThreadBuffer> Buffer;
+		return Buffer;
+	}
+
+	FThreadBuffer& LocalBuffer()
+	{
+		auto& Buffer = LocalBufferPtr();
+		if (!Buffer)
+		{
+			Buffer = std::make_shared<FThreadBuffer>();
+			std::lock_guard Lock(Mutex);
+			Buffer->Name = LocalThreadName().empty() ? "Thread " + std::to_string(Threads.size()) : LocalThreadName();
+			Threads.push_back(Buffer);
+		}
+		return *Buffer;
+	}
+};
+
+// Records the lifetime of the scope as a zone when the profiler is enabled
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* InName)
+	{
+		if (!Profiler::Get().IsEnabled())
+			return;
+		Name = InName;
+		Depth = Profiler::LocalDepth()++;
+		Begin = Profiler::Get().Now();
+	}
+
+	~ProfileScope()
+	{
+		if (!Name)
+			return;
+		Profiler::LocalDepth()--;
+		Profiler::Get().Record(Name, Begin, Profiler::Get().Now(), Depth);
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+protected:
+	const char* Name = nullptr;
+	int64_t		Begin = 0;
+	int			Depth = 0;
+};
+
+#ifndef MECH_PROFILER
+	#define MECH_PROFILER 1
+#endif
+
+#define PROFILE_CONCAT_INNER(A, B) A##B
+#define PROFILE_CONCAT(A, B) PROFILE_CONCAT_INNER(A, B)
+#if MECH_PROFILER
+	#define PROFILE_SCOPE(Name) ProfileScope PROFILE_CONCAT(ProfileScope_, __LINE__)(Name)
+#else
+	#define PROFILE_SCOPE(Name)
+#endif
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <imgui.h>
+#include "CoreMinimal.h"
+#include "ExampleCache.h"
+#include "FrameArena.h"
+#include "Profiler.h"
+#include "ReflectionTable.h"
+#include "Misc/Path.h"
+
+/**
+ * ImGui timeline of the Profiler: the zones of the last frames, one row per thread, nested zones stacked below
+ * their parents. Hover a zone for its duration. Draw it once per frame, it also marks the frame boundaries.
+ * The frame arena counters are shown below, the heap blocks stop growing once the frames reach a steady state.
+ * Usage:
+ *	world.AddWidget<LambdaUIWidget>(DrawProfilerTimeline);
+ */
+inline void DrawProfilerTimeline()
+{
+	constexpr float RowHeight = 18.f;
+	static int		NumFrames = 3;
+	static bool		bPaused = false;
+	static std::pair<int64_t, int64_t> Range;
+
+	// The temporaries are released on return, so the timeline also works where nobody resets the frame arena
+	FArenaScope ArenaScope;
+	Profiler&	Instance = Profiler::Get();
+	Instance.BeginFrame();
+	if (ImGui::Begin("Profiler"))
+	{
+		bool bEnabled = Instance.IsEnabled();
+		if (ImGui::Checkbox("Enabled", &bEnabled))
+			Instance.SetEnabled(bEnabled);
+		ImGui::SameLine();
+		ImGui::Checkbox("Pause", &bPaused);
+		ImGui::SameLine();
+		if (ImGui::Button("Export trace"))
+		{
+			Path TracePath = ExampleCacheDir() / "ProfilerTrace.json";
+			Path::CreateDirectory(TracePath.parent_path());
+			if (Instance.ExportChromeTrace(TracePath))
+				LOG_INFO("Profiler trace written to {}", TracePath.string());
+		}
+		ImGui::SliderInt("Frames", &NumFrames, 1, 16);
+		LinearArena::FStats ArenaStats = FrameArena::GetStats();
+		ImGui::Text("Frame arena: %.1f KB in %d allocations, %.1f KB peak, %d heap blocks", ArenaStats.BytesUsed / 1024.,
+			static_cast<int>(ArenaStats.NumAllocations), ArenaStats.PeakBytes / 1024., static_cast<int>(ArenaStats.NumBlockAllocations));
+
+		if (!bPaused)
+			Range = Instance.GetFrameRange(NumFrames);
+		auto [Begin, End] = Range;
+		if (End <= Begin)
+			ImGui::Text("No complete frame recorded");
+		else
+		{
+			TArenaArray<Profiler::FEvent> Events;
+			Instance.Collect(Events, Begin, End);
+			TArray<String> Threads = Instance.GetThreadNames();
+			ImGui::Text("%.3f ms per frame, %d zones", (End - Begin) * 1e-6 / NumFrames, static_cast<int>(Events.size()));
+
+			// A row per thread with a name line above its zones, as tall as the deepest zone
+			TArenaArray<int> Depths(Threads.size(), 0);
+			for (const auto& Event : Events)
+				Depths[Event.Thread] = std::max(Depths[Event.Thread], Event.Depth + 1);
+			TArenaArray<float> RowTops(Threads.size() + 1, 0.f);
+			for (size_t Thread = 0; Thread < Threads.size(); Thread++)
+				RowTops[Thread + 1] = RowTops[Thread] + (Depths[Thread] ? (Depths[Thread] + 1) * RowHeight + 4.f : 0.f);
+
+			ImDrawList* DrawList = ImGui::GetWindowDrawList();
+			ImVec2		Origin = ImGui::GetCursorScreenPos();
+			float		Width = std::max(ImGui::GetContentRegionAvail().x, 100.f);
+			double		PixelsPerNs = Width / static_cast<double>(End - Begin);
+			for (size_t Thread = 0; Thread < Threads.size(); Thread++)
+			{
+				if (Depths[Thread])
+					DrawList->AddText({ Origin.x, Origin.y + RowTops[Thread] }, IM_COL32(200, 200, 200, 255), Threads[Thread].c_str());
+			}
+			for (const auto& Event : Events)
+			{
+				float  X0 = Origin.x + static_cast<float>((std::max(Event.Begin, Begin) - Begin) * PixelsPerNs);
+				float  X1 = std::max(X0 + 1.f, Origin.x + static_cast<float>((Event.End - Begin) * PixelsPerNs));
+				float  Y0 = Origin.y + RowTops[Event.Thread] + (Event.Depth + 2) * RowHeight;
+				ImVec2 Min(X0, Y0 - RowHeight + 1.f), Max(X1, Y0);
+				// Color from the name, so a zone keeps its color between frames
+				uint64_t Hash = ReflectionTable::Hash(Event.Name);
+				DrawList->AddRectFilled(Min, Max, IM_COL32(80 + Hash % 150, 80 + (Hash >> 8) % 150, 80 + (Hash >> 16) % 150, 255));
+				if (X1 - X0 > 40.f)
+					DrawList->AddText({ X0 + 2.f, Min.y + 1.f }, IM_COL32(0, 0, 0, 255), Event.Name);
+				if (ImGui::IsMouseHoveringRect(Min, Max))
+					ImGui::SetTooltip("%s\n%.3f ms", Event.Name, (Event.End - Event.Begin) * 1e-6);
+			}
+			ImGui::Dummy({ Width, RowTops.back() });
+		}
+	}
+	ImGui::End();
+}
@@ -7,6 +7,7 @@
 #include "Game/StaticMeshActor.h"
 #include "Game/World.h"
 #include "Mesh/BasicShapesLibrary.h"
+#include "TickScheduler.h"
 
 /************************************************************************
  * Project a 3D point to 2D surface                                     *
@@ -26,11 +27,34 @@ inline auto ProjectToSurfaceExample()
 		// auto Surface = World.SpawnActor<ParametricMeshActor>("Cone", NewObject<ConeSurface>());
 		// Surface->GetParametricMeshComponent()->GetMeshData()->GetMaterial()->SetAlpha(0.4);
 
-		auto TargetPoint = World.SpawnActor<StaticMeshActor>("3D Point", BasicShapesLibrary::GenerateSphere(0.02));
-
-		auto ProjectPoint = World.SpawnActor<StaticMeshActor>("Projected Point", BasicShapesLibrary::GenerateSphere(0.02));
-		ProjectPoint->TickFunction = [TargetPoint, Surface](double DeltaTime, Actor* actor) {
-			actor->SetTranslation(Surface->Sample(Surface->Projection(TargetPoint->GetTranslation())));
+		// Project points through the scheduler, each projection is an independent tick task computed in parallel.
+		// The first point is the one to drag around, the others are a fixed grid above the surface
+		auto Scheduler = std::make_shared<TickScheduler>();
+		auto AddProjection = [&World, &Scheduler, Surface](const String& Name, const FVector& Location) {
+			auto TargetPoint = World.SpawnActor<StaticMeshActor>("3D Point" + Name, BasicShapesLibrary::GenerateSphere(0.02));
+			TargetPoint->SetTranslation(Location);
+
+			auto ProjectPoint = World.SpawnActor<StaticMeshActor>("Projected Point" + Name, BasicShapesLibrary::GenerateSphere(0.02));
+			auto Projected = std::make_shared<FVector>(FVector::Zero());
+
+			FTickTask Task;
+			Task.Name = "Project point" + Name;
+			Task.Reads = {TargetPoint.get(), Surface.get()};
+			Task.Writes = {ProjectPoint.get()};
+			Task.Compute = [TargetPoint, Surface, Projected](double DeltaTime) {
+				*Projected = Surface->Sample(Surface->Projection(TargetPoint->GetTranslation()));
+			};
+			Task.Apply = [ProjectPoint, Projected](double DeltaTime) {
+				ProjectPoint->SetTranslation(*Projected);
+			};
+			Scheduler->AddTask(std::move(Task));
+		};
+		AddProjection("", FVector::Zero());
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				AddProjection(" " + std::to_string(i * 4 + j), {0.5 * (i - 1.5), 0.5 * (j - 1.5), 1.});
+		World.TickFunction = [Scheduler](double DeltaTime, auto&) {
+			Scheduler->Tick(DeltaTime);
 		};
 	};
 }
\ No newline at end of file
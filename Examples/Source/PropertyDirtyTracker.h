@@ -0,0 +1,107 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <string_view>
+#include <utility>
+#include "Object/Object.h"
+
+/**
+ * Map reflected properties (MPROPERTY) to the derived data they invalidate.
+ * Call MarkDirty in PostEdit to only record the edit, then consume the dirty bits once per frame in Tick.
+ * So a slider drag firing dozens of edits per second results in at most one rebuild per frame.
+ */
+class PropertyDirtyTracker
+{
+public:
+	using FDirtyMask = uint32_t;
+
+	// Declare that editing the property invalidates the derived data in Mask, e.g. Invalidates(NAME(Radius), DirtyMesh)
+	PropertyDirtyTracker& Invalidates(const char* PropertyName, FDirtyMask Mask)
+	{
+		Bindings.emplace_back(PropertyName, Mask);
+		return *this;
+	}
+
+	// Mark the derived data invalidated by the edited field dirty, return false if the field is not tracked
+	bool MarkDirty(Reflection::FieldAccessor& Field)
+	{
+		bool Tracked = false;
+		for (const auto& [Name, Mask] : Bindings)
+		{
+			if (Field == Name)
+			{
+				DirtyMask |= Mask;
+				Tracked = true;
+			}
+		}
+		return Tracked;
+	}
+
+	// Same by property name, for edits that do not come through the editor, e.g. ReflectionTable::Load
+	bool MarkDirty(std::string_view PropertyName)
+	{
+		bool Tracked = false;
+		for (const auto& [Name, Mask] : Bindings)
+		{
+			if (PropertyName == Name)
+			{
+				DirtyMask |= Mask;
+				Tracked = true;
+			}
+		}
+		return Tracked;
+	}
+
+	void MarkDirty(FDirtyMask Mask) { DirtyMask |= Mask; }
+
+	[[nodiscard]] bool IsDirty(FDirtyMask Mask = ~FDirtyMask(0)) const { return (DirtyMask & Mask) != 0; }
+
+	// Return the dirty bits in Mask and clear them
+	FDirtyMask Consume(FDirtyMask Mask = ~FDirtyMask(0))
+	{
+		FDirtyMask Result = DirtyMask & Mask;
+		DirtyMask &= ~Mask;
+		return Result;
+	}
+
+protected:
+	TArray<std::pair<const char*, FDirtyMask>> Bindings;
+	FDirtyMask DirtyMask = 0;
+};
+
+/**
+ * Rebuild derived data on a worker thread, and swap the result in on the game thread.
+ * Only one rebuild is in flight at a time, edits arriving meanwhile should stay dirty and be launched after the swap.
+ * The builder must not touch the actor, capture the property values by copy instead. It must not create engine objects
+ * either, NewObject is for the game thread only: return plain data such as FMeshBuffers and create the object in Apply.
+ */
+template <class T>
+class TAsyncRebuild
+{
+public:
+	[[nodiscard]] bool IsBusy() const { return Pending.valid(); }
+
+	// Launch the builder on a worker thread, return false if a rebuild is still in flight
+	template <class FBuilder>
+	bool Launch(FBuilder&& Builder)
+	{
+		if (IsBusy())
+			return false;
+		Pending = std::async(std::launch::async, std::forward<FBuilder>(Builder));
+		return true;
+	}
+
+	// Apply the finished result if there is one, should be called on the game thread once per frame
+	template <class FApply>
+	bool Poll(FApply&& Apply)
+	{
+		if (!IsBusy() || Pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return false;
+		Apply(Pending.get());
+		return true;
+	}
+
+protected:
+	std::future<T> Pending;
+};
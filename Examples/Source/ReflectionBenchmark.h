@@ -0,0 +1,244 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include "CommandLine.h"
+#include "CoreMinimal.h"
+#include "ReflectionTable.h"
+
+/**
+ * Save and load NumObjects reflected objects with the binary serializer generated from their ReflectionTable,
+ * compared with a serializer driven by runtime property descriptors: each value is written with its property name and
+ * found again by name on load, as a walk over the runtime accessors does. Reported as JSON, best of three runs.
+ * Run it with
+ *	MechEngineExamples --reflection-benchmark [--objects N] [--out result.json]
+ */
+namespace ReflectionBenchmark
+{
+	// Stand-in for a reflected actor, the engine's MCLASS objects need the editor to be created.
+	// Vectors are plain arrays, the binary serializer only takes trivially copyable properties
+	struct FReflectedActor
+	{
+		std::array<double, 3> Translation = { 0., 0., 0. };
+		std::array<double, 3> Rotation = { 0., 0., 0. };
+		std::array<double, 3> Scale = { 1., 1., 1. };
+		double				  Mass = 1.;
+		float				  Alpha = 1.f;
+		int					  Layer = 0;
+		bool				  bVisible = true;
+
+		static constexpr auto PropertyTable()
+		{
+			using namespace ReflectionTable;
+			return MakeTable(
+				REFLECTION_PROPERTY(FReflectedActor, Translation),
+				REFLECTION_PROPERTY(FReflectedActor, Rotation),
+				REFLECTION_PROPERTY(FReflectedActor, Scale),
+				REFLECTION_PROPERTY(FReflectedActor, Mass),
+				REFLECTION_PROPERTY(FReflectedActor, Alpha),
+				REFLECTION_PROPERTY(FReflectedActor, Layer),
+				REFLECTION_PROPERTY(FReflectedActor, bVisible));
+		}
+	};
+
+	struct FRuntimeProperty
+	{
+		String Name;
+		size_t Offset;
+		size_t Size;
+	};
+
+	// The descriptors a runtime reflection system would hand out, built from the table so both sides store the same data
+	inline TArray<FRuntimeProperty> RuntimeProperties()
+	{
+		TArray<FRuntimeProperty> Result;
+		FReflectedActor			 Object;
+		FReflectedActor::PropertyTable().ForEach([&](const auto& Property) {
+			const auto* Value = reinterpret_cast<const uint8_t*>(&Property.Get(Object));
+			Result.push_back({ String(Property.Name), static_cast<size_t>(Value - reinterpret_cast<const uint8_t*>(&Object)), sizeof(Property.Get(Object)) });
+		});
+		return Result;
+	}
+
+	inline void SaveByName(const TArray<FReflectedActor>& Objects, const TArray<FRuntimeProperty>& Properties, TArray<uint8_t>& Out)
+	{
+		for (const FReflectedActor& Object : Objects)
+			for (const FRuntimeProperty& Property : Properties)
+			{
+				auto NameLength = static_cast<uint8_t>(Property.Name.size());
+				Out.push_back(NameLength);
+				Out.insert(Out.end(), Property.Name.begin(), Property.Name.end());
+				const auto* Value = reinterpret_cast<const uint8_t*>(&Object) + Property.Offset;
+				Out.insert(Out.end(), Value, Value + Property.Size);
+			}
+	}
+
+	inline bool LoadByName(TArray<FReflectedActor>& Objects, const TArray<FRuntimeProperty>& Properties, std::span<const uint8_t> Data)
+	{
+		std::unordered_map<std::string_view, const FRuntimeProperty*> ByName;
+		for (const FRuntimeProperty& Property : Properties)
+			ByName[Property.Name] = &Property;
+		size_t Cursor = 0;
+		for (FReflectedActor& Object : Objects)
+			for (size_t i = 0; i < Properties.size(); i++)
+			{
+				if (Cursor >= Data.size() || Cursor + 1 + Data[Cursor] > Data.size())
+					return false;
+				std::string_view Name(reinterpret_cast<const char*>(Data.data() + Cursor + 1), Data[Cursor]);
+				Cursor += 1 + Name.size();
+				auto It = ByName.find(Name);
+				if (It == ByName.end() || Cursor + It->second->Size > Data.size())
+					return false;
+				std::memcpy(reinterpret_cast<uint8_t*>(&Object) + It->second->Offset, Data.data() + Cursor, It->second->Size);
+				Cursor += It->second->Size;
+			}
+		return Cursor == Data.size();
+	}
+
+	struct FResult
+	{
+		double SaveSeconds = std::numeric_limits<double>::max();
+		double LoadSeconds = std::numeric_limits<double>::max();
+		size_t Bytes = 0;
+		bool   RoundTrip = false;
+	};
+
+	// Time Function in seconds, keeping the minimum in Best
+	template <class FunctionT>
+	void Time(double& Best, FunctionT&& Function)
+	{
+		auto StartTime = std::chrono::steady_clock::now();
+		Function();
+		Best = std::min(Best, std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count());
+	}
+
+	inline TArray<FReflectedActor> MakeObjects(int NumObjects)
+	{
+		TArray<FReflectedActor> Result(NumObjects);
+		for (int i = 0; i < NumObjects; i++)
+		{
+			Result[i].Translation = { static_cast<double>(i % 101), static_cast<double>(i % 103), static_cast<double>(i % 107) };
+			Result[i].Rotation = { 0., 0., i * 1e-3 };
+			Result[i].Mass = 1. + i % 17;
+			Result[i].Layer = i % 8;
+			Result[i].bVisible = i % 3 != 0;
+		}
+		return Result;
+	}
+
+	inline bool SameObjects(const TArray<FReflectedActor>& A, const TArray<FReflectedActor>& B)
+	{
+		bool Result = A.size() == B.size();
+		for (size_t i = 0; Result && i < A.size(); i++)
+			Result = A[i].Translation == B[i].Translation && A[i].Rotation == B[i].Rotation && A[i].Scale == B[i].Scale
+				&& A[i].Mass == B[i].Mass && A[i].Alpha == B[i].Alpha && A[i].Layer == B[i].Layer && A[i].bVisible == B[i].bVisible;
+		return Result;
+	}
+
+	inline FResult RunTable(const TArray<FReflectedActor>& Objects)
+	{
+		FResult Result;
+		TArray<const FReflectedActor*> Sources;
+		for (const auto& Object : Objects)
+			Sources.push_back(&Object);
+		for (int Run = 0; Run < 3; Run++)
+		{
+			TArray<uint8_t>			Buffer;
+			TArray<FReflectedActor> Loaded(Objects.size());
+			TArray<FReflectedActor*> Targets;
+			for (auto& Object : Loaded)
+				Targets.push_back(&Object);
+			Time(Result.SaveSeconds, [&] { ReflectionTable::Save<FReflectedActor>(Sources, Buffer); });
+			std::span<const uint8_t> Data = Buffer;
+			Time(Result.LoadSeconds, [&] { Result.RoundTrip = ReflectionTable::Load<FReflectedActor>(Targets, Data); });
+			Result.RoundTrip &= SameObjects(Objects, Loaded);
+			Result.Bytes = Buffer.size();
+		}
+		return Result;
+	}
+
+	inline FResult RunByName(const TArray<FReflectedActor>& Objects)
+	{
+		FResult					 Result;
+		TArray<FRuntimeProperty> Properties = RuntimeProperties();
+		for (int Run = 0; Run < 3; Run++)
+		{
+			TArray<uint8_t>			Buffer;
+			TArray<FReflectedActor> Loaded(Objects.size());
+			Time(Result.SaveSeconds, [&] { SaveByName(Objects, Properties, Buffer); });
+			Time(Result.LoadSeconds, [&] { Result.RoundTrip = LoadByName(Loaded, Properties, Buffer); });
+			Result.RoundTrip &= SameObjects(Objects, Loaded);
+			Result.Bytes = Buffer.size();
+		}
+		return Result;
+	}
+
+	inline void WriteResult(std::ostringstream& Json, const char* Name, const FResult& Result)
+	{
+		Json << "\t\t{ \"Serializer\": \"" << Name << "\", \"SaveSeconds\": " << Result.SaveSeconds << ", \"LoadSeconds\": " << Result.LoadSeconds
+			 << ", \"Bytes\": " << Result.Bytes << ", \"RoundTrip\": " << (Result.RoundTrip ? "true" : "false") << " }";
+	}
+} // namespace ReflectionBenchmark
+
+inline String RunReflectionBenchmark(int NumObjects)
+{
+	using namespace ReflectionBenchmark;
+	TArray<FReflectedActor> Objects = MakeObjects(NumObjects);
+	FResult					Table = RunTable(Objects);
+	FResult					ByName = RunByName(Objects);
+
+	std::ostringstream Json;
+	Json.precision(9);
+	Json << "{\n"
+		 << "\t\"Objects\": " << NumObjects << ",\n"
+		 << "\t\"Properties\": " << FReflectedActor::PropertyTable().Num << ",\n"
+		 << "\t\"Serializers\": [\n";
+	WriteResult(Json, "ReflectionTable", Table);
+	Json << ",\n";
+	WriteResult(Json, "RuntimeByName", ByName);
+	Json << "\n\t]\n}\n";
+	return Json.str();
+}
+
+// Entry point of the --reflection-benchmark command line mode, prints the result as JSON
+inline int ReflectionBenchmarkMain(int argc, char* argv[])
+{
+	auto PrintUsage = [] {
+		std::cerr << "Usage: MechEngineExamples --reflection-benchmark [--objects N] [--out result.json]\n";
+		return 1;
+	};
+	int	 NumObjects = 100000;
+	Path Output;
+	for (int i = 2; i < argc; i++)
+	{
+		String Option = argv[i];
+		if (Option == "--objects" && i + 1 < argc)
+		{
+			if (!ParseArgument("--objects", argv[++i], NumObjects, 1))
+				return PrintUsage();
+		}
+		else if (Option == "--out" && i + 1 < argc)
+			Output = argv[++i];
+		else
+		{
+			LOG_ERROR("Unknown benchmark option: {}", Option);
+			return PrintUsage();
+		}
+	}
+
+	String Json = RunReflectionBenchmark(NumObjects);
+	std::cout << Json;
+	if (!Output.empty())
+	{
+		std::ofstream OutFile(Output);
+		if (!(OutFile << Json))
+		{
+			LOG_ERROR("Failed to write benchmark result: {}", Output.string());
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,331 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include "CoreMinimal.h"
+#include "Object/Object.h"
+
+/**
+ * Compile-time reflection tables.
+ * A class exposes its MPROPERTY fields through a static constexpr PropertyTable(), with the tags stored as typed values.
+ * Lookup by tag type is resolved at compile time, and lookup by name goes through a constexpr hash table,
+ * so neither needs RTTI nor a scan over the runtime tag list.
+ * The same table drives a flat binary serializer, see Save/Load below.
+ * The table mirrors the MPROPERTY declarations, which are parsed by the engine's header tool and cannot be generated
+ * from here. REFLECTION_PROPERTY takes the name from the member, and MatchesReflection checks the property list and the
+ * tag values against the generated metadata, so a table out of sync is caught the first time the class is used.
+ *
+ * Usage:
+ *	static constexpr auto PropertyTable()
+ *	{
+ *		using namespace ReflectionTable;
+ *		return MakeTable(REFLECTION_PROPERTY(MyCylinder, Radius, Slide{0.1, 1.}, Category{"MyProperty"}));
+ *	}
+ */
+#define REFLECTION_PROPERTY(Class, Member, ...) ReflectionTable::Property(#Member, &Class::Member __VA_OPT__(,) __VA_ARGS__)
+
+namespace ReflectionTable
+{
+	// Typed counterparts of the Slide_, Step_ and Category_ property tags
+	struct Slide
+	{
+		double Min, Max;
+	};
+
+	struct Step
+	{
+		double Value, FastValue;
+	};
+
+	struct Category
+	{
+		std::string_view Name;
+	};
+
+	// Name of T for the layout hash, fixed for the common types and taken from the compiler for the others
+	template <class T>
+	constexpr std::string_view TypeName()
+	{
+		if constexpr (std::is_same_v<T, bool>) return "bool";
+		else if constexpr (std::is_same_v<T, int>) return "int";
+		else if constexpr (std::is_same_v<T, float>) return "float";
+		else if constexpr (std::is_same_v<T, double>) return "double";
+		else if constexpr (std::is_same_v<T, FVector>) return "FVector";
+		else
+		{
+			// The signature spells T, so distinct types never share a name. It differs between compilers,
+			// the binary format of such types is only portable between builds of the same compiler
+#if defined(_MSC_VER)
+			return std::string_view(__FUNCSIG__);
+#else
+			return std::string_view(__PRETTY_FUNCTION__);
+#endif
+		}
+	}
+
+	// FNV-1a, also used to version the binary layout
+	constexpr uint64_t Hash(std::string_view Str, uint64_t Seed = 14695981039346656037ull)
+	{
+		for (char C : Str)
+			Seed = (Seed ^ static_cast<uint8_t>(C)) * 1099511628211ull;
+		return Seed;
+	}
+
+	template <class ClassT, class ValueT, class... TagTs>
+	struct TPropertyDescriptor
+	{
+		using FClass = ClassT;
+		using FValue = ValueT;
+
+		std::string_view Name;
+		ValueT ClassT::*Member;
+		std::tuple<TagTs...> Tags;
+
+		template <class TagT>
+		static constexpr bool HasTag = (std::is_same_v<TagT, TagTs> || ...);
+
+		template <class TagT>
+		constexpr const TagT& GetTag() const { return std::get<TagT>(Tags); }
+
+		static constexpr std::string_view GetTypeName() { return TypeName<ValueT>(); }
+
+		ValueT&		  Get(ClassT& Object) const { return Object.*Member; }
+		const ValueT& Get(const ClassT& Object) const { return Object.*Member; }
+	};
+
+	template <class ClassT, class ValueT, class... TagTs>
+	constexpr auto Property(std::string_view Name, ValueT ClassT::*Member, TagTs... Tags)
+	{
+		return TPropertyDescriptor<ClassT, ValueT, TagTs...>{ Name, Member, { Tags... } };
+	}
+
+	template <class... DescriptorTs>
+	struct TPropertyTable
+	{
+		static constexpr size_t Num = sizeof...(DescriptorTs);
+		// Open addressing hash table from name to property index, at most half full
+		static constexpr size_t HashCapacity = std::bit_ceil(Num * 2 + 1);
+
+		std::tuple<DescriptorTs...>			  Properties;
+		std::array<std::string_view, Num> Names{};
+		std::array<int, HashCapacity>	  NameSlots{};
+
+		constexpr explicit TPropertyTable(DescriptorTs... InProperties)
+			: Properties(InProperties...)
+		{
+			NameSlots.fill(-1);
+			int Index = 0;
+			ForEach([&](const auto& Property) {
+				size_t Slot = Hash(Property.Name) & (HashCapacity - 1);
+				while (NameSlots[Slot] != -1)
+					Slot = (Slot + 1) & (HashCapacity - 1);
+				Names[Index] = Property.Name;
+				NameSlots[Slot] = Index++;
+			});
+		}
+
+		template <size_t I>
+		constexpr const auto& Get() const { return std::get<I>(Properties); }
+
+		template <class FunctionT>
+		constexpr void ForEach(FunctionT&& Function) const
+		{
+			std::apply([&](const auto&... Property) { (Function(Property), ...); }, Properties);
+		}
+
+		// Visit only the properties carrying TagT, the filter is resolved at compile time
+		template <class TagT, class FunctionT>
+		constexpr void ForEachWithTag(FunctionT&& Function) const
+		{
+			ForEach([&](const auto& Property) {
+				if constexpr (std::decay_t<decltype(Property)>::template HasTag<TagT>)
+					Function(Property, Property.template GetTag<TagT>());
+			});
+		}
+
+		// Index of the property with Name, or -1. Constant time, and evaluated at compile time for constant names
+		constexpr int IndexOf(std::string_view Name) const
+		{
+			size_t Slot = Hash(Name) & (HashCapacity - 1);
+			while (NameSlots[Slot] != -1)
+			{
+				int Index = NameSlots[Slot];
+				if (Names[Index] == Name)
+					return Index;
+				Slot = (Slot + 1) & (HashCapacity - 1);
+			}
+			return -1;
+		}
+
+		constexpr std::string_view NameAt(int Index) const { return Names[Index]; }
+
+		// Invoke Function with the property at a runtime index
+		template <class FunctionT>
+		constexpr bool Visit(int Index, FunctionT&& Function) const
+		{
+			int Current = 0;
+			ForEach([&](const auto& Property) {
+				if (Current++ == Index)
+					Function(Property);
+			});
+			return Index >= 0 && Index < static_cast<int>(Num);
+		}
+
+		// Layout version, changes when a property is added, removed, renamed or retyped
+		constexpr uint64_t LayoutHash() const
+		{
+			uint64_t Result = Hash("");
+			ForEach([&](const auto& Property) {
+				Result = Hash(Property.Name, Result);
+				Result = Hash(Property.GetTypeName(), Result);
+				Result = (Result ^ sizeof(typename std::decay_t<decltype(Property)>::FValue)) * 1099511628211ull;
+			});
+			return Result;
+		}
+
+		// Size in bytes of one object in the binary format
+		static constexpr size_t PayloadSize() { return (sizeof(typename DescriptorTs::FValue) + ... + 0); }
+	};
+
+	template <class... DescriptorTs>
+	constexpr auto MakeTable(DescriptorTs... Properties)
+	{
+		return TPropertyTable<DescriptorTs...>(Properties...);
+	}
+
+	/**
+	 * Flat binary serializer generated from the table.
+	 * The stream is a layout hash and an object count, followed by the properties of each object packed back to back.
+	 * Only trivially copyable properties are supported, which is checked at compile time.
+	 */
+	template <class ClassT>
+	void Save(std::span<const ClassT* const> Objects, TArray<uint8_t>& Out)
+	{
+		constexpr auto Table = ClassT::PropertyTable();
+		Table.ForEach([](const auto& Property) {
+			static_assert(std::is_trivially_copyable_v<typename std::decay_t<decltype(Property)>::FValue>,
+				"Binary serialization requires trivially copyable properties");
+		});
+
+		const uint64_t LayoutHash = Table.LayoutHash();
+		const uint64_t Count = Objects.size();
+		size_t		   Offset = Out.size();
+		Out.resize(Offset + sizeof(LayoutHash) + sizeof(Count) + Count * Table.PayloadSize());
+		uint8_t* Cursor = Out.data() + Offset;
+		std::memcpy(Cursor, &LayoutHash, sizeof(LayoutHash)); Cursor += sizeof(LayoutHash);
+		std::memcpy(Cursor, &Count, sizeof(Count)); Cursor += sizeof(Count);
+		for (const ClassT* Object : Objects)
+		{
+			Table.ForEach([&](const auto& Property) {
+				const auto& Value = Property.Get(*Object);
+				std::memcpy(Cursor, &Value, sizeof(Value));
+				Cursor += sizeof(Value);
+			});
+		}
+	}
+
+	// Classes with this member are told about each property whose value was changed by Load, as PostEdit is by the editor
+	template <class ClassT>
+	concept CPostLoadProperty = requires(ClassT& Object, std::string_view Name) { Object.PostLoadProperty(Name); };
+
+	/**
+	 * Load properties saved by Save into Objects, which must have the saved count.
+	 * Return false on a layout mismatch or a truncated stream, and advance Data past the consumed bytes on success.
+	 * Changed properties are reported to ClassT::PostLoadProperty(Name) when the class has it, e.g. to mark derived data dirty.
+	 */
+	template <class ClassT>
+	bool Load(std::span<ClassT* const> Objects, std::span<const uint8_t>& Data)
+	{
+		constexpr auto Table = ClassT::PropertyTable();
+		uint64_t	   LayoutHash = 0, Count = 0;
+		if (Data.size() < sizeof(LayoutHash) + sizeof(Count))
+			return false;
+		std::memcpy(&LayoutHash, Data.data(), sizeof(LayoutHash));
+		std::memcpy(&Count, Data.data() + sizeof(LayoutHash), sizeof(Count));
+		const size_t Size = sizeof(LayoutHash) + sizeof(Count) + Count * Table.PayloadSize();
+		if (LayoutHash != Table.LayoutHash() || Count != Objects.size() || Data.size() < Size)
+			return false;
+
+		const uint8_t* Cursor = Data.data() + sizeof(LayoutHash) + sizeof(Count);
+		for (ClassT* Object : Objects)
+		{
+			Table.ForEach([&](const auto& Property) {
+				auto& Value = Property.Get(*Object);
+				if constexpr (CPostLoadProperty<ClassT>)
+				{
+					if (std::memcmp(&Value, Cursor, sizeof(Value)) != 0)
+					{
+						std::memcpy(&Value, Cursor, sizeof(Value));
+						Object->PostLoadProperty(Property.Name);
+					}
+				}
+				else
+					std::memcpy(&Value, Cursor, sizeof(Value));
+				Cursor += sizeof(Value);
+			});
+		}
+		Data = Data.subspan(Size);
+		return true;
+	}
+
+	/**
+	 * Check the table of ClassT against the metadata generated from its MPROPERTY declarations: the same property names,
+	 * and the same Slide and Category values. Mismatches are logged. Call it once per class, e.g. in a debug assertion.
+	 */
+	template <class ClassT>
+	bool MatchesReflection(ClassT& Object)
+	{
+		constexpr auto Table = ClassT::PropertyTable();
+		auto		   Accessors = Object.GetAllPropertyAccessors();
+		bool		   Matches = Accessors.size() == Table.Num;
+		if (!Matches)
+			LOG_ERROR("{} reflects {} properties, its table has {}", TypeName<ClassT>(), Accessors.size(), Table.Num);
+		auto NearlyEqual = [](double A, double B) { return std::abs(A - B) <= 1e-6 * std::max(1., std::abs(A)); };
+		for (auto& Accessor : Accessors)
+		{
+			std::string_view Name = Accessor.getFieldName();
+			int				 Index = Table.IndexOf(Name);
+			if (Index < 0)
+			{
+				LOG_ERROR("Property {} is missing from the table of {}", Name, TypeName<ClassT>());
+				Matches = false;
+				continue;
+			}
+			Table.Visit(Index, [&](const auto& Property) {
+				using FDescriptor = std::decay_t<decltype(Property)>;
+				bool TagsMatch = true;
+				for (const PropertyTag* Tag : Accessor.GetPropertyTags())
+				{
+					if (auto EngineSlide = dynamic_cast<const Slide_*>(Tag))
+					{
+						if constexpr (FDescriptor::template HasTag<Slide>)
+							TagsMatch &= NearlyEqual(EngineSlide->GetMin(), Property.template GetTag<Slide>().Min)
+								&& NearlyEqual(EngineSlide->GetMax(), Property.template GetTag<Slide>().Max);
+						else
+							TagsMatch = false;
+					}
+					else if (auto EngineCategory = dynamic_cast<const Category_*>(Tag))
+					{
+						if constexpr (FDescriptor::template HasTag<Category>)
+							TagsMatch &= EngineCategory->ParseCategory()[0] == Property.template GetTag<Category>().Name;
+						else
+							TagsMatch = false;
+					}
+				}
+				if (!TagsMatch)
+				{
+					LOG_ERROR("Tags of {} differ between the table and the MPROPERTY declaration", Name);
+					Matches = false;
+				}
+			});
+		}
+		return Matches;
+	}
+} // namespace ReflectionTable
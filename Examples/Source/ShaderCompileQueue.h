@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include "CoreMinimal.h"
+#include "Profiler.h"
+#include "Game/World.h"
+#include "Materials/Material.h"
+#include "Render/GpuSceneInterface.h"
+
+/**
+ * Deferred and coalesced shader compilation.
+ * GpuSceneInterface::CompileShader rebuilds the whole megakernel, so calling it after every BindShader stalls
+ * once per binding. Bind shaders through this queue instead and call Flush at the frame boundary:
+ * all bindings of a frame are compiled once, and nothing is compiled when the kernel already contains
+ * every bound shader, e.g. when rebinding a shader or removing a material. Shaders are told apart by the name they are bound with.
+ * The compile itself is still synchronous, a background compile with a kernel hot swap needs support in GpuSceneInterface.
+ * Flush once after the initial bindings so the first frame already renders with them.
+ * Usage:
+ *	Shaders->BindShader<my_shader>(Material, "my_shader");
+ *	Shaders->Flush(world);
+ *	world.TickFunction = [Shaders](double, World& world) { Shaders->Flush(world); };
+ */
+class ShaderCompileQueue
+{
+public:
+	// Bind a shader class to a material, can be called from any thread. The material is modified in Flush, on the game thread.
+	// ShaderName identifies the shader class, a compile is needed only when a name was not compiled yet
+	template <class ShaderT>
+	void BindShader(const ObjectPtr<Material>& InMaterial, const String& ShaderName)
+	{
+		std::lock_guard Lock(Mutex);
+		auto It = std::find_if(Bindings.begin(), Bindings.end(), [&](const FBinding& Binding) { return Binding.Target.lock() == InMaterial; });
+		FBinding& Binding = It == Bindings.end() ? Bindings.emplace_back() : *It;
+		Binding.Target = InMaterial;
+		Binding.ShaderName = ShaderName;
+		Binding.Bind = [](Material& Target) { Target.BindShader<ShaderT>(); };
+		CompilePending = true;
+	}
+
+	// Force a compile at the next Flush, e.g. after binding shaders directly on the material
+	void RequestCompile()
+	{
+		std::lock_guard Lock(Mutex);
+		CompilePending = true;
+		ForceCompile = true;
+	}
+
+	/**
+	 * Compile the pending bindings, call once per frame on the game thread.
+	 * @return true if the shader was recompiled
+	 */
+	bool Flush(World& InWorld)
+	{
+		PROFILE_SCOPE("ShaderCompileQueue::Flush");
+		std::unique_lock Lock(Mutex);
+		if (!CompilePending)
+			return false;
+		CompilePending = false;
+
+		// Materials that were destroyed do not need their class anymore
+		std::erase_if(Bindings, [](const FBinding& Binding) { return Binding.Target.expired(); });
+		TArray<String> ShaderNames;
+		for (auto& Binding : Bindings)
+		{
+			if (auto Target = Binding.Target.lock(); Target && Binding.Bind)
+			{
+				Binding.Bind(*Target);
+				Binding.Bind = nullptr;
+			}
+			ShaderNames.push_back(Binding.ShaderName);
+		}
+		std::sort(ShaderNames.begin(), ShaderNames.end());
+		ShaderNames.erase(std::unique(ShaderNames.begin(), ShaderNames.end()), ShaderNames.end());
+
+		bool Covered = std::all_of(ShaderNames.begin(), ShaderNames.end(), [this](const String& ShaderName) {
+			return std::binary_search(CompiledShaders.begin(), CompiledShaders.end(), ShaderName);
+		});
+		if (Covered && !ForceCompile)
+			return false;
+		ForceCompile = false;
+		Lock.unlock();
+
+		auto StartTime = std::chrono::steady_clock::now();
+		InWorld.GetScene()->CompileShader();
+		double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+		LOG_INFO("Compiled the shader with {} bound shaders in {:.2f}s", ShaderNames.size(), Seconds);
+		CompiledShaders = std::move(ShaderNames);
+		return true;
+	}
+
+	[[nodiscard]] bool IsCompilePending() const
+	{
+		std::lock_guard Lock(Mutex);
+		return CompilePending;
+	}
+
+protected:
+	struct FBinding
+	{
+		WeakObjectPtr<Material>		   Target;
+		String						   ShaderName;
+		std::function<void(Material&)> Bind; // Not applied to Target yet
+	};
+
+	mutable std::mutex Mutex;
+	TArray<FBinding>   Bindings;
+	TArray<String>	   CompiledShaders; // Sorted
+	bool			   CompilePending = false;
+	bool			   ForceCompile = false;
+};
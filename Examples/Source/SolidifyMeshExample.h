@@ -3,10 +3,12 @@
 //
 
 #pragma once
+#include <algorithm>
+#include "GeometryJobQueue.h"
 #include "LambdaUIWidget.h"
-#include "Algorithm/GeometryProcess.h"
 #include "Game/StaticMeshActor.h"
 #include "Misc/Path.h"
+#include "MeshNormals.h"
 
 /**************************************************************************************************
  * SolidifyMeshExample
@@ -14,6 +16,59 @@
  * User can provide either a closed mesh or a open mesh, the algorithm will work for both cases.
  **************************************************************************************************/
 
+/**
+ * Thicken a surface into a solid: the surface and its copy offset by Thickness along the vertex normals, facing away from
+ * each other, joined by walls along the boundary edges. A closed surface gets no walls, the result is two nested shells.
+ * The buffer counterpart of Algorithm::GeometryProcess::SolidifyMesh, it creates no engine object so it can run in a job.
+ * Returns empty buffers as soon as Token is cancelled.
+ */
+inline FMeshBuffers SolidifyBuffers(const FMeshBuffers& Mesh, const TArray<FVector>& VertexNormals, double Thickness, const FCancellationToken& Token)
+{
+	int			 NumVertices = Mesh.NumVertices();
+	FMeshBuffers Result;
+	Result.Vertices = Mesh.Vertices;
+	Result.Vertices.reserve(NumVertices * 2);
+	for (int Vertex = 0; Vertex < NumVertices; Vertex++)
+	{
+		if (Vertex % 4096 == 0 && Token.IsCancelled())
+			return {};
+		Result.Vertices.push_back(Mesh.Vertices[Vertex] + VertexNormals[Vertex] * Thickness);
+	}
+
+	// The copy on the normals' side faces outwards, the other one is reversed
+	bool bFlipSource = Thickness > 0.;
+	auto Add = [&Result](int A, int B, int C, bool bFlip) {
+		if (bFlip)
+			Result.Triangles.emplace_back(C, B, A);
+		else
+			Result.Triangles.emplace_back(A, B, C);
+	};
+	TArray<uint64_t> HalfEdges;
+	for (int Face = 0; Face < Mesh.NumTriangles(); Face++)
+	{
+		if (Face % 4096 == 0 && Token.IsCancelled())
+			return {};
+		const Vector3i& Triangle = Mesh.Triangles[Face];
+		Add(Triangle[0], Triangle[1], Triangle[2], bFlipSource);
+		Add(Triangle[0] + NumVertices, Triangle[1] + NumVertices, Triangle[2] + NumVertices, !bFlipSource);
+		for (int Corner = 0; Corner < 3; Corner++)
+			HalfEdges.push_back(static_cast<uint64_t>(Triangle[Corner]) << 32 | static_cast<uint32_t>(Triangle[(Corner + 1) % 3]));
+	}
+	std::sort(HalfEdges.begin(), HalfEdges.end());
+	if (Token.IsCancelled())
+		return {};
+	for (uint64_t HalfEdge : HalfEdges)
+	{
+		int From = static_cast<int>(HalfEdge >> 32), To = static_cast<int>(HalfEdge & 0xFFFFFFFFu);
+		if (std::binary_search(HalfEdges.begin(), HalfEdges.end(), static_cast<uint64_t>(To) << 32 | static_cast<uint32_t>(From)))
+			continue;
+		// A quad from the boundary edge to its offset copy, using both edges against their faces' direction
+		Add(To, From, From + NumVertices, bFlipSource);
+		Add(To, From + NumVertices, To + NumVertices, bFlipSource);
+	}
+	return Result;
+}
+
 inline auto SolidifyMeshExample()
 {
 	return [](World& World)
@@ -21,17 +76,32 @@ inline auto SolidifyMeshExample()
 		auto Mesh = StaticMesh::LoadObj( Path::ProjectContentDir() / "openbunny.obj");
 		LOG_TEMP("{}", Mesh->GetVertexNum());
 		auto Actor = World.SpawnActor<StaticMeshActor>("SolidifiedBunny", Mesh);
-		World.AddWidget<LambdaUIWidget>([Mesh, Actor]() {
+		// The normals do not depend on the thickness, the jobs only offset and stitch the buffers
+		auto Source = std::make_shared<const FMeshBuffers>(FMeshBuffers::FromStaticMesh(*Mesh));
+		auto Normals = std::make_shared<MeshNormals>(MeshAdjacencyCache::Get().Find(Mesh, *Source), Source->Triangles);
+		Normals->Compute(Source->Vertices);
+		auto Jobs = std::make_shared<GeometryJobQueue>();
+		World.AddWidget<LambdaUIWidget>([Mesh, Actor, Source, Normals, Jobs]() {
 			if(ImGui::Begin("Adjust Solidify Mesh Thickness"))
 			{
 				static float Thickness = 0;
 				if(ImGui::SliderFloat("Thickness", &Thickness, -1, 1))
 				{
-					auto NewMesh = Algorithm::GeometryProcess::SolidifyMesh(Mesh, Thickness);
-					Actor->GetStaticMeshComponent()->SetMeshData(NewMesh);
+					// Solidified in the background, only the latest thickness is kept while dragging.
+					// The job returns buffers, the StaticMesh is created on the game thread when the result is delivered
+					Jobs->Submit("Solidify", [Source, Normals, Thickness = Thickness](const FCancellationToken& Token) {
+						return SolidifyBuffers(*Source, Normals->GetVertexNormals(), Thickness, Token);
+					}, [Mesh, Actor](const FMeshBuffers& Result) {
+						auto NewMesh = Result.ToStaticMesh();
+						NewMesh->SetMaterial(Mesh->GetMaterial());
+						Actor->GetStaticMeshComponent()->SetMeshData(NewMesh);
+					});
 				}
+				if(Jobs->IsBusy())
+					ImGui::Text("Solidifying...");
 				ImGui::End();
 			}
 		});
+		World.TickFunction = [Jobs](double, auto&) { Jobs->Flush(); };
 	};
 }
\ No newline at end of file
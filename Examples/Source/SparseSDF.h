@@ -0,0 +1,638 @@
+#pragma once
+#include <queue>
+#include <unordered_map>
+#include "CoreMinimal.h"
+#include "CpuBVH.h"
+#include "JobSystem.h"
+#include "MeshBuffers.h"
+#include "MeshCache.h"
+#include "Surface/OrientedSurfaceComponent.h"
+
+/**
+ * Signed distance field on a sparse voxel grid, negative inside, for fast approximate booleans.
+ * Only the bricks of BrickSize^3 voxels around the surface store distances, clamped to a narrow band of BandVoxels.
+ * The bricks enclosed by the surface are constant inside tiles and everything else is outside, so memory follows the surface area.
+ * Voxel (i, j, k) sits at (i, j, k) * VoxelSize, grids of the same voxel size share the lattice and CSG is a min/max per voxel.
+ * Usage:
+ *	auto Part = SparseSDFCache::Get().Find(Mesh, 0.01);
+ *	auto Cutter = SparseSDF::FromSignedDistance(Bounds, 0.01, [&](const FVector& P) { return (P - Center).norm() - Radius; });
+ *	ObjectPtr<StaticMesh> Preview = SparseSDF::Subtract(*Part, Cutter).Extract().ToStaticMesh();
+ * OrientedSurfaceComponents convert with FromOrientedSurface and AddOrientedSurface.
+ */
+class SparseSDF
+{
+public:
+	static constexpr int BrickSize = 8;
+	static constexpr int BrickVoxels = BrickSize * BrickSize * BrickSize;
+	static constexpr int BandVoxels = 3; // More than one voxel, so neighbors across the band edge have the same sign
+	static constexpr int Grain = 4;
+
+	SparseSDF() = default;
+	explicit SparseSDF(double InVoxelSize) : VoxelSize(InVoxelSize), Background(static_cast<float>(BandVoxels * InVoxelSize)) {}
+
+	[[nodiscard]] double GetVoxelSize() const { return VoxelSize; }
+	[[nodiscard]] int	 NumBricks() const { return static_cast<int>(BrickCoords.size()); }
+	[[nodiscard]] int	 NumInsideTiles() const { return static_cast<int>(Bricks.size()) - NumBricks(); }
+
+	// Clamped distance at voxel Coord
+	[[nodiscard]] float GetVoxel(const Vector3i& Coord) const
+	{
+		auto It = Bricks.find(BrickKey(BrickOf(Coord)));
+		if (It == Bricks.end())
+			return Background;
+		if (It->second == InsideTile)
+			return -Background;
+		return Values[It->second * BrickVoxels + LocalIndex(Coord - BrickOf(Coord) * BrickSize)];
+	}
+
+	// Trilinear interpolation of the voxels, the distance to the surface within the band
+	[[nodiscard]] double SignedDistance(const FVector& Point) const
+	{
+		FVector	 Grid = Point / VoxelSize;
+		FVector	 Floor = Grid.array().floor();
+		FVector	 T = Grid - Floor;
+		Vector3i Base = Floor.cast<int>();
+		double	 Result = 0.;
+		for (int Corner = 0; Corner < 8; Corner++)
+		{
+			Vector3i Offset(Corner & 1, Corner >> 1 & 1, Corner >> 2 & 1);
+			double	 Weight = 1.;
+			for (int Axis = 0; Axis < 3; Axis++)
+				Weight *= Offset[Axis] ? T[Axis] : 1. - T[Axis];
+			Result += Weight * GetVoxel(Base + Offset);
+		}
+		return Result;
+	}
+
+	/**
+	 * Narrow band voxelization of a closed triangle mesh.
+	 * Each band brick gathers the triangles near it from a BVH and splats their distances, the sign comes from the angle
+	 * weighted pseudo normals of the closest feature (Baerentzen and Aanaes). The bricks enclosed by the band are found
+	 * with a flood fill from outside.
+	 */
+	static SparseSDF FromMesh(const FMeshBuffers& Mesh, double VoxelSize, JobSystem& Jobs = JobSystem::Get())
+	{
+		PROFILE_SCOPE("SparseSDF::FromMesh");
+		SparseSDF Result(VoxelSize);
+		int		  NumTriangles = Mesh.NumTriangles();
+		if (NumTriangles == 0)
+			return Result;
+
+		// Pseudo normals: angle weighted at the vertices, the two faces summed at the edges
+		TArray<FVector> FaceNormals(NumTriangles);
+		TArray<FVector> VertexNormals(Mesh.NumVertices(), FVector::Zero());
+		TArray<FVector> EdgeNormals(NumTriangles * 3);
+		std::unordered_map<uint64_t, FVector> EdgeSums;
+		auto EdgeOf = [](int From, int To) { return static_cast<uint64_t>(std::min(From, To)) << 32 | static_cast<uint32_t>(std::max(From, To)); };
+		for (int Face = 0; Face < NumTriangles; Face++)
+		{
+			const Vector3i& Triangle = Mesh.Triangles[Face];
+			FaceNormals[Face] = (Mesh.Vertices[Triangle[1]] - Mesh.Vertices[Triangle[0]]).cross(Mesh.Vertices[Triangle[2]] - Mesh.Vertices[Triangle[0]]).normalized();
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				FVector ToNext = (Mesh.Vertices[Triangle[(Corner + 1) % 3]] - Mesh.Vertices[Triangle[Corner]]).normalized();
+				FVector ToPrev = (Mesh.Vertices[Triangle[(Corner + 2) % 3]] - Mesh.Vertices[Triangle[Corner]]).normalized();
+				VertexNormals[Triangle[Corner]] += std::acos(std::clamp(ToNext.dot(ToPrev), -1., 1.)) * FaceNormals[Face];
+				auto [It, bNew] = EdgeSums.try_emplace(EdgeOf(Triangle[Corner], Triangle[(Corner + 1) % 3]), FVector::Zero());
+				It->second += FaceNormals[Face];
+			}
+		}
+		for (int Face = 0; Face < NumTriangles; Face++)
+			for (int Corner = 0; Corner < 3; Corner++)
+				EdgeNormals[Face * 3 + Corner] = EdgeSums[EdgeOf(Mesh.Triangles[Face][Corner], Mesh.Triangles[Face][(Corner + 1) % 3])];
+
+		// Triangle bounds grown by the band, the voxels a triangle can be the closest surface of within the band
+		float				  Band = Result.Background;
+		TArray<AlignedBox3f> TriangleBounds(NumTriangles);
+		TArray<uint64_t>	  Keys;
+		for (int Face = 0; Face < NumTriangles; Face++)
+		{
+			AlignedBox3f& Box = TriangleBounds[Face];
+			for (int Corner = 0; Corner < 3; Corner++)
+				Box.extend(Mesh.Vertices[Mesh.Triangles[Face][Corner]].cast<float>());
+			Box.min().array() -= Band;
+			Box.max().array() += Band;
+			Vector3i Min = Result.BrickOf(Result.VoxelCeil(Box.min()));
+			Vector3i Max = Result.BrickOf(Result.VoxelFloor(Box.max()));
+			for (int z = Min.z(); z <= Max.z(); z++)
+				for (int y = Min.y(); y <= Max.y(); y++)
+					for (int x = Min.x(); x <= Max.x(); x++)
+						Keys.push_back(BrickKey({ x, y, z }));
+		}
+		std::sort(Keys.begin(), Keys.end());
+		Keys.erase(std::unique(Keys.begin(), Keys.end()), Keys.end());
+		CpuBVH BVH;
+		BVH.Build(TriangleBounds);
+
+		int				NumCandidates = static_cast<int>(Keys.size());
+		TArray<float>	Candidates(static_cast<size_t>(NumCandidates) * BrickVoxels);
+		TArray<uint8_t> bBand(NumCandidates, 0);
+		Jobs.ParallelFor(NumCandidates, [&](int Candidate) {
+			Vector3i First = KeyBrick(Keys[Candidate]) * BrickSize;
+			Vector3i Last = First + Vector3i::Constant(BrickSize - 1);
+			float*	 Voxels = Candidates.data() + static_cast<size_t>(Candidate) * BrickVoxels;
+			std::fill(Voxels, Voxels + BrickVoxels, std::numeric_limits<float>::infinity());
+			AlignedBox3f BrickBox((First.cast<double>() * VoxelSize).cast<float>(), (Last.cast<double>() * VoxelSize).cast<float>());
+
+			// Splat each nearby triangle into the voxels of its grown bounds, keeping the closest
+			BVH.TraverseBox(BrickBox, [&](int Face) {
+				const Vector3i& Triangle = Mesh.Triangles[Face];
+				Vector3i		Min = Result.VoxelCeil(TriangleBounds[Face].min()).cwiseMax(First) - First;
+				Vector3i		Max = Result.VoxelFloor(TriangleBounds[Face].max()).cwiseMin(Last) - First;
+				for (int z = Min.z(); z <= Max.z(); z++)
+					for (int y = Min.y(); y <= Max.y(); y++)
+						for (int x = Min.x(); x <= Max.x(); x++)
+						{
+							FVector Point = (First + Vector3i(x, y, z)).cast<double>() * VoxelSize;
+							int		Feature;
+							FVector Closest = ClosestPointOnTriangle(Point, Mesh.Vertices[Triangle[0]], Mesh.Vertices[Triangle[1]], Mesh.Vertices[Triangle[2]], Feature);
+							float	Distance = static_cast<float>((Point - Closest).norm());
+							float&	Voxel = Voxels[LocalIndex({ x, y, z })];
+							if (Distance >= std::abs(Voxel))
+								continue;
+							const FVector& Normal = Feature < 3 ? VertexNormals[Triangle[Feature]]
+								: Feature < 6					? EdgeNormals[Face * 3 + Feature - 3]
+																: FaceNormals[Face];
+							Voxel = (Point - Closest).dot(Normal) < 0. ? -Distance : Distance;
+						}
+			});
+
+			// The voxels beyond the band take the sign of the band voxels they touch, through a flood fill in the brick
+			std::queue<int> Queue;
+			bool			bAssigned[BrickVoxels];
+			for (int Index = 0; Index < BrickVoxels; Index++)
+				if ((bAssigned[Index] = std::abs(Voxels[Index]) < Band))
+					Queue.push(Index);
+			bBand[Candidate] = !Queue.empty();
+			while (!Queue.empty())
+			{
+				int Index = Queue.front();
+				Queue.pop();
+				Vector3i Local(Index % BrickSize, Index / BrickSize % BrickSize, Index / (BrickSize * BrickSize));
+				for (int Neighbor = 0; Neighbor < 6; Neighbor++)
+				{
+					Vector3i Other = Local;
+					Other[Neighbor / 2] += Neighbor % 2 ? 1 : -1;
+					if ((Other.array() < 0).any() || (Other.array() >= BrickSize).any())
+						continue;
+					if (bAssigned[LocalIndex(Other)])
+						continue;
+					bAssigned[LocalIndex(Other)] = true;
+					Voxels[LocalIndex(Other)] = std::copysign(Band, Voxels[Index]);
+					Queue.push(LocalIndex(Other));
+				}
+			}
+		}, Grain);
+
+		for (int Candidate = 0; Candidate < NumCandidates; Candidate++)
+			if (bBand[Candidate])
+				Result.AddBrick(KeyBrick(Keys[Candidate]), Candidates.data() + static_cast<size_t>(Candidate) * BrickVoxels);
+		Result.FillInsideTiles();
+		return Result;
+	}
+
+	// Sample the signed distance of an oriented surface within Bounds, in the local space of the surface
+	static SparseSDF FromOrientedSurface(const OrientedSurfaceComponent& Surface, const AlignedBox3d& Bounds, double VoxelSize, JobSystem& Jobs = JobSystem::Get())
+	{
+		return FromSignedDistance(Bounds, VoxelSize, [&Surface](const FVector& Point) { return Surface.SignedDistance(Point); }, Jobs);
+	}
+
+	/**
+	 * The zero level set as an OrientedSurfaceComponent of Owner, so the edited shape answers inside and distance queries
+	 * like any oriented surface. The component keeps its own mesh, later edits of the field need a new one.
+	 */
+	OrientedSurfaceComponent* AddOrientedSurface(Actor& Owner) const
+	{
+		return Owner.AddComponent<OrientedSurfaceComponent>(Extract().ToStaticMesh()).get();
+	}
+
+	/**
+	 * Samples Distance, any signed distance function with a gradient of at most one, in the band bricks within Bounds.
+	 * Bricks farther from the surface than their size become tiles after one evaluation at their center.
+	 */
+	template <class FunctionT>
+	static SparseSDF FromSignedDistance(const AlignedBox3d& Bounds, double VoxelSize, FunctionT&& Distance, JobSystem& Jobs = JobSystem::Get())
+	{
+		PROFILE_SCOPE("SparseSDF::FromSignedDistance");
+		SparseSDF Result(VoxelSize);
+		Vector3i  Min = Result.BrickOf(Result.VoxelFloor(Bounds.min().cast<float>().array() - Result.Background));
+		Vector3i  Max = Result.BrickOf(Result.VoxelCeil(Bounds.max().cast<float>().array() + Result.Background));
+		Vector3i  Size = Max - Min + Vector3i::Ones();
+		int		  NumCandidates = Size.prod();
+		double	  HalfDiagonal = std::sqrt(3.) * (BrickSize - 1) * 0.5 * VoxelSize;
+
+		TArray<float>	Candidates(static_cast<size_t>(NumCandidates) * BrickVoxels);
+		TArray<uint8_t> State(NumCandidates, 0); // 0 outside, 1 band, 2 inside
+		Jobs.ParallelFor(NumCandidates, [&](int Candidate) {
+			Vector3i Brick = Min + Vector3i(Candidate % Size.x(), Candidate / Size.x() % Size.y(), Candidate / (Size.x() * Size.y()));
+			Vector3i First = Brick * BrickSize;
+			double	 Center = Distance(FVector((First.cast<double>().array() + (BrickSize - 1) * 0.5) * VoxelSize));
+			if (std::abs(Center) > HalfDiagonal + Result.Background)
+			{
+				State[Candidate] = Center < 0. ? 2 : 0;
+				return;
+			}
+			float* Voxels = Candidates.data() + static_cast<size_t>(Candidate) * BrickVoxels;
+			bool   bBand = false;
+			for (int Index = 0; Index < BrickVoxels; Index++)
+			{
+				Vector3i Local(Index % BrickSize, Index / BrickSize % BrickSize, Index / (BrickSize * BrickSize));
+				float	 Value = static_cast<float>(Distance(FVector((First + Local).cast<double>() * VoxelSize)));
+				Voxels[Index] = std::clamp(Value, -Result.Background, Result.Background);
+				bBand |= std::abs(Value) < Result.Background;
+			}
+			State[Candidate] = bBand ? 1 : Center < 0. ? 2 : 0;
+		}, Grain);
+
+		for (int Candidate = 0; Candidate < NumCandidates; Candidate++)
+		{
+			Vector3i Brick = Min + Vector3i(Candidate % Size.x(), Candidate / Size.x() % Size.y(), Candidate / (Size.x() * Size.y()));
+			if (State[Candidate] == 1)
+				Result.AddBrick(Brick, Candidates.data() + static_cast<size_t>(Candidate) * BrickVoxels);
+			else if (State[Candidate] == 2)
+				Result.Bricks[BrickKey(Brick)] = InsideTile;
+		}
+		return Result;
+	}
+
+	static SparseSDF Union(const SparseSDF& A, const SparseSDF& B, JobSystem& Jobs = JobSystem::Get())
+	{
+		return Combine(A, B, [](float a, float b) { return std::min(a, b); }, Jobs);
+	}
+
+	static SparseSDF Subtract(const SparseSDF& A, const SparseSDF& B, JobSystem& Jobs = JobSystem::Get())
+	{
+		return Combine(A, B, [](float a, float b) { return std::max(a, -b); }, Jobs);
+	}
+
+	static SparseSDF Intersect(const SparseSDF& A, const SparseSDF& B, JobSystem& Jobs = JobSystem::Get())
+	{
+		return Combine(A, B, [](float a, float b) { return std::max(a, b); }, Jobs);
+	}
+
+	/**
+	 * Zero surface as a triangle mesh, by dual contouring: one vertex per cell crossing the surface, placed at the minimum
+	 * of the quadratic error of the crossing planes, and one quad per voxel edge crossing it. The bricks are contoured in parallel.
+	 */
+	[[nodiscard]] FMeshBuffers Extract(JobSystem& Jobs = JobSystem::Get()) const
+	{
+		PROFILE_SCOPE("SparseSDF::Extract");
+		FMeshBuffers Result;
+		int			 Num = NumBricks();
+		TArray<int>	 CellVertices(static_cast<size_t>(Num) * BrickVoxels, -1);
+		TArray<TArray<FVector>> BrickVertices(Num);
+		TArray<TArray<Vector3i>> BrickTriangles(Num);
+
+		// Cells of each brick, by their lowest voxel, with their vertex index in the brick
+		Jobs.ParallelFor(Num, [&](int Brick) {
+			FBlock Block;
+			Gather(BrickCoords[Brick], Block);
+			Vector3i First = BrickCoords[Brick] * BrickSize;
+			for (int Index = 0; Index < BrickVoxels; Index++)
+			{
+				Vector3i Local(Index % BrickSize, Index / BrickSize % BrickSize, Index / (BrickSize * BrickSize));
+				int		 Mask = 0;
+				for (int Corner = 0; Corner < 8; Corner++)
+					Mask |= (Block.At(Local + Vector3i(Corner & 1, Corner >> 1 & 1, Corner >> 2 & 1)) < 0.f) << Corner;
+				if (Mask == 0 || Mask == 255)
+					continue;
+
+				Matrix3d ATA = Matrix3d::Zero();
+				FVector	 ATb = FVector::Zero();
+				FVector	 MassPoint = FVector::Zero();
+				int		 NumCrossings = 0;
+				for (int Axis = 0; Axis < 3; Axis++)
+					for (int Edge = 0; Edge < 4; Edge++)
+					{
+						Vector3i From = Local;
+						From[(Axis + 1) % 3] += Edge & 1;
+						From[(Axis + 2) % 3] += Edge >> 1;
+						Vector3i To = From + Vector3i::Unit(Axis);
+						float	 ValueFrom = Block.At(From), ValueTo = Block.At(To);
+						if ((ValueFrom < 0.f) == (ValueTo < 0.f))
+							continue;
+						double	T = ValueFrom / (ValueFrom - ValueTo);
+						FVector Point = ((First + From).cast<double>() + T * Vector3i::Unit(Axis).cast<double>()) * VoxelSize;
+						FVector Normal = ((1. - T) * Block.Gradient(From) + T * Block.Gradient(To)).normalized();
+						ATA += Normal * Normal.transpose();
+						ATb += Normal * Normal.dot(Point);
+						MassPoint += Point;
+						NumCrossings++;
+					}
+				// Pulled towards the mass point, which fixes the vertex along the flat directions of the error
+				MassPoint /= NumCrossings;
+				constexpr double Regularization = 0.05;
+				FVector			 Vertex = (ATA + Regularization * Matrix3d::Identity()).ldlt().solve(ATb + Regularization * MassPoint);
+				FVector			 CellMin = (First + Local).cast<double>() * VoxelSize;
+				Vertex = Vertex.cwiseMax(CellMin).cwiseMin(CellMin + FVector::Constant(VoxelSize));
+				CellVertices[static_cast<size_t>(Brick) * BrickVoxels + Index] = static_cast<int>(BrickVertices[Brick].size());
+				BrickVertices[Brick].push_back(Vertex);
+			}
+		}, Grain);
+
+		TArray<int> VertexOffsets(Num + 1, 0);
+		for (int Brick = 0; Brick < Num; Brick++)
+			VertexOffsets[Brick + 1] = VertexOffsets[Brick] + static_cast<int>(BrickVertices[Brick].size());
+
+		// A quad around each voxel edge crossing the surface, facing the outside
+		Jobs.ParallelFor(Num, [&](int Brick) {
+			FBlock Block;
+			Gather(BrickCoords[Brick], Block);
+			Vector3i First = BrickCoords[Brick] * BrickSize;
+			auto	 VertexOf = [&](const Vector3i& Cell) {
+				 int Owner = Brick;
+				 if (Vector3i CellBrick = BrickOf(Cell); CellBrick != BrickCoords[Brick])
+				 {
+					 auto It = Bricks.find(BrickKey(CellBrick));
+					 if (It == Bricks.end() || It->second == InsideTile)
+						 return -1;
+					 Owner = It->second;
+				 }
+				 int Local = CellVertices[static_cast<size_t>(Owner) * BrickVoxels + LocalIndex(Cell - BrickOf(Cell) * BrickSize)];
+				 return Local < 0 ? -1 : VertexOffsets[Owner] + Local;
+			};
+			for (int Index = 0; Index < BrickVoxels; Index++)
+			{
+				Vector3i Local(Index % BrickSize, Index / BrickSize % BrickSize, Index / (BrickSize * BrickSize));
+				bool	 bInside = Block.At(Local) < 0.f;
+				for (int Axis = 0; Axis < 3; Axis++)
+				{
+					if (bInside == (Block.At(Local + Vector3i::Unit(Axis)) < 0.f))
+						continue;
+					Vector3i U = Vector3i::Unit((Axis + 1) % 3), V = Vector3i::Unit((Axis + 2) % 3);
+					Vector3i Voxel = First + Local;
+					int		 Quad[4] = { VertexOf(Voxel), VertexOf(Voxel - U), VertexOf(Voxel - U - V), VertexOf(Voxel - V) };
+					if (std::find(std::begin(Quad), std::end(Quad), -1) != std::end(Quad))
+						continue;
+					// Counterclockwise around +Axis, which points outside when the edge starts inside
+					if (bInside)
+					{
+						BrickTriangles[Brick].emplace_back(Quad[0], Quad[1], Quad[2]);
+						BrickTriangles[Brick].emplace_back(Quad[0], Quad[2], Quad[3]);
+					}
+					else
+					{
+						BrickTriangles[Brick].emplace_back(Quad[0], Quad[2], Quad[1]);
+						BrickTriangles[Brick].emplace_back(Quad[0], Quad[3], Quad[2]);
+					}
+				}
+			}
+		}, Grain);
+
+		for (int Brick = 0; Brick < Num; Brick++)
+		{
+			Result.Vertices.insert(Result.Vertices.end(), BrickVertices[Brick].begin(), BrickVertices[Brick].end());
+			Result.Triangles.insert(Result.Triangles.end(), BrickTriangles[Brick].begin(), BrickTriangles[Brick].end());
+		}
+		return Result;
+	}
+
+	// Closest point of triangle ABC to Point (Ericson), Feature is the closest vertex 0-2, edge 3-5 starting at vertex Feature - 3, or 6 inside
+	static FVector ClosestPointOnTriangle(const FVector& Point, const FVector& A, const FVector& B, const FVector& C, int& Feature)
+	{
+		FVector AB = B - A, AC = C - A, AP = Point - A;
+		double	D1 = AB.dot(AP), D2 = AC.dot(AP);
+		Feature = 0;
+		if (D1 <= 0. && D2 <= 0.)
+			return A;
+		FVector BP = Point - B;
+		double	D3 = AB.dot(BP), D4 = AC.dot(BP);
+		Feature = 1;
+		if (D3 >= 0. && D4 <= D3)
+			return B;
+		double VC = D1 * D4 - D3 * D2;
+		Feature = 3;
+		if (VC <= 0. && D1 >= 0. && D3 <= 0.)
+			return A + D1 / (D1 - D3) * AB;
+		FVector CP = Point - C;
+		double	D5 = AB.dot(CP), D6 = AC.dot(CP);
+		Feature = 2;
+		if (D6 >= 0. && D5 <= D6)
+			return C;
+		double VB = D5 * D2 - D1 * D6;
+		Feature = 5;
+		if (VB <= 0. && D2 >= 0. && D6 <= 0.)
+			return A + D2 / (D2 - D6) * AC;
+		double VA = D3 * D6 - D5 * D4;
+		Feature = 4;
+		if (VA <= 0. && D4 - D3 >= 0. && D5 - D6 >= 0.)
+			return B + (D4 - D3) / ((D4 - D3) + (D5 - D6)) * (C - B);
+		double Denominator = 1. / (VA + VB + VC);
+		Feature = 6;
+		return A + AB * (VB * Denominator) + AC * (VC * Denominator);
+	}
+
+protected:
+	static constexpr int InsideTile = -1;
+
+	double							  VoxelSize = 0.01;
+	float							  Background = static_cast<float>(BandVoxels * 0.01);
+	std::unordered_map<uint64_t, int> Bricks; // Brick key to its index in BrickCoords, or InsideTile
+	TArray<Vector3i>				  BrickCoords;
+	TArray<float>					  Values; // BrickVoxels per brick, x fastest
+
+	// Voxels of a brick with a margin of one below and two above, what the cells and gradients of the brick read
+	struct FBlock
+	{
+		static constexpr int Size = BrickSize + 3;
+		float				 Voxels[Size * Size * Size];
+		double				 VoxelSize = 0.;
+
+		[[nodiscard]] float At(const Vector3i& Local) const { return Voxels[(Local.x() + 1) + Size * ((Local.y() + 1) + Size * (Local.z() + 1))]; }
+
+		[[nodiscard]] FVector Gradient(const Vector3i& Local) const
+		{
+			FVector Result;
+			for (int Axis = 0; Axis < 3; Axis++)
+			{
+				// One sided at the margin
+				Vector3i Unit = Vector3i::Unit(Axis);
+				Vector3i Low = Local[Axis] > -1 ? Local - Unit : Local;
+				Vector3i High = Local[Axis] < BrickSize + 1 ? Local + Unit : Local;
+				Result[Axis] = (At(High) - At(Low)) / ((High[Axis] - Low[Axis]) * VoxelSize);
+			}
+			return Result;
+		}
+	};
+
+	void Gather(const Vector3i& Brick, FBlock& Block) const
+	{
+		// The 27 bricks around, looked up once
+		const float* Neighbors[27];
+		float		 Constants[27];
+		for (int Neighbor = 0; Neighbor < 27; Neighbor++)
+		{
+			auto It = Bricks.find(BrickKey(Brick + Vector3i(Neighbor % 3 - 1, Neighbor / 3 % 3 - 1, Neighbor / 9 - 1)));
+			Neighbors[Neighbor] = It != Bricks.end() && It->second != InsideTile ? Values.data() + static_cast<size_t>(It->second) * BrickVoxels : nullptr;
+			Constants[Neighbor] = It == Bricks.end() ? Background : -Background;
+		}
+		Block.VoxelSize = VoxelSize;
+		for (int z = -1; z < BrickSize + 2; z++)
+			for (int y = -1; y < BrickSize + 2; y++)
+				for (int x = -1; x < BrickSize + 2; x++)
+				{
+					Vector3i Local(x, y, z);
+					Vector3i Side = (Local.array() < 0).cast<int>() * -1 + (Local.array() >= BrickSize).cast<int>();
+					int		 Neighbor = (Side.x() + 1) + 3 * (Side.y() + 1) + 9 * (Side.z() + 1);
+					Block.Voxels[(x + 1) + FBlock::Size * ((y + 1) + FBlock::Size * (z + 1))] =
+						Neighbors[Neighbor] ? Neighbors[Neighbor][LocalIndex(Local - Side * BrickSize)] : Constants[Neighbor];
+				}
+	}
+
+	void AddBrick(const Vector3i& Brick, const float* Voxels)
+	{
+		Bricks[BrickKey(Brick)] = NumBricks();
+		BrickCoords.push_back(Brick);
+		Values.insert(Values.end(), Voxels, Voxels + BrickVoxels);
+	}
+
+	// Flood fills the bricks outside from a corner of the grown bounds, the bricks it does not reach are enclosed by the band
+	void FillInsideTiles()
+	{
+		if (BrickCoords.empty())
+			return;
+		Vector3i Min = BrickCoords[0], Max = BrickCoords[0];
+		for (const Vector3i& Brick : BrickCoords)
+		{
+			Min = Min.cwiseMin(Brick);
+			Max = Max.cwiseMax(Brick);
+		}
+		Min -= Vector3i::Ones();
+		Max += Vector3i::Ones();
+		Vector3i		Size = Max - Min + Vector3i::Ones();
+		auto			IndexOf = [&](const Vector3i& Brick) { Vector3i Local = Brick - Min; return Local.x() + Size.x() * (Local.y() + Size.y() * Local.z()); };
+		TArray<uint8_t> State(Size.prod(), 0); // 0 unreached, 1 band, 2 outside
+		for (const Vector3i& Brick : BrickCoords)
+			State[IndexOf(Brick)] = 1;
+
+		TArray<Vector3i> Stack = { Min };
+		State[IndexOf(Min)] = 2;
+		while (!Stack.empty())
+		{
+			Vector3i Brick = Stack.back();
+			Stack.pop_back();
+			for (int Neighbor = 0; Neighbor < 6; Neighbor++)
+			{
+				Vector3i Other = Brick;
+				Other[Neighbor / 2] += Neighbor % 2 ? 1 : -1;
+				if ((Other.array() < Min.array()).any() || (Other.array() > Max.array()).any() || State[IndexOf(Other)] != 0)
+					continue;
+				State[IndexOf(Other)] = 2;
+				Stack.push_back(Other);
+			}
+		}
+		for (int z = Min.z(); z <= Max.z(); z++)
+			for (int y = Min.y(); y <= Max.y(); y++)
+				for (int x = Min.x(); x <= Max.x(); x++)
+					if (State[IndexOf({ x, y, z })] == 0)
+						Bricks[BrickKey({ x, y, z })] = InsideTile;
+	}
+
+	// Op on the voxels of every brick stored in A or B, the results beyond the band collapse back into tiles
+	template <class OpT>
+	static SparseSDF Combine(const SparseSDF& A, const SparseSDF& B, OpT&& Op, JobSystem& Jobs)
+	{
+		PROFILE_SCOPE("SparseSDF::Combine");
+		if (A.VoxelSize != B.VoxelSize)
+		{
+			LOG_ERROR("Sparse SDF voxel sizes differ: {} and {}", A.VoxelSize, B.VoxelSize);
+			return SparseSDF(A.VoxelSize);
+		}
+		SparseSDF		 Result(A.VoxelSize);
+		TArray<uint64_t> Keys;
+		Keys.reserve(A.Bricks.size() + B.Bricks.size());
+		for (const auto& [Key, Index] : A.Bricks)
+			Keys.push_back(Key);
+		for (const auto& [Key, Index] : B.Bricks)
+			Keys.push_back(Key);
+		std::sort(Keys.begin(), Keys.end());
+		Keys.erase(std::unique(Keys.begin(), Keys.end()), Keys.end());
+
+		int				NumCandidates = static_cast<int>(Keys.size());
+		TArray<float>	Candidates(static_cast<size_t>(NumCandidates) * BrickVoxels);
+		TArray<uint8_t> State(NumCandidates, 0); // 0 outside, 1 band, 2 inside
+		Jobs.ParallelFor(NumCandidates, [&](int Candidate) {
+			auto Voxels = [&Key = Keys[Candidate]](const SparseSDF& Grid, float& Constant) -> const float* {
+				auto It = Grid.Bricks.find(Key);
+				Constant = It == Grid.Bricks.end() ? Grid.Background : -Grid.Background;
+				return It != Grid.Bricks.end() && It->second != InsideTile ? Grid.Values.data() + static_cast<size_t>(It->second) * BrickVoxels : nullptr;
+			};
+			float		 ConstantA, ConstantB;
+			const float* VoxelsA = Voxels(A, ConstantA);
+			const float* VoxelsB = Voxels(B, ConstantB);
+			float		 Tile = Op(ConstantA, ConstantB);
+			if (!VoxelsA && !VoxelsB)
+			{
+				State[Candidate] = Tile < 0.f ? 2 : 0;
+				return;
+			}
+			float* Out = Candidates.data() + static_cast<size_t>(Candidate) * BrickVoxels;
+			bool   bBand = false;
+			for (int Index = 0; Index < BrickVoxels; Index++)
+			{
+				Out[Index] = Op(VoxelsA ? VoxelsA[Index] : ConstantA, VoxelsB ? VoxelsB[Index] : ConstantB);
+				bBand |= std::abs(Out[Index]) < Result.Background;
+			}
+			State[Candidate] = bBand ? 1 : Out[0] < 0.f ? 2 : 0;
+		}, Grain);
+
+		for (int Candidate = 0; Candidate < NumCandidates; Candidate++)
+			if (State[Candidate] == 1)
+				Result.AddBrick(KeyBrick(Keys[Candidate]), Candidates.data() + static_cast<size_t>(Candidate) * BrickVoxels);
+			else if (State[Candidate] == 2)
+				Result.Bricks[Keys[Candidate]] = InsideTile;
+		return Result;
+	}
+
+	[[nodiscard]] Vector3i VoxelFloor(const Vector3f& Point) const { return (Point.cast<double>() / VoxelSize).array().floor().cast<int>(); }
+	[[nodiscard]] Vector3i VoxelCeil(const Vector3f& Point) const { return (Point.cast<double>() / VoxelSize).array().ceil().cast<int>(); }
+
+	// Floor division, the shift rounds negative coordinates down
+	static Vector3i BrickOf(const Vector3i& Voxel)
+	{
+		static_assert(BrickSize == 1 << 3);
+		return { Voxel.x() >> 3, Voxel.y() >> 3, Voxel.z() >> 3 };
+	}
+
+	static int LocalIndex(const Vector3i& Local) { return Local.x() + BrickSize * (Local.y() + BrickSize * Local.z()); }
+
+	// 21 bits per axis, offset to keep negative brick coordinates positive
+	static uint64_t BrickKey(const Vector3i& Brick)
+	{
+		constexpr int64_t Offset = 1 << 20;
+		return static_cast<uint64_t>(Brick.x() + Offset) << 42 | static_cast<uint64_t>(Brick.y() + Offset) << 21 | static_cast<uint64_t>(Brick.z() + Offset);
+	}
+
+	static Vector3i KeyBrick(uint64_t Key)
+	{
+		constexpr int64_t Offset = 1 << 20, Mask = (1 << 21) - 1;
+		return { static_cast<int>(static_cast<int64_t>(Key >> 42 & Mask) - Offset), static_cast<int>(static_cast<int64_t>(Key >> 21 & Mask) - Offset),
+			static_cast<int>(static_cast<int64_t>(Key & Mask) - Offset) };
+	}
+};
+
+/**
+ * Sparse SDF of each StaticMesh, built on first use and rebuilt only when the geometry or the voxel size changes,
+ * so interactive edits voxelize the part once and only combine and extract per frame. One field is kept per mesh,
+ * dragging a voxel size slider replaces it instead of piling up one field per value. Safe to call from several threads.
+ * Usage:
+ *	std::shared_ptr<const SparseSDF> Part = SparseSDFCache::Get().Find(Mesh, 0.01);
+ */
+class SparseSDFCache
+{
+public:
+	static SparseSDFCache& Get()
+	{
+		static SparseSDFCache Instance;
+		return Instance;
+	}
+
+	std::shared_ptr<const SparseSDF> Find(const ObjectPtr<StaticMesh>& Mesh, double VoxelSize)
+	{
+		FMeshBuffers Buffers = FMeshBuffers::FromStaticMesh(*Mesh);
+		return Fields.Find(Mesh, { Buffers.HashGeometry(), VoxelSize }, [&] { return SparseSDF::FromMesh(Buffers, VoxelSize); });
+	}
+
+protected:
+	TMeshCache<SparseSDF, std::pair<uint64_t, double>> Fields;
+};
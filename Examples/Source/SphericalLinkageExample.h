@@ -22,6 +22,8 @@
 #include "Mechanisms/ClosedChainIKSolver.h"
 #include "Mechanisms/SphericalLinkage.h"
 #include "ImguiPlus.h"
+#include "SweptCollision.h"
+#include "TrajectoryRecorder.h"
 
 inline auto CalcJointTransform (const FVector& Translation, double Radius = 1.f)
 {
@@ -79,6 +81,19 @@ inline void WriteSimulationToFile(const TArray<FVector>& Trajectory, const Path&
 	}
 }
 
+inline void WriteJointMotion(std::ostream& OutFile, const FTransform& Motion)
+{
+	auto Matrix = Motion.GetMatrix();
+	for (int Row = 0; Row < 4; Row ++)
+	{
+		for (int Col = 0; Col < 4; Col ++)
+		{
+			OutFile << Matrix(Row, Col) << " ";
+		}
+	}
+	OutFile << "\n";
+}
+
 inline void WriteJointMotionToFile(const TArray<FTransform>& Motions, const Path& OutputFilePath)
 {
 	std::fstream OutFile(OutputFilePath, std::ios::out);
@@ -88,17 +103,7 @@ inline void WriteJointMotionToFile(const TArray<FTransform>& Motions, const Path
 		return;
 	}
 	for (int i = 0;i < Motions.size();i ++)
-	{
-		auto Matrix = Motions[i].GetMatrix();
-		for (int Row = 0; Row < 4; Row ++)
-		{
-			for (int Col = 0; Col < 4; Col ++)
-			{
-				OutFile << Matrix(Row, Col) << " ";
-			}
-		}
-		OutFile << "\n";
-	}
+		WriteJointMotion(OutFile, Motions[i]);
 }
 
 inline auto SphericalLinkageExample()
@@ -170,16 +175,54 @@ inline auto SphericalLinkageExample()
     			Root->GlobalTransform.AddRotationLocal(MMath::QuaternionFromEulerXYZ(DegToRad(FVector(0, 0, 1))));
     	});
 
-    	auto Trajectory = world.SpawnActor<CurveActor>("Trajectory", SimulatedSequence.Trajectory);
+    	// The display and the collision check decode the compressed motion on demand
+    	const TArray<ObjectPtr<SphericalLinkageActor>> Links = {JointA, JointB, JointC, JointD};
+    	const char* LinkNames[] = {"A", "B", "C", "D"};
+    	auto Recorder = std::make_shared<TrajectoryRecorder>(1, static_cast<int>(Links.size()), 1e-7);
+    	TArray<FTransform> FrameTransforms(Links.size());
+    	for (int Frame = 0; Frame < SimulatedSequence.Trajectory.size(); Frame ++)
+    	{
+    		for (int i = 0; i < Links.size(); i ++)
+    			FrameTransforms[i] = SimulatedSequence.JointTransforms.at(Links[i]->GetJointComponent()->GetJoint().get())[Frame];
+    		Recorder->AddFrame({&SimulatedSequence.Trajectory[Frame], 1}, FrameTransforms);
+    	}
+    	// The export writes the exact simulated values, the recording is quantized to 1e-7
+    	auto ExportTrajectory = std::make_shared<const TArray<FVector>>(std::move(SimulatedSequence.Trajectory));
+    	auto ExportMotions = std::make_shared<TArray<TArray<FTransform>>>();
+    	for (const auto& Link : Links)
+    		ExportMotions->push_back(std::move(SimulatedSequence.JointTransforms.at(Link->GetJointComponent()->GetJoint().get())));
+
+    	auto Trajectory = world.SpawnActor<CurveActor>("Trajectory", Recorder->Decimate(0, 1024));
     	Trajectory->GetCurveComponent()->SetRadius(0.001f);
 
+    	// Clearance between every pair of links over the whole cycle
+    	auto CollisionResults = std::make_shared<TArray<SweptCollision::FPairResult>>();
+
     	world.AddWidget<LambdaUIWidget>([=, &world]()  {
     		ImGui::Begin("Export Mechanism");
 
+			if(ImGui::Button("Check link collisions"))
+			{
+				SweptCollision Collision;
+				for (int i = 0; i < Links.size(); i ++)
+					Collision.AddBody(Links[i]->GetJointComponent()->GetMeshData(), Recorder->ReadTransforms(i));
+				// Adjacent links of the closed chain touch at their shared joint, only the opposite links can collide
+				*CollisionResults = Collision.Run({{0, 2}, {1, 3}});
+			}
+			for (const auto& Pair : *CollisionResults)
+			{
+				if (Pair.HasContact())
+					ImGui::Text("%s-%s: contact at frame %.2f", LinkNames[Pair.BodyA], LinkNames[Pair.BodyB], Pair.FirstContactTime);
+				else if (Pair.IsUndecided())
+					ImGui::Text("%s-%s: undecided after frame %.2f, min clearance %.4f", LinkNames[Pair.BodyA], LinkNames[Pair.BodyB], Pair.UndecidedTime, Pair.MinClearance);
+				else
+					ImGui::Text("%s-%s: min clearance %.4f at frame %.2f", LinkNames[Pair.BodyA], LinkNames[Pair.BodyB], Pair.MinClearance, Pair.MinClearanceTime);
+			}
+
 			if(ImGui::Button("Export motion and mesh"))
 			{
 				auto ExportFolderPath = SelectFolderDialog("Select export folder", Path::ProjectContentDir());
-				WriteSimulationToFile(SimulatedSequence.Trajectory, Path::ProjectContentDir() / "OutputTrajectory.txt");
+				WriteSimulationToFile(*ExportTrajectory, Path::ProjectContentDir() / "OutputTrajectory.txt");
 				Path ExportFolder = ExportFolderPath.result();
 				Path ModelFolder = ExportFolder / "Model";
 				Path::CreateDirectory(ModelFolder);
@@ -189,10 +232,10 @@ inline auto SphericalLinkageExample()
 				JointB->GetJointComponent()->GetMeshData()->SaveOBJ(ModelFolder / "B.obj");
 				JointC->GetJointComponent()->GetMeshData()->SaveOBJ(ModelFolder / "C.obj");
 				JointD->GetJointComponent()->GetMeshData()->SaveOBJ(ModelFolder / "D.obj");
-				WriteJointMotionToFile(SimulatedSequence.JointTransforms.at(JointA->GetJointComponent()->GetJoint().get()), MotionFolder / "A.pmt");
-				WriteJointMotionToFile(SimulatedSequence.JointTransforms.at(JointB->GetJointComponent()->GetJoint().get()), MotionFolder / "B.pmt");
-				WriteJointMotionToFile(SimulatedSequence.JointTransforms.at(JointC->GetJointComponent()->GetJoint().get()), MotionFolder / "C.pmt");
-				WriteJointMotionToFile(SimulatedSequence.JointTransforms.at(JointD->GetJointComponent()->GetJoint().get()), MotionFolder / "D.pmt");
+				WriteJointMotionToFile((*ExportMotions)[0], MotionFolder / "A.pmt");
+				WriteJointMotionToFile((*ExportMotions)[1], MotionFolder / "B.pmt");
+				WriteJointMotionToFile((*ExportMotions)[2], MotionFolder / "C.pmt");
+				WriteJointMotionToFile((*ExportMotions)[3], MotionFolder / "D.pmt");
 			}
     		ImGui::End();
     	});
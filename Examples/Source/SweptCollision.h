@@ -0,0 +1,408 @@
+#pragma once
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <tuple>
+#include "CoreMinimal.h"
+#include "CpuBVH.h"
+#include "JobSystem.h"
+#include "MeshBuffers.h"
+
+/**
+ * Exact distance queries between two triangles, in double precision.
+ * Closest point on a triangle and between segments follow Ericson, Real-Time Collision Detection, 5.1.5 and 5.1.9.
+ */
+namespace TriangleDistance
+{
+	inline FVector ClosestPointOnTriangle(const FVector& P, const FVector& A, const FVector& B, const FVector& C)
+	{
+		FVector AB = B - A, AC = C - A, AP = P - A;
+		double	D1 = AB.dot(AP), D2 = AC.dot(AP);
+		if (D1 <= 0. && D2 <= 0.)
+			return A;
+		FVector BP = P - B;
+		double	D3 = AB.dot(BP), D4 = AC.dot(BP);
+		if (D3 >= 0. && D4 <= D3)
+			return B;
+		double VC = D1 * D4 - D3 * D2;
+		if (VC <= 0. && D1 >= 0. && D3 <= 0.)
+			return A + AB * (D1 / (D1 - D3));
+		FVector CP = P - C;
+		double	D5 = AB.dot(CP), D6 = AC.dot(CP);
+		if (D6 >= 0. && D5 <= D6)
+			return C;
+		double VB = D5 * D2 - D1 * D6;
+		if (VB <= 0. && D2 >= 0. && D6 <= 0.)
+			return A + AC * (D2 / (D2 - D6));
+		double VA = D3 * D6 - D5 * D4;
+		if (VA <= 0. && D4 - D3 >= 0. && D5 - D6 >= 0.)
+			return B + (C - B) * ((D4 - D3) / ((D4 - D3) + (D5 - D6)));
+		double Denominator = 1. / (VA + VB + VC);
+		return A + AB * (VB * Denominator) + AC * (VC * Denominator);
+	}
+
+	inline double SquaredSegmentDistance(const FVector& P1, const FVector& Q1, const FVector& P2, const FVector& Q2)
+	{
+		FVector D1 = Q1 - P1, D2 = Q2 - P2, R = P1 - P2;
+		double	A = D1.squaredNorm(), E = D2.squaredNorm(), F = D2.dot(R);
+		double	S = 0., T = 0.;
+		if (A <= 1e-30 && E <= 1e-30)
+			return R.squaredNorm();
+		if (A <= 1e-30)
+			T = std::clamp(F / E, 0., 1.);
+		else
+		{
+			double C = D1.dot(R);
+			if (E <= 1e-30)
+				S = std::clamp(-C / A, 0., 1.);
+			else
+			{
+				double B = D1.dot(D2), Denominator = A * E - B * B;
+				S = Denominator > 0. ? std::clamp((B * F - C * E) / Denominator, 0., 1.) : 0.;
+				T = (B * S + F) / E;
+				if (T < 0.)
+				{
+					T = 0.;
+					S = std::clamp(-C / A, 0., 1.);
+				}
+				else if (T > 1.)
+				{
+					T = 1.;
+					S = std::clamp((B - C) / A, 0., 1.);
+				}
+			}
+		}
+		return (P1 + D1 * S - (P2 + D2 * T)).squaredNorm();
+	}
+
+	// Whether segment PQ crosses triangle ABC (Moller-Trumbore on the segment)
+	inline bool SegmentIntersectsTriangle(const FVector& P, const FVector& Q, const FVector& A, const FVector& B, const FVector& C)
+	{
+		FVector Direction = Q - P, E1 = B - A, E2 = C - A;
+		FVector H = Direction.cross(E2);
+		double	Determinant = E1.dot(H);
+		if (std::abs(Determinant) < 1e-30)
+			return false;
+		double	InvDeterminant = 1. / Determinant;
+		FVector S = P - A;
+		double	U = S.dot(H) * InvDeterminant;
+		if (U < 0. || U > 1.)
+			return false;
+		FVector QVec = S.cross(E1);
+		double	V = Direction.dot(QVec) * InvDeterminant;
+		if (V < 0. || U + V > 1.)
+			return false;
+		double T = E2.dot(QVec) * InvDeterminant;
+		return T >= 0. && T <= 1.;
+	}
+
+	// Distance between triangles A and B, zero when they intersect
+	inline double TriangleTriangle(const FVector (&A)[3], const FVector (&B)[3])
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			if (SegmentIntersectsTriangle(A[i], A[(i + 1) % 3], B[0], B[1], B[2]) || SegmentIntersectsTriangle(B[i], B[(i + 1) % 3], A[0], A[1], A[2]))
+				return 0.;
+		}
+		double Result = std::numeric_limits<double>::max();
+		for (int i = 0; i < 3; i++)
+		{
+			Result = std::min(Result, (A[i] - ClosestPointOnTriangle(A[i], B[0], B[1], B[2])).squaredNorm());
+			Result = std::min(Result, (B[i] - ClosestPointOnTriangle(B[i], A[0], A[1], A[2])).squaredNorm());
+			for (int j = 0; j < 3; j++)
+				Result = std::min(Result, SquaredSegmentDistance(A[i], A[(i + 1) % 3], B[j], B[(j + 1) % 3]));
+		}
+		return std::sqrt(Result);
+	}
+} // namespace TriangleDistance
+
+/**
+ * Continuous collision check of rigid bodies moving along sampled motions, e.g. the links of a simulated mechanism.
+ * Between two samples a body moves with linearly interpolated translation and slerped rotation. For every pair,
+ * conservative advancement steps through each interval by the current distance divided by a bound of the relative
+ * speed, so no contact can be skipped, and stops at the first contact. A pair that runs out of steps is reported
+ * undecided rather than in contact or clear. The distances come from BVH traversals over the two meshes, built once
+ * per mesh. Pairs are checked in parallel.
+ * Usage:
+ *	SweptCollision Collision;
+ *	Collision.AddBody(LinkMeshA, MotionA);
+ *	Collision.AddBody(LinkMeshB, MotionB);
+ *	for (const auto& Pair : Collision.Run()) ...
+ */
+class SweptCollision
+{
+public:
+	struct FPairResult
+	{
+		int	   BodyA = -1, BodyB = -1;
+		double MinClearance = std::numeric_limits<double>::max(); // Within ClearanceResolution of the true minimum distance
+		double MinClearanceTime = 0.;							  // In samples, fractional between two samples
+		double FirstContactTime = -1.;							  // In samples, negative when the bodies never touch
+		double UndecidedTime = -1.; // In samples, where MaxStepsPerInterval ran out with the bodies still apart, negative if it did not
+		int	   NumDistanceQueries = 0;
+
+		[[nodiscard]] bool HasContact() const { return FirstContactTime >= 0.; }
+		// The step limit stopped the check, the bodies were apart until UndecidedTime but contact after it is not ruled out
+		[[nodiscard]] bool IsUndecided() const { return UndecidedTime >= 0.; }
+	};
+
+	// Distance at which two bodies are in contact
+	double Tolerance = 1e-4;
+	// Bodies closer than the clearance found so far are advanced by at most this distance, so MinClearance is accurate to it
+	double ClearanceResolution = 1e-3;
+	// Advancement steps per interval before the pair is reported undecided, steps shrink with the clearance
+	int MaxStepsPerInterval = 4096;
+
+	/**
+	 * Add a body with its mesh in local space and its transform at every sample, return its index or -1 on error.
+	 * The scale of the transforms is applied to the mesh, so it has to stay the same over the motion.
+	 * Bodies sharing a mesh and a scale share its BVH.
+	 */
+	int AddBody(const ObjectPtr<StaticMesh>& Mesh, const TArray<FTransform>& Motion)
+	{
+		FBody	Body;
+		FVector Scale = FVector::Ones();
+		for (size_t Sample = 0; Sample < Motion.size(); Sample++)
+		{
+			FMatrix		 Matrix = Motion[Sample].GetMatrix();
+			Eigen::Matrix3d Linear = Matrix.topLeftCorner<3, 3>();
+			FVector		 SampleScale = Linear.colwise().norm().transpose();
+			if (Linear.determinant() < 0.)
+				SampleScale.x() = -SampleScale.x(); // A mirror, kept in the scale so the rest is a rotation
+			if (Sample == 0)
+				Scale = SampleScale;
+			else if (!SampleScale.isApprox(Scale, 1e-9))
+			{
+				LOG_ERROR("SweptCollision: the scale of a body changes over its motion, only rigid motions are supported");
+				return -1;
+			}
+			if ((Scale.array().abs() < 1e-12).any())
+			{
+				LOG_ERROR("SweptCollision: a body is scaled to zero");
+				return -1;
+			}
+			Body.Motion.push_back({ FQuat(Linear * Scale.cwiseInverse().asDiagonal()).normalized(), Matrix.topRightCorner<3, 1>() });
+		}
+
+		auto& Shape = Shapes[{ Mesh.get(), Scale.x(), Scale.y(), Scale.z() }];
+		if (!Shape)
+		{
+			FMeshBuffers Geometry = FMeshBuffers::FromStaticMesh(*Mesh);
+			for (FVector& Vertex : Geometry.Vertices)
+				Vertex = Vertex.cwiseProduct(Scale);
+			Shape = std::make_shared<FShape>(std::move(Geometry));
+		}
+		Body.Shape = Shape;
+		Bodies.push_back(std::move(Body));
+		return static_cast<int>(Bodies.size()) - 1;
+	}
+
+	[[nodiscard]] int NumBodies() const { return static_cast<int>(Bodies.size()); }
+
+	// Check the given pairs of bodies, every pair when empty
+	TArray<FPairResult> Run(TArray<Vector2i> Pairs = {}, JobSystem& Jobs = JobSystem::Get()) const
+	{
+		if (Pairs.empty())
+		{
+			for (int A = 0; A < NumBodies(); A++)
+				for (int B = A + 1; B < NumBodies(); B++)
+					Pairs.emplace_back(A, B);
+		}
+		TArray<FPairResult> Results(Pairs.size());
+		Jobs.ParallelFor(static_cast<int>(Pairs.size()), [&](int i) { Results[i] = RunPair(Pairs[i][0], Pairs[i][1]); });
+		return Results;
+	}
+
+protected:
+	struct FShape
+	{
+		FMeshBuffers Geometry;
+		CpuBVH		 BVH;
+		double		 Radius = 0.; // Of the bounding sphere around the local origin, bounds the speed of rotating points
+
+		explicit FShape(FMeshBuffers InGeometry) : Geometry(std::move(InGeometry))
+		{
+			TArray<AlignedBox3f> Bounds(Geometry.NumTriangles());
+			for (int i = 0; i < Geometry.NumTriangles(); i++)
+			{
+				for (int Corner = 0; Corner < 3; Corner++)
+					Bounds[i].extend(Geometry.Vertices[Geometry.Triangles[i][Corner]].cast<float>());
+			}
+			BVH.Build(Bounds);
+			for (const auto& Vertex : Geometry.Vertices)
+				Radius = std::max(Radius, Vertex.norm());
+		}
+
+		void GetTriangle(int Index, FVector (&OutVertices)[3]) const
+		{
+			for (int Corner = 0; Corner < 3; Corner++)
+				OutVertices[Corner] = Geometry.Vertices[Geometry.Triangles[Index][Corner]];
+		}
+	};
+
+	struct FPose
+	{
+		FQuat	Rotation;
+		FVector Translation;
+	};
+
+	struct FBody
+	{
+		std::shared_ptr<FShape> Shape;
+		TArray<FPose>			Motion;
+	};
+
+	std::map<std::tuple<const StaticMesh*, double, double, double>, std::shared_ptr<FShape>> Shapes; // By mesh and scale
+	TArray<FBody>																			  Bodies;
+
+	static FPose Interpolate(const FPose& From, const FPose& To, double Alpha)
+	{
+		return { From.Rotation.slerp(Alpha, To.Rotation), From.Translation + (To.Translation - From.Translation) * Alpha };
+	}
+
+	// Upper bound of the speed of any point of the body over the interval, in distance per interval
+	static double MaxSpeed(const FPose& From, const FPose& To, double Radius)
+	{
+		return (To.Translation - From.Translation).norm() + From.Rotation.angularDistance(To.Rotation) * Radius;
+	}
+
+	FPairResult RunPair(int IndexA, int IndexB) const
+	{
+		const FBody& A = Bodies[IndexA];
+		const FBody& B = Bodies[IndexB];
+		FPairResult	 Result;
+		Result.BodyA = IndexA;
+		Result.BodyB = IndexB;
+		int NumSamples = static_cast<int>(std::min(A.Motion.size(), B.Motion.size()));
+		for (int Sample = 0; Sample < NumSamples; Sample++)
+		{
+			bool   bLastSample = Sample + 1 == NumSamples;
+			int	   Next = bLastSample ? Sample : Sample + 1;
+			double Speed = MaxSpeed(A.Motion[Sample], A.Motion[Next], A.Shape->Radius) + MaxSpeed(B.Motion[Sample], B.Motion[Next], B.Shape->Radius);
+
+			// Broad phase: the bounding spheres stay farther apart than the clearance found so far
+			double SphereDistance = (A.Motion[Sample].Translation - B.Motion[Sample].Translation).norm() - A.Shape->Radius - B.Shape->Radius;
+			if (SphereDistance - Speed >= Result.MinClearance)
+				continue;
+
+			double Time = 0.;
+			for (int Step = 0; Step < MaxStepsPerInterval; Step++)
+			{
+				double Distance = ComputeDistance(*A.Shape, Interpolate(A.Motion[Sample], A.Motion[Next], Time),
+					*B.Shape, Interpolate(B.Motion[Sample], B.Motion[Next], Time));
+				Result.NumDistanceQueries++;
+				if (Distance < Result.MinClearance)
+				{
+					Result.MinClearance = Distance;
+					Result.MinClearanceTime = Sample + Time;
+				}
+				if (Distance <= Tolerance)
+				{
+					Result.FirstContactTime = Sample + Time;
+					return Result;
+				}
+				if (Step + 1 == MaxStepsPerInterval)
+				{
+					Result.UndecidedTime = Sample + Time;
+					return Result;
+				}
+				// Nothing can close the gap faster than Speed, so the bodies stay apart until Time + Distance / Speed.
+				// Near the smallest clearance the steps are also limited by the resolution, between two steps the distance
+				// can then not dip more than ClearanceResolution below them
+				if (bLastSample || Speed <= 0.)
+					break;
+				double Advance = Distance - Result.MinClearance < ClearanceResolution ? std::min(Distance, 2. * ClearanceResolution) : Distance;
+				Time += Advance / Speed;
+				if (Time >= 1.)
+					break;
+			}
+		}
+		return Result;
+	}
+
+	/**
+	 * Distance between the two shapes at their poses.
+	 * Traverses both BVHs in the local space of B, pruning node pairs that can not be closer than the best distance so far.
+	 */
+	static double ComputeDistance(const FShape& ShapeA, const FPose& PoseA, const FShape& ShapeB, const FPose& PoseB)
+	{
+		const auto& NodesA = ShapeA.BVH.GetNodes();
+		const auto& NodesB = ShapeB.BVH.GetNodes();
+		if (NodesA.empty() || NodesB.empty())
+			return std::numeric_limits<double>::max();
+
+		// Local space of A to local space of B
+		FQuat	InvRotationB = PoseB.Rotation.conjugate();
+		FQuat	Rotation = InvRotationB * PoseA.Rotation;
+		FVector Translation = InvRotationB * (PoseA.Translation - PoseB.Translation);
+		// Float node bounds against double vertices, keep the lower bounds conservative
+		constexpr double BoundsEpsilon = 1e-5;
+
+		auto LowerBound = [&](int NodeA, int NodeB) {
+			const auto& A = NodesA[NodeA];
+			const auto& B = NodesB[NodeB];
+			FVector		Center = Rotation * ((A.Min + A.Max) * 0.5f).cast<double>() + Translation;
+			double		Radius = ((A.Max - A.Min) * 0.5f).cast<double>().norm();
+			AlignedBox3d BoxB(B.Min.cast<double>(), B.Max.cast<double>());
+			return BoxB.exteriorDistance(Center) - Radius - BoundsEpsilon;
+		};
+
+		double Best = std::numeric_limits<double>::max();
+		struct FNodePair
+		{
+			int	   A, B;
+			double Bound;
+		};
+		// Grows when the trees are deep, stopping early would return a distance larger than the true one
+		TArray<FNodePair> Stack;
+		Stack.reserve(64);
+		Stack.push_back({ 0, 0, LowerBound(0, 0) });
+		while (!Stack.empty())
+		{
+			FNodePair Pair = Stack.back();
+			Stack.pop_back();
+			if (Pair.Bound >= Best)
+				continue;
+			const auto& NodeA = NodesA[Pair.A];
+			const auto& NodeB = NodesB[Pair.B];
+			if (NodeA.IsLeaf() && NodeB.IsLeaf())
+			{
+				const auto& IndicesA = ShapeA.BVH.GetPrimitiveIndices();
+				const auto& IndicesB = ShapeB.BVH.GetPrimitiveIndices();
+				for (int i = NodeA.First; i < NodeA.First + NodeA.Count; i++)
+				{
+					FVector TriangleA[3];
+					ShapeA.GetTriangle(IndicesA[i], TriangleA);
+					for (auto& Vertex : TriangleA)
+						Vertex = Rotation * Vertex + Translation;
+					for (int j = NodeB.First; j < NodeB.First + NodeB.Count; j++)
+					{
+						FVector TriangleB[3];
+						ShapeB.GetTriangle(IndicesB[j], TriangleB);
+						Best = std::min(Best, TriangleDistance::TriangleTriangle(TriangleA, TriangleB));
+					}
+				}
+				continue;
+			}
+
+			// Split the larger node, push the farther child first so the nearer one is visited first
+			bool SplitA = NodeB.IsLeaf() || (!NodeA.IsLeaf() && (NodeA.Max - NodeA.Min).squaredNorm() > (NodeB.Max - NodeB.Min).squaredNorm());
+			FNodePair First, Second;
+			if (SplitA)
+			{
+				First = { Pair.A + 1, Pair.B, LowerBound(Pair.A + 1, Pair.B) };
+				Second = { NodeA.First, Pair.B, LowerBound(NodeA.First, Pair.B) };
+			}
+			else
+			{
+				First = { Pair.A, Pair.B + 1, LowerBound(Pair.A, Pair.B + 1) };
+				Second = { Pair.A, NodeB.First, LowerBound(Pair.A, NodeB.First) };
+			}
+			if (First.Bound < Second.Bound)
+				std::swap(First, Second);
+			Stack.push_back(First);
+			Stack.push_back(Second);
+		}
+		return Best;
+	}
+};
@@ -0,0 +1,139 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include "CoreMinimal.h"
+#include "JobSystem.h"
+
+/**
+ * One unit of per-frame work, usually the tick of one actor.
+ * Compute runs on the job system and must only touch the resources declared in Reads and Writes.
+ * Apply runs on the game thread once the task's wave has computed, in registration order, and is where engine objects
+ * are modified. It runs before the next wave starts, so a task that reads what an earlier task writes sees this frame's value.
+ */
+struct FTickTask
+{
+	String Name;
+
+	// Groups tick in ascending order, a group starts when the previous one has been applied
+	int TickGroup = 0;
+
+	// Resources read and written by Compute, usually the actors involved. Conflicting tasks never run concurrently
+	// and run in registration order
+	TArray<const void*> Reads;
+	TArray<const void*> Writes;
+
+	// Keep the registration order relative to the other ordered tasks of the group, even without conflicts
+	bool Ordered = false;
+
+	std::function<void(double)> Compute;
+	std::function<void(double)> Apply;
+};
+
+/**
+ * Dependency-aware scheduler for actor ticks.
+ * Tasks are sorted into waves: a task goes one wave after the last earlier task it conflicts with,
+ * so independent tasks run in parallel while dependent tasks keep a deterministic order.
+ * Each wave is applied before the next one computes, so a dependent task sees the writes of the tasks before it.
+ * Usage:
+ *	world.TickFunction = [Scheduler](double DeltaTime, World&) { Scheduler->Tick(DeltaTime); };
+ */
+class TickScheduler
+{
+public:
+	explicit TickScheduler(JobSystem& InJobs = JobSystem::Get())
+		: Jobs(InJobs) {}
+
+	int AddTask(FTickTask Task)
+	{
+		Tasks.push_back(std::move(Task));
+		ScheduleDirty = true;
+		return static_cast<int>(Tasks.size()) - 1;
+	}
+
+	void RemoveAllTasks()
+	{
+		Tasks.clear();
+		ScheduleDirty = true;
+	}
+
+	[[nodiscard]] int NumTasks() const { return static_cast<int>(Tasks.size()); }
+
+	void Tick(double DeltaTime)
+	{
+		PROFILE_SCOPE("TickScheduler::Tick");
+		if (ScheduleDirty)
+			BuildSchedule();
+
+		for (const auto& Group : Groups)
+		{
+			for (const auto& Wave : Group.Waves)
+			{
+				Jobs.ParallelFor(static_cast<int>(Wave.size()), [&](int i) {
+					if (const auto& Compute = Tasks[Wave[i]].Compute)
+						Compute(DeltaTime);
+				});
+				// Applied before the next wave, which may read what this one writes
+				PROFILE_SCOPE("TickScheduler::Apply");
+				for (int Index : Wave)
+				{
+					if (const auto& Apply = Tasks[Index].Apply)
+						Apply(DeltaTime);
+				}
+			}
+		}
+	}
+
+protected:
+	struct FGroupSchedule
+	{
+		TArray<int>			Tasks; // Registration order
+		TArray<TArray<int>> Waves;
+	};
+
+	JobSystem&			   Jobs;
+	TArray<FTickTask>	   Tasks;
+	TArray<FGroupSchedule> Groups;
+	bool				   ScheduleDirty = true;
+
+	static bool Overlaps(const TArray<const void*>& A, const TArray<const void*>& B)
+	{
+		for (const void* Resource : A)
+			if (std::find(B.begin(), B.end(), Resource) != B.end())
+				return true;
+		return false;
+	}
+
+	static bool Conflicts(const FTickTask& A, const FTickTask& B)
+	{
+		return (A.Ordered && B.Ordered) || Overlaps(A.Writes, B.Writes) || Overlaps(A.Writes, B.Reads) || Overlaps(A.Reads, B.Writes);
+	}
+
+	void BuildSchedule()
+	{
+		TArray<int> Order(Tasks.size());
+		for (int i = 0; i < static_cast<int>(Order.size()); i++)
+			Order[i] = i;
+		std::stable_sort(Order.begin(), Order.end(), [this](int A, int B) { return Tasks[A].TickGroup < Tasks[B].TickGroup; });
+
+		Groups.clear();
+		TArray<int> WaveOf(Tasks.size(), 0);
+		for (int i = 0; i < static_cast<int>(Order.size()); i++)
+		{
+			int Index = Order[i];
+			if (Groups.empty() || Tasks[Groups.back().Tasks.front()].TickGroup != Tasks[Index].TickGroup)
+				Groups.emplace_back();
+			FGroupSchedule& Group = Groups.back();
+
+			int Wave = 0;
+			for (int Previous : Group.Tasks)
+				if (Conflicts(Tasks[Previous], Tasks[Index]))
+					Wave = std::max(Wave, WaveOf[Previous] + 1);
+			WaveOf[Index] = Wave;
+			Group.Tasks.push_back(Index);
+			if (Wave >= static_cast<int>(Group.Waves.size()))
+				Group.Waves.resize(Wave + 1);
+			Group.Waves[Wave].push_back(Index);
+		}
+		ScheduleDirty = false;
+	}
+};
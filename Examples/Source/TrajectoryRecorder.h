@@ -0,0 +1,308 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <span>
+#include "CoreMinimal.h"
+#include "Misc/Path.h"
+
+/**
+ * Streaming recorder for long simulations: each frame holds NumPoints points (e.g. an effector trajectory)
+ * and NumTransforms rigid transforms (e.g. the joints), appended one frame at a time.
+ * Values are quantized to Quantum and stored as the residual of a linear prediction from the two previous frames,
+ * as zigzag varints, in chunks of ChunkFrames frames. Smooth motion then takes one or two bytes per value instead of eight.
+ * Compressed chunks beyond MemoryBudget are spilled to SpillFile when one is given. Any frame can be read back,
+ * decoding only its chunk, and Decimate gives a reduced point sequence for display, e.g. for a CurveActor.
+ * Not thread safe.
+ */
+class TrajectoryRecorder
+{
+public:
+	static constexpr int ChunkFrames = 1024;
+
+	struct FStats
+	{
+		int64_t RawBytes = 0;		 // As doubles
+		int64_t CompressedBytes = 0; // In memory and on disk
+		int64_t SpilledBytes = 0;
+	};
+
+	TrajectoryRecorder(int InNumPoints, int InNumTransforms, double InQuantum = 1e-6, size_t InMemoryBudget = 64 << 20, const Path& InSpillFile = {})
+		: NumPoints(InNumPoints), NumTransforms(InNumTransforms), NumValues(InNumPoints * 3 + InNumTransforms * 7),
+		  Quantum(InQuantum), MemoryBudget(InMemoryBudget), SpillFile(InSpillFile)
+	{
+		Previous.resize(NumValues * 2, 0);
+		FrameValues.resize(NumValues);
+		LastRotations.resize(NumTransforms, FQuat::Identity());
+	}
+
+	[[nodiscard]] int NumFrames() const { return FrameCount; }
+	[[nodiscard]] int GetNumPoints() const { return NumPoints; }
+	[[nodiscard]] int GetNumTransforms() const { return NumTransforms; }
+
+	void AddFrame(std::span<const FVector> Points, std::span<const FTransform> Transforms = {})
+	{
+		ASSERT(static_cast<int>(Points.size()) == NumPoints && static_cast<int>(Transforms.size()) == NumTransforms);
+		for (int i = 0; i < NumPoints; i++)
+			for (int Axis = 0; Axis < 3; Axis++)
+				FrameValues[i * 3 + Axis] = Points[i][Axis];
+		for (int i = 0; i < NumTransforms; i++)
+		{
+			FMatrix Matrix = Transforms[i].GetMatrix();
+			FQuat	Rotation(Matrix.topLeftCorner<3, 3>());
+			double* Out = &FrameValues[NumPoints * 3 + i * 7];
+			// q and -q are the same rotation, stay in the hemisphere of the last frame to keep the residuals small
+			if (FrameCount > 0 && Rotation.coeffs().dot(LastRotations[i].coeffs()) < 0.)
+				Rotation.coeffs() = -Rotation.coeffs();
+			LastRotations[i] = Rotation;
+			for (int Axis = 0; Axis < 3; Axis++)
+				Out[Axis] = Matrix(Axis, 3);
+			for (int Coeff = 0; Coeff < 4; Coeff++)
+				Out[3 + Coeff] = Rotation.coeffs()[Coeff];
+		}
+		AddValues(FrameValues);
+	}
+
+	// Frame values in recording order, points first then the transforms as translation and quaternion (x, y, z, w)
+	void AddValues(std::span<const double> Values)
+	{
+		int FrameInChunk = FrameCount % ChunkFrames;
+		if (FrameInChunk == 0)
+			std::fill(Previous.begin(), Previous.end(), 0);
+		for (int i = 0; i < NumValues; i++)
+		{
+			int64_t Quantized = std::llround(Values[i] / Quantum);
+			int64_t Residual = Quantized - Predict(FrameInChunk, Previous[i], Previous[NumValues + i]);
+			WriteVarint(OpenChunk, (static_cast<uint64_t>(Residual) << 1) ^ static_cast<uint64_t>(Residual >> 63));
+			Previous[NumValues + i] = Previous[i];
+			Previous[i] = Quantized;
+		}
+		FrameCount++;
+		if (FrameCount % ChunkFrames == 0)
+			CloseChunk();
+	}
+
+	// Points and transforms of one frame, decoding its chunk unless it is the last one read
+	void GetFrame(int Frame, TArray<FVector>& OutPoints, TArray<FTransform>& OutTransforms) const
+	{
+		const double* Values = DecodeFrame(Frame);
+		OutPoints.resize(NumPoints);
+		OutTransforms.resize(NumTransforms);
+		for (int i = 0; i < NumPoints; i++)
+			OutPoints[i] = FVector(Values[i * 3], Values[i * 3 + 1], Values[i * 3 + 2]);
+		for (int i = 0; i < NumTransforms; i++)
+			OutTransforms[i] = ToTransform(Values + NumPoints * 3 + i * 7);
+	}
+
+	[[nodiscard]] FVector GetPoint(int Frame, int Point) const
+	{
+		const double* Values = DecodeFrame(Frame) + Point * 3;
+		return { Values[0], Values[1], Values[2] };
+	}
+
+	[[nodiscard]] FTransform GetTransform(int Frame, int Transform) const { return ToTransform(DecodeFrame(Frame) + NumPoints * 3 + Transform * 7); }
+
+	/**
+	 * Call Function(Frame, Value) for every frame of one point or transform, in order.
+	 * Only one chunk is decoded at a time, so long recordings can be written out without holding the whole sequence.
+	 */
+	template <class FunctionT>
+	void ForEachPoint(int Point, FunctionT&& Function) const
+	{
+		for (int Frame = 0; Frame < FrameCount; Frame++)
+			Function(Frame, GetPoint(Frame, Point));
+	}
+
+	template <class FunctionT>
+	void ForEachTransform(int Transform, FunctionT&& Function) const
+	{
+		for (int Frame = 0; Frame < FrameCount; Frame++)
+			Function(Frame, GetTransform(Frame, Transform));
+	}
+
+	// Every frame of one point or transform, in order
+	[[nodiscard]] TArray<FVector> ReadPoints(int Point) const
+	{
+		TArray<FVector> Result(FrameCount);
+		ForEachPoint(Point, [&Result](int Frame, const FVector& Value) { Result[Frame] = Value; });
+		return Result;
+	}
+
+	[[nodiscard]] TArray<FTransform> ReadTransforms(int Transform) const
+	{
+		TArray<FTransform> Result(FrameCount);
+		ForEachTransform(Transform, [&Result](int Frame, const FTransform& Value) { Result[Frame] = Value; });
+		return Result;
+	}
+
+	// At most MaxPoints evenly spaced frames of a point, always including the first and the last frame, so MaxPoints >= 2
+	[[nodiscard]] TArray<FVector> Decimate(int Point, int MaxPoints) const
+	{
+		TArray<FVector> Result;
+		if (MaxPoints < 2)
+		{
+			LOG_ERROR("Decimate keeps the first and the last frame, MaxPoints must be at least 2, got {}", MaxPoints);
+			return Result;
+		}
+		if (FrameCount == 0)
+			return Result;
+		int Stride = std::max(1, (FrameCount + MaxPoints - 2) / (MaxPoints - 1));
+		for (int Frame = 0; Frame < FrameCount; Frame += Stride)
+			Result.push_back(GetPoint(Frame, Point));
+		if ((FrameCount - 1) % Stride != 0)
+			Result.push_back(GetPoint(FrameCount - 1, Point));
+		return Result;
+	}
+
+	[[nodiscard]] FStats GetStats() const
+	{
+		FStats Stats;
+		Stats.RawBytes = static_cast<int64_t>(FrameCount) * NumValues * sizeof(double);
+		Stats.CompressedBytes = static_cast<int64_t>(OpenChunk.size());
+		for (const auto& Chunk : Chunks)
+			Stats.CompressedBytes += static_cast<int64_t>(Chunk.Size);
+		Stats.SpilledBytes = SpilledBytes;
+		return Stats;
+	}
+
+protected:
+	struct FChunk
+	{
+		TArray<uint8_t> Bytes;		 // Empty once spilled
+		int64_t			Offset = -1; // In the spill file
+		size_t			Size = 0;
+	};
+
+	int				NumPoints, NumTransforms, NumValues;
+	double			Quantum;
+	size_t			MemoryBudget;
+	Path			SpillFile;
+	int				FrameCount = 0;
+	TArray<FChunk>	Chunks;
+	TArray<uint8_t> OpenChunk;
+	TArray<int64_t> Previous; // Quantized values of the last two frames
+	TArray<FQuat>	LastRotations;
+	TArray<double>	FrameValues;
+	size_t			MemoryBytes = 0;
+	int64_t			SpilledBytes = 0;
+	int				NextChunkToSpill = 0;
+	mutable std::fstream Spill;
+
+	// Decoded chunk cache, the open chunk is decoded again when it has grown
+	mutable int			   DecodedChunk = -1;
+	mutable int			   DecodedFrames = 0;
+	mutable TArray<double> Decoded;
+
+	// Linear extrapolation from the two previous frames of the chunk
+	static int64_t Predict(int FrameInChunk, int64_t Last, int64_t BeforeLast)
+	{
+		return FrameInChunk == 0 ? 0 : FrameInChunk == 1 ? Last : 2 * Last - BeforeLast;
+	}
+
+	static void WriteVarint(TArray<uint8_t>& Bytes, uint64_t Value)
+	{
+		while (Value >= 0x80)
+		{
+			Bytes.push_back(static_cast<uint8_t>(Value | 0x80));
+			Value >>= 7;
+		}
+		Bytes.push_back(static_cast<uint8_t>(Value));
+	}
+
+	static uint64_t ReadVarint(const uint8_t*& Cursor)
+	{
+		uint64_t Value = 0;
+		for (int Shift = 0;; Shift += 7)
+		{
+			uint8_t Byte = *Cursor++;
+			Value |= static_cast<uint64_t>(Byte & 0x7F) << Shift;
+			if (!(Byte & 0x80))
+				return Value;
+		}
+	}
+
+	static FTransform ToTransform(const double* Values)
+	{
+		return FTransform(FVector(Values[0], Values[1], Values[2]), FQuat(Values[6], Values[3], Values[4], Values[5]).normalized());
+	}
+
+	void CloseChunk()
+	{
+		FChunk Chunk;
+		Chunk.Size = OpenChunk.size();
+		Chunk.Bytes = std::move(OpenChunk);
+		MemoryBytes += Chunk.Size;
+		Chunks.push_back(std::move(Chunk));
+		OpenChunk.clear();
+		SpillChunks();
+	}
+
+	// Move the oldest chunks to the spill file until the memory budget is met
+	void SpillChunks()
+	{
+		if (SpillFile.empty() || MemoryBytes <= MemoryBudget)
+			return;
+		if (!Spill.is_open())
+		{
+			Spill.open(SpillFile, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!Spill.is_open())
+			{
+				LOG_ERROR("Failed to open file: {}", SpillFile.string());
+				SpillFile.clear();
+				return;
+			}
+		}
+		while (MemoryBytes > MemoryBudget && NextChunkToSpill < static_cast<int>(Chunks.size()))
+		{
+			FChunk& Chunk = Chunks[NextChunkToSpill++];
+			Spill.seekp(SpilledBytes);
+			Spill.write(reinterpret_cast<const char*>(Chunk.Bytes.data()), static_cast<std::streamsize>(Chunk.Size));
+			Chunk.Offset = SpilledBytes;
+			SpilledBytes += static_cast<int64_t>(Chunk.Size);
+			MemoryBytes -= Chunk.Size;
+			TArray<uint8_t>().swap(Chunk.Bytes);
+		}
+		Spill.flush();
+	}
+
+	const double* DecodeFrame(int Frame) const
+	{
+		ASSERT(Frame >= 0 && Frame < FrameCount);
+		int Chunk = Frame / ChunkFrames;
+		bool bOpenChunk = Chunk == static_cast<int>(Chunks.size());
+		int	 NumChunkFrames = std::min(ChunkFrames, FrameCount - Chunk * ChunkFrames);
+		if (Chunk != DecodedChunk || NumChunkFrames != DecodedFrames)
+		{
+			TArray<uint8_t> SpilledChunk;
+			const uint8_t*	Cursor;
+			if (bOpenChunk)
+				Cursor = OpenChunk.data();
+			else if (Chunks[Chunk].Offset < 0)
+				Cursor = Chunks[Chunk].Bytes.data();
+			else
+			{
+				SpilledChunk.resize(Chunks[Chunk].Size);
+				Spill.seekg(Chunks[Chunk].Offset);
+				Spill.read(reinterpret_cast<char*>(SpilledChunk.data()), static_cast<std::streamsize>(SpilledChunk.size()));
+				Cursor = SpilledChunk.data();
+			}
+			Decoded.resize(static_cast<size_t>(NumChunkFrames) * NumValues);
+			TArray<int64_t> Last(NumValues, 0), BeforeLast(NumValues, 0);
+			for (int FrameInChunk = 0; FrameInChunk < NumChunkFrames; FrameInChunk++)
+			{
+				for (int i = 0; i < NumValues; i++)
+				{
+					uint64_t ZigZag = ReadVarint(Cursor);
+					int64_t	 Quantized = static_cast<int64_t>(ZigZag >> 1) ^ -static_cast<int64_t>(ZigZag & 1);
+					Quantized += Predict(FrameInChunk, Last[i], BeforeLast[i]);
+					BeforeLast[i] = Last[i];
+					Last[i] = Quantized;
+					Decoded[static_cast<size_t>(FrameInChunk) * NumValues + i] = Quantized * Quantum;
+				}
+			}
+			DecodedChunk = Chunk;
+			DecodedFrames = NumChunkFrames;
+		}
+		return &Decoded[static_cast<size_t>(Frame % ChunkFrames) * NumValues];
+	}
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include <algorithm>
+#include "CoreMinimal.h"
+#include "JobSystem.h"
+
+/**
+ * Data-oriented transform hierarchy.
+ * Local transforms, parents and world transforms are stored in contiguous arrays (SoA) sorted by hierarchy depth,
+ * so a parent is always updated before its children. Setters only write the local transform and raise a dirty flag,
+ * world transforms are recomputed in one batched pass per frame by Update. The pass runs depth level by depth level,
+ * each level in parallel. Within a node the quaternion products go through Eigen's SIMD kernels.
+ * Flush then hands out only the contiguous ranges of nodes whose world transform changed, e.g. to call
+ * Actor::SetTransform or to upload instance data for those ranges only.
+ */
+class TransformHierarchy
+{
+public:
+	using FHandle = int;
+
+	// Add a node, Parent must be added before its children. Handles stay valid when later nodes are added.
+	// Adding is linear in the number of nodes, build the hierarchy once and animate it afterwards
+	FHandle AddNode(FHandle Parent = -1, const FVector& Translation = FVector::Zero(), const FQuat& Rotation = FQuat::Identity())
+	{
+		ASSERT(Parent < NumNodes());
+		FHandle Handle = static_cast<FHandle>(HandleToSlot.size());
+		int Depth = Parent < 0 ? 0 : Depths[HandleToSlot[Parent]] + 1;
+
+		// Insert at the end of the depth level, and shift the slots of the deeper levels
+		int Slot = static_cast<int>(std::upper_bound(Depths.begin(), Depths.end(), Depth) - Depths.begin());
+		Depths.insert(Depths.begin() + Slot, Depth);
+		ParentSlots.insert(ParentSlots.begin() + Slot, Parent < 0 ? -1 : HandleToSlot[Parent]);
+		LocalTranslations.insert(LocalTranslations.begin() + Slot, Translation);
+		LocalRotations.insert(LocalRotations.begin() + Slot, Rotation);
+		WorldTranslations.insert(WorldTranslations.begin() + Slot, Translation);
+		WorldRotations.insert(WorldRotations.begin() + Slot, Rotation);
+		Dirty.insert(Dirty.begin() + Slot, 1);
+		Changed.insert(Changed.begin() + Slot, 0);
+		SlotToHandle.insert(SlotToHandle.begin() + Slot, Handle);
+		for (int& ParentSlot : ParentSlots)
+			if (ParentSlot >= Slot)
+				ParentSlot++;
+		for (int& HandleSlot : HandleToSlot)
+			if (HandleSlot >= Slot)
+				HandleSlot++;
+		HandleToSlot.push_back(Slot);
+		LevelsDirty = true;
+		return Handle;
+	}
+
+	[[nodiscard]] int NumNodes() const { return static_cast<int>(Depths.size()); }
+
+	void SetLocalTranslation(FHandle Handle, const FVector& Translation)
+	{
+		int Slot = HandleToSlot[Handle];
+		LocalTranslations[Slot] = Translation;
+		Dirty[Slot] = 1;
+	}
+
+	void SetLocalRotation(FHandle Handle, const FQuat& Rotation)
+	{
+		int Slot = HandleToSlot[Handle];
+		LocalRotations[Slot] = Rotation;
+		Dirty[Slot] = 1;
+	}
+
+	void SetLocalTransform(FHandle Handle, const FVector& Translation, const FQuat& Rotation)
+	{
+		int Slot = HandleToSlot[Handle];
+		LocalTranslations[Slot] = Translation;
+		LocalRotations[Slot] = Rotation;
+		Dirty[Slot] = 1;
+	}
+
+	// World transform as of the last Update
+	[[nodiscard]] FVector GetWorldTranslation(FHandle Handle) const { return WorldTranslations[HandleToSlot[Handle]]; }
+	[[nodiscard]] FQuat GetWorldRotation(FHandle Handle) const { return WorldRotations[HandleToSlot[Handle]]; }
+	[[nodiscard]] FTransform GetWorldTransform(FHandle Handle) const { return FTransform(GetWorldTranslation(Handle), GetWorldRotation(Handle)); }
+
+	// Recompute the world transforms of the dirty nodes and their descendants, once per frame
+	void Update(JobSystem& Jobs = JobSystem::Get())
+	{
+		PROFILE_SCOPE("TransformHierarchy::Update");
+		if (LevelsDirty)
+			BuildLevels();
+		for (int Level = 0; Level + 1 < static_cast<int>(LevelStarts.size()); Level++)
+		{
+			int Begin = LevelStarts[Level], End = LevelStarts[Level + 1];
+			Jobs.ParallelFor(End - Begin, [&](int i) { UpdateSlot(Begin + i); }, 256);
+		}
+		// Dirty flags are kept during the pass so children see their moved parents
+		std::fill(Dirty.begin(), Dirty.end(), 0);
+	}
+
+	/**
+	 * Call Function(Begin, End) for each contiguous range of slots changed by the last Update, and clear the changes.
+	 * Use GetSlotHandle and the slot accessors below inside Function.
+	 */
+	template <class FunctionT>
+	void Flush(FunctionT&& Function)
+	{
+		int Slot = 0;
+		while (Slot < NumNodes())
+		{
+			if (!Changed[Slot])
+			{
+				Slot++;
+				continue;
+			}
+			int End = Slot;
+			while (End < NumNodes() && Changed[End])
+				Changed[End++] = 0;
+			Function(Slot, End);
+			Slot = End;
+		}
+	}
+
+	[[nodiscard]] FHandle GetSlotHandle(int Slot) const { return SlotToHandle[Slot]; }
+	[[nodiscard]] const FVector& GetSlotWorldTranslation(int Slot) const { return WorldTranslations[Slot]; }
+	[[nodiscard]] const FQuat& GetSlotWorldRotation(int Slot) const { return WorldRotations[Slot]; }
+
+protected:
+	// Sorted by depth
+	TArray<int>		Depths;
+	TArray<int>		ParentSlots;
+	TArray<FVector> LocalTranslations;
+	TArray<FQuat>	LocalRotations;
+	TArray<FVector> WorldTranslations;
+	TArray<FQuat>	WorldRotations;
+	// Local transform edited since the last Update. uint8_t instead of bool so parallel writes do not share bits
+	TArray<uint8_t> Dirty;
+	// World transform changed since the last Flush
+	TArray<uint8_t> Changed;
+	TArray<FHandle> SlotToHandle;
+	TArray<int>		HandleToSlot;
+
+	// First slot of each depth level, plus the end
+	TArray<int> LevelStarts;
+	bool		LevelsDirty = true;
+
+	void BuildLevels()
+	{
+		LevelStarts.clear();
+		for (int Slot = 0; Slot < NumNodes(); Slot++)
+			if (Slot == 0 || Depths[Slot] != Depths[Slot - 1])
+				LevelStarts.push_back(Slot);
+		LevelStarts.push_back(NumNodes());
+		LevelsDirty = false;
+	}
+
+	void UpdateSlot(int Slot)
+	{
+		int Parent = ParentSlots[Slot];
+		// A node is recomputed if it was edited or its parent moved during this pass
+		if (!Dirty[Slot] && (Parent < 0 || !Dirty[Parent]))
+			return;
+		if (Parent < 0)
+		{
+			WorldTranslations[Slot] = LocalTranslations[Slot];
+			WorldRotations[Slot] = LocalRotations[Slot];
+		}
+		else
+		{
+			WorldTranslations[Slot] = WorldTranslations[Parent] + WorldRotations[Parent] * LocalTranslations[Slot];
+			WorldRotations[Slot] = (WorldRotations[Parent] * LocalRotations[Slot]).normalized();
+		}
+		Dirty[Slot] = 1;
+		Changed[Slot] = 1;
+	}
+};
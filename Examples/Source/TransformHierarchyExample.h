@@ -0,0 +1,68 @@
+#pragma once
+#include "Actors/CameraActor.h"
+#include "Game/StaticMeshActor.h"
+#include "Game/World.h"
+#include "LambdaUIWidget.h"
+#include "MeshBuffers.h"
+#include "Mesh/BasicShapesLibrary.h"
+#include "ProfilerTimeline.h"
+#include "TransformHierarchy.h"
+
+/****************************************************************************************
+ * TransformHierarchyExample
+ * A few chains of links animated through a TransformHierarchy. Each frame only the local
+ * joint rotations are written, the world transforms are updated in one batched pass,
+ * and SetTransform is called only for the links whose world transform changed.
+ * The profiler window shows where the frame time goes.
+ ****************************************************************************************/
+
+inline auto TransformHierarchyExample()
+{
+	return [](World& world)
+	{
+		constexpr int	 NumChains = 8;
+		constexpr int	 NumLinks = 24;
+		constexpr double LinkLength = 0.1;
+
+		auto Camera = world.SpawnActor<CameraActor>("MainCamera");
+		Camera->SetTranslation({-6, 0, 1}); Camera->LookAt({0, 0, 1});
+
+		auto Hierarchy = std::make_shared<TransformHierarchy>();
+		auto Links = std::make_shared<TArray<ObjectPtr<StaticMeshActor>>>();
+		// Each link gets its own mesh, a mesh shared by the actors would also share its material between them
+		auto LinkBuffers = FMeshBuffers::FromStaticMesh(*BasicShapesLibrary::GenerateCuboid(FVector{LinkLength, 0.03, 0.03}));
+		for (int Chain = 0; Chain < NumChains; Chain++)
+		{
+			auto Parent = Hierarchy->AddNode(-1, FVector{0, 0.4 * (Chain - NumChains * 0.5), 0}, FQuat(AngleAxisd(-M_PI_2, FVector::UnitY())));
+			Links->push_back(world.SpawnActor<StaticMeshActor>("Base", LinkBuffers.ToStaticMesh()));
+			for (int Link = 1; Link < NumLinks; Link++)
+			{
+				Parent = Hierarchy->AddNode(Parent, FVector{LinkLength, 0, 0});
+				Links->push_back(world.SpawnActor<StaticMeshActor>("Link", LinkBuffers.ToStaticMesh()));
+			}
+		}
+
+		world.AddWidget<LambdaUIWidget>(DrawProfilerTimeline);
+
+		// Owned by the tick function, so reloading the example starts the animation over
+		auto TotalTime = std::make_shared<double>(0.);
+		world.TickFunction = [Hierarchy, Links, TotalTime](double DeltaTime, World&) {
+			*TotalTime += DeltaTime;
+			for (int Chain = 0; Chain < NumChains; Chain++)
+			{
+				for (int Link = 1; Link < NumLinks; Link++)
+				{
+					double Angle = 0.15 * sin(*TotalTime * 2. + Chain * 0.7 + Link * 0.3);
+					Hierarchy->SetLocalRotation(Chain * NumLinks + Link, FQuat(AngleAxisd(Angle, FVector::UnitZ())));
+				}
+			}
+
+			Hierarchy->Update();
+			Hierarchy->Flush([&](int Begin, int End) {
+				for (int Slot = Begin; Slot < End; Slot++)
+					(*Links)[Hierarchy->GetSlotHandle(Slot)]->SetTransform(
+						FTransform(Hierarchy->GetSlotWorldTranslation(Slot), Hierarchy->GetSlotWorldRotation(Slot)));
+			});
+		};
+	};
+}
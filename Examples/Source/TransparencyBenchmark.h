@@ -0,0 +1,143 @@
+#pragma once
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "CommandLine.h"
+#include "CoreMinimal.h"
+#include "CpuPathTracer.h"
+#include "CpuTransparency.h"
+#include "MeshShapes.h"
+
+/**
+ * NumParts translucent boxes of random size, orientation and color packed into a cube so that many of them
+ * intersect, over an opaque floor. The seed is fixed, so the scene is the same in every run.
+ */
+inline CpuScene MakeTranslucentPartsScene(int NumParts, FCpuCamera& OutCamera)
+{
+	CpuScene Scene;
+	int		 Box = Scene.AddMesh(MeshShapes::GenerateCuboid(FVector{ 1., 1., 1. }));
+
+	int Floor = Scene.AddMaterial({ Vector3f::Constant(0.6f), 1.f });
+	Scene.AddInstance(Box, Floor, Affine3f(Translation3f(0.f, 0.f, -1.1f) * Scaling(Vector3f(6.f, 6.f, 0.05f))));
+
+	std::mt19937						  Random(42);
+	std::uniform_real_distribution<float> Uniform(0.f, 1.f);
+	std::normal_distribution<float>		  Normal;
+	TArray<int>							  Materials;
+	for (int i = 0; i < 16; i++)
+		Materials.push_back(Scene.AddMaterial({ Vector3f(Uniform(Random), Uniform(Random), Uniform(Random)), 0.2f + 0.4f * Uniform(Random) }));
+	for (int i = 0; i < NumParts; i++)
+	{
+		Vector3f	Position = Vector3f(Uniform(Random), Uniform(Random), Uniform(Random)) * 2.f - Vector3f::Ones();
+		Vector3f	Size = Vector3f(Uniform(Random), Uniform(Random), Uniform(Random)) * 0.4f + Vector3f::Constant(0.1f);
+		Quaternionf Rotation(Normal(Random), Normal(Random), Normal(Random), Normal(Random));
+		Affine3f	Transform = Translation3f(Position) * Rotation.normalized() * Scaling(Size);
+		Scene.AddInstance(Box, Materials[i % Materials.size()], Transform);
+	}
+	Scene.Build();
+	OutCamera = FCpuCamera::LookAt({ -4.f, -2.f, 2.f }, Vector3f::Zero(), 45.f);
+	return Scene;
+}
+
+/**
+ * Compare the transparency modes on the translucent parts scene: compose time and error against the
+ * per-pixel sorted reference, reported as JSON. The fragments are gathered once and timed on their own,
+ * each mode is timed composing that same frame. Images are saved as .ppm into ImageFolder when it is not empty.
+ * Run it with
+ *	MechEngineExamples --oit-benchmark [--parts N] [--size W H] [--images Folder] [--out result.json]
+ */
+inline String RunTransparencyBenchmark(int NumParts, int Width, int Height, const Path& ImageFolder = {})
+{
+	FCpuCamera				Camera;
+	CpuScene				Scene = MakeTranslucentPartsScene(NumParts, Camera);
+	CpuTransparencyRenderer Renderer(Scene, Camera, Width, Height);
+
+	// Gather once, warming up the job system with the first run. The reference is composed from the same frame
+	double GatherSeconds = std::numeric_limits<double>::max();
+	for (int Repeat = 0; Repeat < 3; Repeat++)
+	{
+		Renderer.GatherFrame();
+		GatherSeconds = std::min(GatherSeconds, Renderer.GetStats().GatherSeconds);
+	}
+	TArray<Vector3f> Reference = Renderer.ComposeFrame(ETransparencyMode::PerPixelSorted);
+	double			 FragmentsPerPixel = static_cast<double>(Renderer.GetStats().Fragments) / (Width * Height);
+	if (!ImageFolder.empty())
+		Path::CreateDirectory(ImageFolder);
+
+	std::ostringstream Json;
+	Json.precision(9);
+	Json << "{\n"
+		 << "\t\"Scene\": \"TranslucentParts\",\n"
+		 << "\t\"Parts\": " << NumParts << ",\n"
+		 << "\t\"Width\": " << Width << ",\n"
+		 << "\t\"Height\": " << Height << ",\n"
+		 << "\t\"FragmentsPerPixel\": " << FragmentsPerPixel << ",\n"
+		 << "\t\"GatherSeconds\": " << GatherSeconds << ",\n"
+		 << "\t\"Modes\": [";
+	const ETransparencyMode Modes[] = { ETransparencyMode::SortedObjects, ETransparencyMode::WeightedBlended, ETransparencyMode::PerPixelSorted };
+	for (int i = 0; i < 3; i++)
+	{
+		// Best of three, the passes are short enough for the scheduling noise to matter
+		TArray<Vector3f> Image;
+		double			 Seconds = std::numeric_limits<double>::max();
+		for (int Repeat = 0; Repeat < 3; Repeat++)
+		{
+			Image = Renderer.ComposeFrame(Modes[i]);
+			Seconds = std::min(Seconds, Renderer.GetStats().ComposeSeconds);
+		}
+		if (!ImageFolder.empty())
+			CpuPathTracer::SaveImage(Image, Width, Height, ImageFolder / (String(TransparencyModeName(Modes[i])) + ".ppm"));
+		Json << (i ? ",\n\t\t" : "\n\t\t") << "{ \"Mode\": \"" << TransparencyModeName(Modes[i]) << "\", \"ComposeSeconds\": " << Seconds
+			 << ", \"RMSE\": " << ImageRMSE(Image, Reference) << " }";
+	}
+	Json << "\n\t]\n}\n";
+	return Json.str();
+}
+
+// Entry point of the --oit-benchmark command line mode, prints the result as JSON
+inline int TransparencyBenchmarkMain(int argc, char* argv[])
+{
+	auto PrintUsage = [] {
+		std::cerr << "Usage: MechEngineExamples --oit-benchmark [--parts N] [--size W H] [--images Folder] [--out result.json]\n";
+		return 1;
+	};
+	int	 NumParts = 400, Width = 512, Height = 512;
+	Path ImageFolder, Output;
+	for (int i = 2; i < argc; i++)
+	{
+		String Option = argv[i];
+		if (Option == "--parts" && i + 1 < argc)
+		{
+			if (!ParseArgument("--parts", argv[++i], NumParts, 1))
+				return PrintUsage();
+		}
+		else if (Option == "--size" && i + 2 < argc)
+		{
+			if (!ParseArgument("--size", argv[++i], Width, 1, 16384) || !ParseArgument("--size", argv[++i], Height, 1, 16384))
+				return PrintUsage();
+		}
+		else if (Option == "--images" && i + 1 < argc)
+			ImageFolder = argv[++i];
+		else if (Option == "--out" && i + 1 < argc)
+			Output = argv[++i];
+		else
+		{
+			LOG_ERROR("Unknown benchmark option: {}", Option);
+			return PrintUsage();
+		}
+	}
+
+	String Json = RunTransparencyBenchmark(NumParts, Width, Height, ImageFolder);
+	std::cout << Json;
+	if (!Output.empty())
+	{
+		std::ofstream OutFile(Output);
+		if (!(OutFile << Json))
+		{
+			LOG_ERROR("Failed to write benchmark result: {}", Output.string());
+			return 1;
+		}
+	}
+	return 0;
+}
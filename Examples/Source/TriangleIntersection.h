@@ -0,0 +1,463 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <span>
+#include "CoreMinimal.h"
+#include "JobSystem.h"
+#include "MeshBuffers.h"
+
+/**
+ * Orientation predicates with exact signs.
+ * The determinant is first evaluated in double with Shewchuk's static error bound; when the bound cannot
+ * certify its sign, it is evaluated again exactly as a floating point expansion (sums of non-overlapping doubles).
+ * The fallback is slow but only taken for nearly degenerate inputs, e.g. coplanar or touching triangles.
+ */
+namespace RobustPredicates
+{
+	constexpr double Epsilon = std::numeric_limits<double>::epsilon() * 0.5;
+	constexpr double Orient3DBound = (7. + 56. * Epsilon) * Epsilon;
+	constexpr double Orient2DBound = (3. + 16. * Epsilon) * Epsilon;
+
+	// Number of exact evaluations on this thread, to tell how often the filter fails
+	inline thread_local int NumExactEvaluations = 0;
+
+	// Value is approximate, Sign is exact
+	struct FOrientation
+	{
+		double Value = 0.;
+		int	   Sign = 0;
+	};
+
+	// Exact sum of products of doubles, grown term by term
+	class FExpansion
+	{
+	public:
+		void AddProduct(double A, double B, double C, int Sign)
+		{
+			// a * b = High + Low exactly, then each part times c exactly
+			double High = A * B, Low = std::fma(A, B, -High);
+			for (double Part : { High, Low })
+			{
+				double Product = Part * C;
+				Add(Sign * Product);
+				Add(Sign * std::fma(Part, C, -Product));
+			}
+		}
+
+		void AddProduct(double A, double B, int Sign)
+		{
+			double Product = A * B;
+			Add(Sign * Product);
+			Add(Sign * std::fma(A, B, -Product));
+		}
+
+		// The components are non-overlapping and increasing, the largest one has the sign of the sum
+		[[nodiscard]] int Sign() const
+		{
+			for (int i = NumComponents - 1; i >= 0; i--)
+				if (Components[i] != 0.)
+					return Components[i] > 0. ? 1 : -1;
+			return 0;
+		}
+
+	protected:
+		double Components[256];
+		int	   NumComponents = 0;
+
+		// Shewchuk's Grow-Expansion with zero elimination
+		void Add(double Value)
+		{
+			int Write = 0;
+			for (int i = 0; i < NumComponents; i++)
+			{
+				double Sum = Value + Components[i];
+				double Virtual = Sum - Value;
+				double Error = (Value - (Sum - Virtual)) + (Components[i] - Virtual);
+				Value = Sum;
+				if (Error != 0.)
+					Components[Write++] = Error;
+			}
+			if (Value != 0.)
+				Components[Write++] = Value;
+			NumComponents = Write;
+		}
+	};
+
+	// Sign of det[A - D, B - D, C - D] as products of the input coordinates, the expanded 4x4 determinant with a column of ones
+	inline int ExactOrient3D(const FVector& A, const FVector& B, const FVector& C, const FVector& D)
+	{
+		const FVector* Rows[4] = { &A, &B, &C, &D };
+		constexpr int  Permutations[6][3] = { { 0, 1, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 0, 2, 1 }, { 2, 1, 0 }, { 1, 0, 2 } };
+		FExpansion	   Sum;
+		for (int Removed = 0; Removed < 4; Removed++)
+		{
+			// Cofactor of the ones column, (-1)^(Removed + 3)
+			int			   CofactorSign = Removed % 2 ? 1 : -1;
+			const FVector* Minor[3];
+			for (int Row = 0, i = 0; Row < 4; Row++)
+				if (Row != Removed)
+					Minor[i++] = Rows[Row];
+			for (int p = 0; p < 6; p++)
+			{
+				const int* Permutation = Permutations[p];
+				Sum.AddProduct((*Minor[0])[Permutation[0]], (*Minor[1])[Permutation[1]], (*Minor[2])[Permutation[2]], CofactorSign * (p < 3 ? 1 : -1));
+			}
+		}
+		return Sum.Sign();
+	}
+
+	// Positive when D is below the plane through A, B and C seen counterclockwise from above
+	inline FOrientation Orient3D(const FVector& A, const FVector& B, const FVector& C, const FVector& D)
+	{
+		FVector AD = A - D, BD = B - D, CD = C - D;
+		double	BCx = BD.x() * CD.y(), CBx = CD.x() * BD.y();
+		double	CAx = CD.x() * AD.y(), ACx = AD.x() * CD.y();
+		double	ABx = AD.x() * BD.y(), BAx = BD.x() * AD.y();
+		double	Determinant = AD.z() * (BCx - CBx) + BD.z() * (CAx - ACx) + CD.z() * (ABx - BAx);
+		double	Permanent = (std::abs(BCx) + std::abs(CBx)) * std::abs(AD.z()) + (std::abs(CAx) + std::abs(ACx)) * std::abs(BD.z())
+						 + (std::abs(ABx) + std::abs(BAx)) * std::abs(CD.z());
+		if (std::abs(Determinant) > Orient3DBound * Permanent)
+			return { Determinant, Determinant > 0. ? 1 : -1 };
+		NumExactEvaluations++;
+		return { Determinant, ExactOrient3D(A, B, C, D) };
+	}
+
+	// Sign of det[A - C, B - C] in the plane of the axes X and Y, positive when A, B, C turn counterclockwise
+	inline int Orient2D(const FVector& A, const FVector& B, const FVector& C, int X, int Y)
+	{
+		double Left = (A[X] - C[X]) * (B[Y] - C[Y]), Right = (A[Y] - C[Y]) * (B[X] - C[X]);
+		double Determinant = Left - Right;
+		if (std::abs(Determinant) > Orient2DBound * (std::abs(Left) + std::abs(Right)))
+			return Determinant > 0. ? 1 : -1;
+		NumExactEvaluations++;
+		// Expanded 3x3 determinant with a column of ones
+		FExpansion Sum;
+		Sum.AddProduct(A[X], B[Y], 1);
+		Sum.AddProduct(B[X], C[Y], 1);
+		Sum.AddProduct(C[X], A[Y], 1);
+		Sum.AddProduct(A[X], C[Y], -1);
+		Sum.AddProduct(B[X], A[Y], -1);
+		Sum.AddProduct(C[X], B[Y], -1);
+		return Sum.Sign();
+	}
+} // namespace RobustPredicates
+
+/**
+ * Intersection of triangle pairs in bulk, e.g. the candidate pairs of a mesh intersection broad phase.
+ * Whether two triangles intersect is decided exactly (Guigue and Devillers' test on robust orientations),
+ * so there are no false positives or negatives to compensate for. The intersection segment is then
+ * constructed in double precision. Pairs are processed in parallel, each writes its own slot of the output.
+ * Usage:
+ *	TArray<FTriangleIntersection> Segments(Pairs.size());
+ *	auto Stats = TriangleIntersection::IntersectPairs(MeshA, MeshB, Pairs, Segments);
+ *	for (const auto& Segment : Segments) if (Segment.Type == ETriangleIntersection::Segment) ...
+ * Coplanar pairs only report one point of their overlap, to keep the bulk output small. Pass them to
+ * TriangleIntersection::CoplanarPolygon when the whole overlap region is needed.
+ */
+enum class ETriangleIntersection : uint8_t
+{
+	None,
+	Segment,	// Crossing or touching triangles, Start and End are the ends of their intersection (equal when touching at a point)
+	Coplanar,	// Overlapping triangles in the same plane, Start and End are one point of the overlap
+	Degenerate, // One of the triangles has collinear vertices, it has no plane and the pair is not tested
+};
+
+struct FTriangleIntersection
+{
+	FVector				  Start = FVector::Zero();
+	FVector				  End = FVector::Zero();
+	ETriangleIntersection Type = ETriangleIntersection::None;
+
+	[[nodiscard]] bool Intersects() const { return Type == ETriangleIntersection::Segment || Type == ETriangleIntersection::Coplanar; }
+};
+
+namespace TriangleIntersection
+{
+	using namespace RobustPredicates;
+
+	struct FStats
+	{
+		int NumIntersecting = 0;
+		int NumDegenerate = 0;		 // Pairs with a zero area triangle, left untested
+		int NumExactEvaluations = 0; // Orientations the floating point filter could not decide
+	};
+
+	// Whether the vertices of T are collinear, exactly: they are when they are in all three axis planes
+	inline bool IsDegenerate(const FVector (&T)[3])
+	{
+		return Orient2D(T[0], T[1], T[2], 0, 1) == 0 && Orient2D(T[0], T[1], T[2], 1, 2) == 0 && Orient2D(T[0], T[1], T[2], 2, 0) == 0;
+	}
+
+	// Whether the segment P Q and the segment R S of one plane intersect, in 2D along the axes X and Y
+	inline bool SegmentsIntersect2D(const FVector& P, const FVector& Q, const FVector& R, const FVector& S, int X, int Y)
+	{
+		int D1 = Orient2D(P, Q, R, X, Y), D2 = Orient2D(P, Q, S, X, Y), D3 = Orient2D(R, S, P, X, Y), D4 = Orient2D(R, S, Q, X, Y);
+		if (D1 * D2 < 0 && D3 * D4 < 0)
+			return true;
+		// Collinear touching
+		auto OnSegment = [X, Y](const FVector& A, const FVector& B, const FVector& C) {
+			return std::min(A[X], B[X]) <= C[X] && C[X] <= std::max(A[X], B[X]) && std::min(A[Y], B[Y]) <= C[Y] && C[Y] <= std::max(A[Y], B[Y]);
+		};
+		return (D1 == 0 && OnSegment(P, Q, R)) || (D2 == 0 && OnSegment(P, Q, S)) || (D3 == 0 && OnSegment(R, S, P)) || (D4 == 0 && OnSegment(R, S, Q));
+	}
+
+	inline bool PointInTriangle2D(const FVector& P, const FVector (&T)[3], int X, int Y)
+	{
+		int D0 = Orient2D(T[0], T[1], P, X, Y), D1 = Orient2D(T[1], T[2], P, X, Y), D2 = Orient2D(T[2], T[0], P, X, Y);
+		return (D0 >= 0 && D1 >= 0 && D2 >= 0) || (D0 <= 0 && D1 <= 0 && D2 <= 0);
+	}
+
+	// Overlap of two coplanar triangles, projected along the largest axis of their normal
+	inline bool CoplanarIntersect(const FVector (&A)[3], const FVector (&B)[3], FVector& OutPoint)
+	{
+		FVector Normal = (A[1] - A[0]).cross(A[2] - A[0]).cwiseAbs();
+		int		Axis = Normal.x() > Normal.y() ? (Normal.x() > Normal.z() ? 0 : 2) : (Normal.y() > Normal.z() ? 1 : 2);
+		int		X = (Axis + 1) % 3, Y = (Axis + 2) % 3;
+		for (int i = 0; i < 3; i++)
+		{
+			if (PointInTriangle2D(A[i], B, X, Y))
+			{
+				OutPoint = A[i];
+				return true;
+			}
+			if (PointInTriangle2D(B[i], A, X, Y))
+			{
+				OutPoint = B[i];
+				return true;
+			}
+		}
+		for (int i = 0; i < 3; i++)
+			for (int j = 0; j < 3; j++)
+				if (SegmentsIntersect2D(A[i], A[(i + 1) % 3], B[j], B[(j + 1) % 3], X, Y))
+				{
+					// Point on the edge of A closest to the edge of B's line, good enough for a contact point
+					FVector Edge = A[(i + 1) % 3] - A[i], Other = B[(j + 1) % 3] - B[j];
+					FVector Perpendicular = FVector::Unit(Axis).cross(Other);
+					double	Denominator = Edge.dot(Perpendicular);
+					double	T = Denominator != 0. ? std::clamp((B[j] - A[i]).dot(Perpendicular) / Denominator, 0., 1.) : 0.;
+					OutPoint = A[i] + Edge * T;
+					return true;
+				}
+		return false;
+	}
+
+	/**
+	 * Overlap region of two coplanar triangles as a convex polygon of up to 6 points, returns the number of points.
+	 * A is clipped by the edges of B in the projection along the largest axis of the normal, in double precision:
+	 * use Intersect to decide whether they overlap. A touching pair comes out as a zero area polygon, or no points at all.
+	 */
+	inline int CoplanarPolygon(const FVector (&A)[3], const FVector (&B)[3], FVector (&OutPolygon)[6])
+	{
+		FVector Normal = (A[1] - A[0]).cross(A[2] - A[0]).cwiseAbs();
+		int		Axis = Normal.x() > Normal.y() ? (Normal.x() > Normal.z() ? 0 : 2) : (Normal.y() > Normal.z() ? 1 : 2);
+		int		X = (Axis + 1) % 3, Y = (Axis + 2) % 3;
+		// Inside of B's edges is on the side of its third vertex
+		double Winding = Orient2D(B[0], B[1], B[2], X, Y);
+		auto   Inside = [&](const FVector& Begin, const FVector& End, const FVector& Point) {
+			return Winding * ((End[X] - Begin[X]) * (Point[Y] - Begin[Y]) - (End[Y] - Begin[Y]) * (Point[X] - Begin[X]));
+		};
+
+		FVector Polygon[6] = { A[0], A[1], A[2] }, Clipped[6];
+		int		NumPoints = 3;
+		for (int Edge = 0; Edge < 3 && NumPoints > 0; Edge++)
+		{
+			const FVector &Begin = B[Edge], &End = B[(Edge + 1) % 3];
+			int			   NumClipped = 0;
+			for (int i = 0; i < NumPoints && NumClipped < 6; i++)
+			{
+				const FVector &Current = Polygon[i], &Next = Polygon[(i + 1) % NumPoints];
+				double		   DCurrent = Inside(Begin, End, Current), DNext = Inside(Begin, End, Next);
+				if (DCurrent >= 0.)
+					Clipped[NumClipped++] = Current;
+				if ((DCurrent >= 0.) != (DNext >= 0.) && NumClipped < 6)
+					Clipped[NumClipped++] = Current + (Next - Current) * std::clamp(DCurrent / (DCurrent - DNext), 0., 1.);
+			}
+			std::copy(Clipped, Clipped + NumClipped, Polygon);
+			NumPoints = NumClipped;
+		}
+		std::copy(Polygon, Polygon + NumPoints, OutPolygon);
+		return NumPoints;
+	}
+
+	// Points where the triangle T meets the plane it crosses, from the orientations of its vertices to that plane
+	inline int PlaneCrossing(const FVector (&T)[3], const FOrientation (&D)[3], FVector (&OutPoints)[2])
+	{
+		int NumPoints = 0;
+		for (int i = 0; i < 3 && NumPoints < 2; i++)
+		{
+			int j = (i + 1) % 3;
+			if (D[i].Sign == 0)
+				OutPoints[NumPoints++] = T[i];
+			else if (D[i].Sign * D[j].Sign < 0 && NumPoints < 2)
+			{
+				// The signs are exact, keep the interpolation inside the edge even when the values are not
+				double Ratio = std::clamp(D[i].Value / (D[i].Value - D[j].Value), 0., 1.);
+				OutPoints[NumPoints++] = T[i] + (T[j] - T[i]) * Ratio;
+			}
+		}
+		if (NumPoints == 1)
+			OutPoints[1] = OutPoints[0];
+		return NumPoints;
+	}
+
+	// Orientation of D to the plane of A, B, C as in Guigue and Devillers: (D - C) . ((A - C) x (B - C))
+	inline FOrientation Side(const FVector& A, const FVector& B, const FVector& C, const FVector& D) { return Orient3D(A, B, D, C); }
+
+	// Whether the intervals of the two triangles on the line of their planes overlap, for triangles in canonical position
+	inline bool CheckMinMax(const FVector& P1, const FVector& Q1, const FVector& R1, const FVector& P2, const FVector& Q2, const FVector& R2)
+	{
+		return Side(P2, P1, Q1, Q2).Sign <= 0 && Side(P2, R1, P1, R2).Sign <= 0;
+	}
+
+	// Permute the second triangle so that P2 is alone on its side of the first triangle's plane, 0 is coplanar
+	inline int Canonical2(const FVector& P1, const FVector& Q1, const FVector& R1, const FVector& P2, const FVector& Q2, const FVector& R2, int DP2, int DQ2, int DR2)
+	{
+		if (DP2 > 0)
+		{
+			if (DQ2 > 0)
+				return CheckMinMax(P1, R1, Q1, R2, P2, Q2);
+			if (DR2 > 0)
+				return CheckMinMax(P1, R1, Q1, Q2, R2, P2);
+			return CheckMinMax(P1, Q1, R1, P2, Q2, R2);
+		}
+		if (DP2 < 0)
+		{
+			if (DQ2 < 0)
+				return CheckMinMax(P1, Q1, R1, R2, P2, Q2);
+			if (DR2 < 0)
+				return CheckMinMax(P1, Q1, R1, Q2, R2, P2);
+			return CheckMinMax(P1, R1, Q1, P2, Q2, R2);
+		}
+		if (DQ2 < 0)
+			return DR2 >= 0 ? CheckMinMax(P1, R1, Q1, Q2, R2, P2) : CheckMinMax(P1, Q1, R1, P2, Q2, R2);
+		if (DQ2 > 0)
+			return DR2 > 0 ? CheckMinMax(P1, R1, Q1, P2, Q2, R2) : CheckMinMax(P1, Q1, R1, Q2, R2, P2);
+		if (DR2 > 0)
+			return CheckMinMax(P1, Q1, R1, R2, P2, Q2);
+		if (DR2 < 0)
+			return CheckMinMax(P1, R1, Q1, R2, P2, Q2);
+		return 0;
+	}
+
+	/**
+	 * Whether triangles A and B intersect, after Guigue and Devillers, Fast and robust triangle-triangle overlap test
+	 * using orientation predicates, 2003. The first triangle is permuted so that P1 is alone on its side of B's plane,
+	 * then B so that P2 is alone on its side of A's plane. DA and DB are the sides of the vertices to the other plane.
+	 */
+	inline bool Overlap(const FVector (&A)[3], const FVector (&B)[3], const int (&DA)[3], const int (&DB)[3])
+	{
+		const FVector &P1 = A[0], &Q1 = A[1], &R1 = A[2], &P2 = B[0], &Q2 = B[1], &R2 = B[2];
+		int			   DP1 = DA[0], DQ1 = DA[1], DR1 = DA[2], DP2 = DB[0], DQ2 = DB[1], DR2 = DB[2];
+		if (DP1 > 0)
+		{
+			if (DQ1 > 0)
+				return Canonical2(R1, P1, Q1, P2, R2, Q2, DP2, DR2, DQ2);
+			if (DR1 > 0)
+				return Canonical2(Q1, R1, P1, P2, R2, Q2, DP2, DR2, DQ2);
+			return Canonical2(P1, Q1, R1, P2, Q2, R2, DP2, DQ2, DR2);
+		}
+		if (DP1 < 0)
+		{
+			if (DQ1 < 0)
+				return Canonical2(R1, P1, Q1, P2, Q2, R2, DP2, DQ2, DR2);
+			if (DR1 < 0)
+				return Canonical2(Q1, R1, P1, P2, Q2, R2, DP2, DQ2, DR2);
+			return Canonical2(P1, Q1, R1, P2, R2, Q2, DP2, DR2, DQ2);
+		}
+		if (DQ1 < 0)
+			return DR1 >= 0 ? Canonical2(Q1, R1, P1, P2, R2, Q2, DP2, DR2, DQ2) : Canonical2(P1, Q1, R1, P2, Q2, R2, DP2, DQ2, DR2);
+		if (DQ1 > 0)
+			return DR1 > 0 ? Canonical2(P1, Q1, R1, P2, R2, Q2, DP2, DR2, DQ2) : Canonical2(Q1, R1, P1, P2, Q2, R2, DP2, DQ2, DR2);
+		if (DR1 > 0)
+			return Canonical2(R1, P1, Q1, P2, Q2, R2, DP2, DQ2, DR2);
+		return Canonical2(R1, P1, Q1, P2, R2, Q2, DP2, DR2, DQ2);
+	}
+
+	// Intersection of triangles A and B. Whether they intersect is decided exactly, the segment is rounded
+	inline FTriangleIntersection Intersect(const FVector (&A)[3], const FVector (&B)[3])
+	{
+		FTriangleIntersection Result;
+		// Every orientation to the plane of a zero area triangle is zero, the pair would pass for coplanar
+		if (IsDegenerate(A) || IsDegenerate(B))
+		{
+			Result.Type = ETriangleIntersection::Degenerate;
+			return Result;
+		}
+		FOrientation DA[3], DB[3];
+		for (int i = 0; i < 3; i++)
+			DA[i] = Side(B[0], B[1], B[2], A[i]);
+		if (DA[0].Sign * DA[1].Sign > 0 && DA[0].Sign * DA[2].Sign > 0)
+			return Result;
+		for (int i = 0; i < 3; i++)
+			DB[i] = Side(A[0], A[1], A[2], B[i]);
+		if (DB[0].Sign * DB[1].Sign > 0 && DB[0].Sign * DB[2].Sign > 0)
+			return Result;
+
+		if (DA[0].Sign == 0 && DA[1].Sign == 0 && DA[2].Sign == 0)
+		{
+			FVector Point;
+			if (CoplanarIntersect(A, B, Point))
+				Result = { Point, Point, ETriangleIntersection::Coplanar };
+			return Result;
+		}
+		if (!Overlap(A, B, { DA[0].Sign, DA[1].Sign, DA[2].Sign }, { DB[0].Sign, DB[1].Sign, DB[2].Sign }))
+			return Result;
+
+		// Segment: the overlap of the crossings of each triangle with the other's plane, along their common line
+		FVector CrossingA[2], CrossingB[2];
+		PlaneCrossing(A, DA, CrossingA);
+		PlaneCrossing(B, DB, CrossingB);
+		FVector Line = (A[1] - A[0]).cross(A[2] - A[0]).cross((B[1] - B[0]).cross(B[2] - B[0]));
+		auto	Project = [&Line](const FVector& Point) { return Line.dot(Point); };
+		if (Project(CrossingA[0]) > Project(CrossingA[1]))
+			std::swap(CrossingA[0], CrossingA[1]);
+		if (Project(CrossingB[0]) > Project(CrossingB[1]))
+			std::swap(CrossingB[0], CrossingB[1]);
+		Result.Start = Project(CrossingA[0]) > Project(CrossingB[0]) ? CrossingA[0] : CrossingB[0];
+		Result.End = Project(CrossingA[1]) < Project(CrossingB[1]) ? CrossingA[1] : CrossingB[1];
+		// Touching ends can come out in reverse by rounding
+		if (Project(Result.Start) > Project(Result.End))
+			Result.Start = Result.End = (Result.Start + Result.End) * 0.5;
+		Result.Type = ETriangleIntersection::Segment;
+		return Result;
+	}
+
+	/**
+	 * Intersect triangle Pairs[i].x() of MeshA with triangle Pairs[i].y() of MeshB into Out[i], in parallel.
+	 * Out must have one slot per pair.
+	 */
+	inline FStats IntersectPairs(const FMeshBuffers& MeshA, const FMeshBuffers& MeshB, std::span<const Vector2i> Pairs, std::span<FTriangleIntersection> Out,
+		JobSystem& Jobs = JobSystem::Get())
+	{
+		FStats Stats;
+		if (Out.size() < Pairs.size())
+		{
+			LOG_ERROR("Triangle intersection output has {} slots for {} pairs", Out.size(), Pairs.size());
+			return Stats;
+		}
+		constexpr int	 Grain = 256;
+		std::atomic<int> NumIntersecting = 0, NumDegenerate = 0, NumExact = 0;
+		Jobs.ParallelFor((static_cast<int>(Pairs.size()) + Grain - 1) / Grain, [&](int Chunk) {
+			int Begin = Chunk * Grain, End = std::min(Begin + Grain, static_cast<int>(Pairs.size()));
+			int Count = 0, Degenerate = 0, ExactBefore = NumExactEvaluations;
+			for (int i = Begin; i < End; i++)
+			{
+				const Vector3i& TriangleA = MeshA.Triangles[Pairs[i].x()];
+				const Vector3i& TriangleB = MeshB.Triangles[Pairs[i].y()];
+				FVector			A[3] = { MeshA.Vertices[TriangleA[0]], MeshA.Vertices[TriangleA[1]], MeshA.Vertices[TriangleA[2]] };
+				FVector			B[3] = { MeshB.Vertices[TriangleB[0]], MeshB.Vertices[TriangleB[1]], MeshB.Vertices[TriangleB[2]] };
+				Out[i] = Intersect(A, B);
+				Count += Out[i].Intersects();
+				Degenerate += Out[i].Type == ETriangleIntersection::Degenerate;
+			}
+			NumIntersecting.fetch_add(Count, std::memory_order_relaxed);
+			NumDegenerate.fetch_add(Degenerate, std::memory_order_relaxed);
+			NumExact.fetch_add(NumExactEvaluations - ExactBefore, std::memory_order_relaxed);
+		});
+		Stats.NumIntersecting = NumIntersecting;
+		Stats.NumDegenerate = NumDegenerate;
+		Stats.NumExactEvaluations = NumExact;
+		return Stats;
+	}
+} // namespace TriangleIntersection
@@ -7,6 +7,7 @@
 #include "Game/World.h"
 #include "Materials/Material.h"
 #include "Mesh/BasicShapesLibrary.h"
+#include "WireframeEdgeCache.h"
 
 inline auto WireFrameMaterialExample()
 {
@@ -21,5 +22,13 @@ inline auto WireFrameMaterialExample()
 
 		world.SpawnActor<StaticMeshActor>("Rabit", StaticMesh::LoadObj("stanford-bunny.obj")->Normalized());
 
+		// Feature edges only, from the cached edge buffer: the rims of the cylinder are drawn, the side tessellation is not
+		auto Cylinder = BasicShapesLibrary::GenerateCylinder(1., 0.5);
+		Cylinder->Translate({0, 3, 0});
+		world.SpawnActor<StaticMeshActor>("Cylinder", Cylinder);
+		auto Edges = WireframeEdgeCache::Get().Find(Cylinder);
+		for (const auto& Edge : Edges->FeatureEdges(DegToRad(30.)))
+			world.DebugDrawLine(Cylinder->GetVertex(Edge[0]), Cylinder->GetVertex(Edge[1]), RGB(0, 0, 0), 2);
+
 	};
 }
\ No newline at end of file
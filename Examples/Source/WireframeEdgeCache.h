@@ -0,0 +1,196 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include "CoreMinimal.h"
+#include "Mesh/StaticMesh.h"
+
+/**
+ * Unique edges of a triangle mesh with their adjacent faces, the topology part of a wireframe overlay.
+ * Feature edges are the edges whose dihedral angle is at least a threshold, plus the boundary and non-manifold edges,
+ * so dense CAD meshes keep their silhouette and creases without the tessellation noise.
+ * The face normals and dihedral angles are computed once per vertex positions, the edges are kept sorted by angle,
+ * so a feature edge query is a binary search.
+ */
+struct FWireframeEdges
+{
+	static constexpr int NoFace = -1;
+
+	int				 NumVertices = 0, NumFaces = 0; // Of the mesh the edges were built from
+	TArray<Vector2i> Edges;							// Vertex indices, smaller first
+	TArray<Vector2i> EdgeFaces;						// First two adjacent faces, NoFace on a boundary
+	TArray<uint8_t>	 NonManifold;
+
+	TArray<FVector>	 FaceNormals;
+	TArray<Vector2i> SortedEdges;  // Most creased first
+	TArray<double>	 SortedCosines; // Cosine of the dihedral angle of SortedEdges, -2 for boundary and non-manifold edges
+
+	static FWireframeEdges Build(const StaticMesh& Mesh)
+	{
+		FWireframeEdges Result;
+		Result.NumVertices = Mesh.GetVertexNum();
+		Result.NumFaces = Mesh.GetFaceNum();
+
+		// Sort the half edges by their undirected key, equal keys are the same edge
+		TArray<std::pair<uint64_t, int>> HalfEdges;
+		HalfEdges.reserve(static_cast<size_t>(Mesh.GetFaceNum()) * 3);
+		for (int Face = 0; Face < Mesh.GetFaceNum(); Face++)
+		{
+			Vector3i Triangle = Mesh.GetTriangle(Face);
+			for (int Corner = 0; Corner < 3; Corner++)
+			{
+				uint32_t A = Triangle[Corner], B = Triangle[(Corner + 1) % 3];
+				HalfEdges.emplace_back(static_cast<uint64_t>(std::min(A, B)) << 32 | std::max(A, B), Face);
+			}
+		}
+		std::sort(HalfEdges.begin(), HalfEdges.end());
+
+		for (size_t Begin = 0, End = 0; Begin < HalfEdges.size(); Begin = End)
+		{
+			while (End < HalfEdges.size() && HalfEdges[End].first == HalfEdges[Begin].first)
+				End++;
+			uint64_t Key = HalfEdges[Begin].first;
+			Result.Edges.emplace_back(static_cast<int>(Key >> 32), static_cast<int>(Key & 0xFFFFFFFFu));
+			Result.EdgeFaces.emplace_back(HalfEdges[Begin].second, End - Begin > 1 ? HalfEdges[Begin + 1].second : NoFace);
+			Result.NonManifold.push_back(End - Begin > 2);
+		}
+		Result.UpdateGeometry(Mesh);
+		return Result;
+	}
+
+	// Recompute the face normals and dihedral angles after the vertices moved, the topology must be unchanged
+	void UpdateGeometry(const StaticMesh& Mesh)
+	{
+		FaceNormals.resize(NumFaces);
+		for (int Face = 0; Face < NumFaces; Face++)
+		{
+			Vector3i Triangle = Mesh.GetTriangle(Face);
+			FVector	 V0 = Mesh.GetVertex(Triangle[0]);
+			FaceNormals[Face] = (Mesh.GetVertex(Triangle[1]) - V0).cross(Mesh.GetVertex(Triangle[2]) - V0).normalized();
+		}
+		TArray<std::pair<double, int>> Cosines(NumEdges());
+		for (int i = 0; i < NumEdges(); i++)
+		{
+			const Vector2i& Faces = EdgeFaces[i];
+			bool			IsBorder = Faces[1] == NoFace || NonManifold[i];
+			Cosines[i] = { IsBorder ? -2. : FaceNormals[Faces[0]].dot(FaceNormals[Faces[1]]), i };
+		}
+		std::sort(Cosines.begin(), Cosines.end());
+		SortedEdges.resize(NumEdges());
+		SortedCosines.resize(NumEdges());
+		for (int i = 0; i < NumEdges(); i++)
+		{
+			SortedCosines[i] = Cosines[i].first;
+			SortedEdges[i] = Edges[Cosines[i].second];
+		}
+	}
+
+	[[nodiscard]] int NumEdges() const { return static_cast<int>(Edges.size()); }
+
+	// Edges whose faces meet at an angle of at least MinDihedralAngle (radians)
+	[[nodiscard]] std::span<const Vector2i> FeatureEdges(double MinDihedralAngle) const
+	{
+		auto End = std::upper_bound(SortedCosines.begin(), SortedCosines.end(), std::cos(MinDihedralAngle));
+		return { SortedEdges.data(), static_cast<size_t>(End - SortedCosines.begin()) };
+	}
+};
+
+/**
+ * Wireframe edges cached per StaticMesh, extracted on first use. A lookup is a map access, the mesh is not read:
+ * meshes edited in place must be reported with MarkChanged, then the next Find updates the angles after a vertex move
+ * and rebuilds the edges after a topology change. A changed vertex or face count is detected without it.
+ * Safe to call from several threads.
+ * Usage:
+ *	auto Edges = WireframeEdgeCache::Get().Find(Mesh);
+ *	for (const auto& Edge : Edges->FeatureEdges(DegToRad(30.))) ...
+ *	WireframeEdgeCache::Get().MarkChanged(Mesh); // After moving its vertices
+ */
+class WireframeEdgeCache
+{
+public:
+	static WireframeEdgeCache& Get()
+	{
+		static WireframeEdgeCache Instance;
+		return Instance;
+	}
+
+	std::shared_ptr<const FWireframeEdges> Find(const ObjectPtr<StaticMesh>& Mesh)
+	{
+		std::shared_ptr<const FWireframeEdges> Previous;
+		uint32_t							   Version = 0, TopologyVersion = 0;
+		{
+			std::lock_guard Lock(Mutex);
+			auto			It = Entries.find(Mesh.get());
+			if (It != Entries.end() && It->second.Owner.lock() == Mesh)
+			{
+				FEntry& Entry = It->second;
+				Version = Entry.Version;
+				TopologyVersion = Entry.TopologyVersion;
+				bool SameTopology = Entry.Edges && Entry.BuiltTopologyVersion == TopologyVersion
+					&& Entry.Edges->NumVertices == Mesh->GetVertexNum() && Entry.Edges->NumFaces == Mesh->GetFaceNum();
+				if (SameTopology && Entry.BuiltVersion == Version)
+				{
+					NumHits++;
+					return Entry.Edges;
+				}
+				if (SameTopology)
+					Previous = Entry.Edges;
+			}
+		}
+
+		// Extracting takes a while on large meshes, the lock is not held meanwhile
+		std::shared_ptr<const FWireframeEdges> Edges;
+		if (Previous)
+		{
+			auto Updated = std::make_shared<FWireframeEdges>(*Previous);
+			Updated->UpdateGeometry(*Mesh);
+			Edges = std::move(Updated);
+		}
+		else
+			Edges = std::make_shared<const FWireframeEdges>(FWireframeEdges::Build(*Mesh));
+
+		std::lock_guard Lock(Mutex);
+		std::erase_if(Entries, [](const auto& Entry) { return Entry.second.Owner.expired(); });
+		FEntry& Entry = Entries[Mesh.get()];
+		if (Entry.Owner.lock() != Mesh)
+			Entry = { Mesh };
+		// Changes reported meanwhile keep the entry stale, the next Find picks them up
+		Entry.Edges = Edges;
+		Entry.BuiltVersion = Version;
+		Entry.BuiltTopologyVersion = TopologyVersion;
+		NumBuilds++;
+		return Edges;
+	}
+
+	// Report an in place edit of Mesh, the vertex positions only unless bTopologyChanged
+	void MarkChanged(const ObjectPtr<StaticMesh>& Mesh, bool bTopologyChanged = false)
+	{
+		std::lock_guard Lock(Mutex);
+		if (auto It = Entries.find(Mesh.get()); It != Entries.end())
+		{
+			It->second.Version++;
+			if (bTopologyChanged)
+				It->second.TopologyVersion++;
+		}
+	}
+
+	[[nodiscard]] int GetNumHits() const { return NumHits; }
+	[[nodiscard]] int GetNumBuilds() const { return NumBuilds; }
+
+protected:
+	struct FEntry
+	{
+		WeakObjectPtr<StaticMesh>			   Owner;
+		uint32_t							   Version = 0, TopologyVersion = 0; // Bumped by MarkChanged
+		uint32_t							   BuiltVersion = 0, BuiltTopologyVersion = 0;
+		std::shared_ptr<const FWireframeEdges> Edges;
+	};
+
+	std::mutex									  Mutex;
+	std::unordered_map<const StaticMesh*, FEntry> Entries;
+	std::atomic<int>							  NumHits = 0;
+	std::atomic<int>							  NumBuilds = 0; // Builds and geometry updates
+};
@@ -0,0 +1,598 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include "CoreMinimal.h"
+#include "JobSystem.h"
+#include "MaterialLibrary.h"
+#include "MeshBuffers.h"
+#include "Actors/CameraActor.h"
+#include "Actors/LightActor.h"
+#include "Game/StaticMeshActor.h"
+#include "Game/World.h"
+#include "Materials/Material.h"
+#include "Misc/Path.h"
+
+#if !defined(_WIN32)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+/**
+ * Read-only view of a whole file, memory mapped where the platform allows it.
+ * On Windows the file is read into memory instead.
+ */
+class MappedFile
+{
+public:
+	explicit MappedFile(const Path& FilePath)
+	{
+#if defined(_WIN32)
+		std::ifstream InFile(FilePath, std::ios::binary | std::ios::ate);
+		if (!InFile.is_open())
+			return;
+		Buffer.resize(static_cast<size_t>(InFile.tellg()));
+		InFile.seekg(0);
+		InFile.read(reinterpret_cast<char*>(Buffer.data()), Buffer.size());
+		Data = Buffer;
+#else
+		int FileHandle = open(FilePath.c_str(), O_RDONLY);
+		if (FileHandle < 0)
+			return;
+		struct stat Stat{};
+		if (fstat(FileHandle, &Stat) == 0 && Stat.st_size > 0)
+		{
+			void* Address = mmap(nullptr, Stat.st_size, PROT_READ, MAP_PRIVATE, FileHandle, 0);
+			if (Address != MAP_FAILED)
+				Data = { static_cast<const uint8_t*>(Address), static_cast<size_t>(Stat.st_size) };
+		}
+		close(FileHandle);
+#endif
+	}
+
+	~MappedFile()
+	{
+#if !defined(_WIN32)
+		if (!Data.empty())
+			munmap(const_cast<uint8_t*>(Data.data()), Data.size());
+#endif
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	[[nodiscard]] bool IsValid() const { return !Data.empty(); }
+	[[nodiscard]] std::span<const uint8_t> GetData() const { return Data; }
+
+protected:
+	std::span<const uint8_t> Data;
+#if defined(_WIN32)
+	TArray<uint8_t> Buffer;
+#endif
+};
+
+enum class ESnapshotActorType : uint32_t
+{
+	StaticMesh,
+	Camera,
+	AreaLight,
+	PointLight
+};
+
+/**
+ * Everything needed to respawn one actor.
+ * Fields not used by the actor type are ignored, e.g. the light size of a static mesh.
+ */
+struct FSnapshotActor
+{
+	ESnapshotActorType Type = ESnapshotActorType::StaticMesh;
+	String			   Name;
+
+	FVector Translation = FVector::Zero();
+	FVector Rotation = FVector::Zero(); // Euler angles, as passed to Actor::SetRotation
+	FVector Scale = FVector::Ones();
+
+	// Static mesh and its material
+	int					  MeshIndex = -1;
+	std::optional<FColor> BaseColor;
+	std::optional<double> Alpha;
+	bool				  ShowWireframe = false;
+
+	[[nodiscard]] FMaterialParameters GetMaterialParameters() const { return { BaseColor, Alpha, ShowWireframe }; }
+
+	// Camera
+	FVector LookAtTarget = FVector::Zero();
+	double	FovH = 0.;
+
+	// Lights
+	FVector2 LightSize = FVector2::Zero();
+	FVector	 Intensity = FVector::Zero();
+};
+
+/**
+ * Serializable description of a World, saved as one chunked binary file.
+ *
+ * File layout, all chunks are 16 bytes aligned:
+ *	Header	| Magic "MEWS", version, chunk count
+ *	Chunks	| Tag, index, offset and size of each chunk
+ *	"STRS"	| Concatenated actor names
+ *	"ACTR"	| Fixed size actor records, decoded in parallel
+ *	"MESH"	| One chunk per unique mesh, decoded lazily on first access
+ *
+ * The meshes of a loaded snapshot reference the mapped file directly, so loading does not touch the geometry
+ * until a mesh is requested by GetMeshBuffers, GetMesh or Spawn. Decoding gives plain buffers on any thread,
+ * the StaticMesh objects are only created on the game thread.
+ */
+class WorldSnapshot
+{
+public:
+	static constexpr uint32_t Version = 1;
+
+	// Add a mesh and return its index, a mesh shared by several actors is stored once
+	int AddMesh(const ObjectPtr<StaticMesh>& Mesh)
+	{
+		for (int i = 0; i < static_cast<int>(Meshes.size()); i++)
+			if (Meshes[i]->Mesh == Mesh)
+				return i;
+		int Index = AddMesh(FMeshBuffers::FromStaticMesh(*Mesh));
+		Meshes[Index]->Mesh = Mesh;
+		return Index;
+	}
+
+	// Add mesh buffers and return their index, without creating any engine object
+	int AddMesh(FMeshBuffers Buffers)
+	{
+		auto& Entry = Meshes.emplace_back(std::make_unique<FLazyMesh>());
+		std::call_once(Entry->DecodeOnce, [&Entry, &Buffers] { // Already in memory, nothing to decode
+			Entry->Buffers = std::move(Buffers);
+			Entry->Decoded.store(true, std::memory_order_release);
+		});
+		return static_cast<int>(Meshes.size()) - 1;
+	}
+
+	FSnapshotActor& AddActor(ESnapshotActorType Type, const String& Name)
+	{
+		auto& Actor = Actors.emplace_back();
+		Actor.Type = Type;
+		Actor.Name = Name;
+		return Actor;
+	}
+
+	FSnapshotActor& AddStaticMeshActor(const String& Name, const ObjectPtr<StaticMesh>& Mesh)
+	{
+		int MeshIndex = AddMesh(Mesh);
+		auto& Actor = AddActor(ESnapshotActorType::StaticMesh, Name);
+		Actor.MeshIndex = MeshIndex;
+		return Actor;
+	}
+
+	FSnapshotActor& AddStaticMeshActor(const String& Name, FMeshBuffers Buffers)
+	{
+		int MeshIndex = AddMesh(std::move(Buffers));
+		auto& Actor = AddActor(ESnapshotActorType::StaticMesh, Name);
+		Actor.MeshIndex = MeshIndex;
+		return Actor;
+	}
+
+	[[nodiscard]] const TArray<FSnapshotActor>& GetActors() const { return Actors; }
+	[[nodiscard]] int NumMeshes() const { return static_cast<int>(Meshes.size()); }
+
+	// Buffers of the mesh at Index, decoding them from the mapped file on first access. Thread safe
+	const FMeshBuffers& GetMeshBuffers(int Index) const
+	{
+		FLazyMesh& Entry = *Meshes[Index];
+		std::call_once(Entry.DecodeOnce, [&Entry] {
+			Entry.Buffers = DecodeMesh(Entry.Chunk);
+			Entry.Decoded.store(true, std::memory_order_release);
+		});
+		return Entry.Buffers;
+	}
+
+	// The mesh at Index, created from its buffers on first access. Game thread only, it creates engine objects
+	ObjectPtr<StaticMesh> GetMesh(int Index) const
+	{
+		FLazyMesh& Entry = *Meshes[Index];
+		if (!Entry.Mesh)
+			Entry.Mesh = GetMeshBuffers(Index).ToStaticMesh();
+		return Entry.Mesh;
+	}
+
+	/**
+	 * Spawn all actors into the world, from the game thread. The referenced meshes are decoded in parallel,
+	 * then their StaticMesh objects are created here before spawning.
+	 * Static meshes with equal material parameters share one material from Materials, or from a library local
+	 * to this call when Materials is null, default parameters included. The material lives on the mesh, so actors of one mesh share the mesh
+	 * object only when their materials are equal, the others get their own copy.
+	 */
+	void Spawn(World& world, MaterialLibrary* Materials = nullptr) const
+	{
+		PROFILE_SCOPE("WorldSnapshot::Spawn");
+		JobSystem::Get().ParallelFor(NumMeshes(), [this](int Index) { GetMeshBuffers(Index); });
+		MaterialLibrary LocalMaterials;
+		if (!Materials)
+			Materials = &LocalMaterials;
+		TArray<TArray<std::pair<FMaterialParameters, ObjectPtr<StaticMesh>>>> Variants(NumMeshes());
+		auto MeshFor = [this, &Variants](int Index, const FMaterialParameters& Parameters) {
+			auto& MeshVariants = Variants[Index];
+			for (const auto& [VariantParameters, Mesh] : MeshVariants)
+				if (VariantParameters == Parameters)
+					return Mesh;
+			ObjectPtr<StaticMesh> Mesh = MeshVariants.empty() ? GetMesh(Index) : GetMeshBuffers(Index).ToStaticMesh();
+			MeshVariants.emplace_back(Parameters, Mesh);
+			return Mesh;
+		};
+		for (const auto& Record : Actors)
+		{
+			switch (Record.Type)
+			{
+				case ESnapshotActorType::StaticMesh:
+				{
+					FMaterialParameters Parameters = Record.GetMaterialParameters();
+					auto				Actor = world.SpawnActor<StaticMeshActor>(Record.Name, MeshFor(Record.MeshIndex, Parameters));
+					Actor->SetTranslation(Record.Translation)->SetRotation(Record.Rotation);
+					Actor->SetScale(Record.Scale);
+					Materials->Assign(*Actor->GetStaticMeshComponent()->GetMeshData(), Parameters);
+					break;
+				}
+				case ESnapshotActorType::Camera:
+				{
+					auto Camera = world.SpawnActor<CameraActor>(Record.Name);
+					Camera->SetTranslation(Record.Translation);
+					if (Record.FovH > 0.)
+						Camera->GetCameraComponent()->SetFovH(Record.FovH);
+					Camera->LookAt(Record.LookAtTarget);
+					break;
+				}
+				case ESnapshotActorType::AreaLight:
+				{
+					auto Light = world.SpawnActor<AreaLightActor>(Record.Name);
+					Light->SetTranslation(Record.Translation)->SetRotation(Record.Rotation);
+					Light->GetLightComponent()->SetSize(Record.LightSize);
+					Light->GetLightComponent()->SetIntensity(Record.Intensity);
+					break;
+				}
+				case ESnapshotActorType::PointLight:
+					world.SpawnActor<PointLightActor>(Record.Name)->SetTranslation(Record.Translation);
+					break;
+			}
+		}
+	}
+
+	bool Save(const Path& FilePath) const
+	{
+		TArray<std::pair<FChunkEntry, TArray<uint8_t>>> Chunks;
+
+		// Names and fixed size actor records
+		TArray<uint8_t> Names, Records;
+		Append(Records, static_cast<uint64_t>(Actors.size()));
+		for (const auto& Actor : Actors)
+		{
+			FActorRecord Record = EncodeActor(Actor);
+			Record.NameOffset = static_cast<uint32_t>(Names.size());
+			Record.NameLength = static_cast<uint32_t>(Actor.Name.size());
+			Names.insert(Names.end(), Actor.Name.begin(), Actor.Name.end());
+			Append(Records, Record);
+		}
+		Chunks.emplace_back(FChunkEntry{ MakeTag("STRS") }, std::move(Names));
+		Chunks.emplace_back(FChunkEntry{ MakeTag("ACTR") }, std::move(Records));
+
+		for (int i = 0; i < NumMeshes(); i++)
+		{
+			FChunkEntry Entry{ MakeTag("MESH"), static_cast<uint32_t>(i) };
+			const FLazyMesh& Mesh = *Meshes[i];
+			if (Mesh.Decoded.load(std::memory_order_acquire)) // Decoded or added in memory, Buffers are set once Decoded is
+				Chunks.emplace_back(Entry, EncodeMesh(Mesh.Buffers));
+			else // Still untouched in the mapped file, copy the raw chunk
+				Chunks.emplace_back(Entry, TArray<uint8_t>(Mesh.Chunk.begin(), Mesh.Chunk.end()));
+		}
+
+		FFileHeader Header;
+		Header.NumChunks = static_cast<uint32_t>(Chunks.size());
+		uint64_t Offset = AlignUp(sizeof(FFileHeader) + sizeof(FChunkEntry) * Chunks.size());
+		for (auto& [Entry, Payload] : Chunks)
+		{
+			Entry.Offset = Offset;
+			Entry.Size = Payload.size();
+			Offset = AlignUp(Offset + Payload.size());
+		}
+
+		TArray<uint8_t> FileData;
+		FileData.reserve(Offset);
+		Append(FileData, Header);
+		for (const auto& Chunk : Chunks)
+			Append(FileData, Chunk.first);
+		for (const auto& [Entry, Payload] : Chunks)
+		{
+			FileData.resize(Entry.Offset, 0);
+			FileData.insert(FileData.end(), Payload.begin(), Payload.end());
+		}
+
+		std::fstream OutFile(FilePath, std::ios::out | std::ios::binary);
+		if (!OutFile.is_open())
+		{
+			LOG_ERROR("Failed to open file: {}", FilePath.string());
+			return false;
+		}
+		OutFile.write(reinterpret_cast<const char*>(FileData.data()), FileData.size());
+		return OutFile.good();
+	}
+
+	bool Load(const Path& FilePath)
+	{
+		PROFILE_SCOPE("WorldSnapshot::Load");
+		auto File = std::make_shared<MappedFile>(FilePath);
+		if (!File->IsValid())
+		{
+			LOG_ERROR("Failed to open file: {}", FilePath.string());
+			return false;
+		}
+		std::span<const uint8_t> Data = File->GetData();
+		FFileHeader				 Header;
+		if (Data.size() < sizeof(Header) || (std::memcpy(&Header, Data.data(), sizeof(Header)), Header.Magic != MakeTag("MEWS")))
+		{
+			LOG_ERROR("Not a world snapshot: {}", FilePath.string());
+			return false;
+		}
+		if (Header.Version != Version || Data.size() < sizeof(Header) + sizeof(FChunkEntry) * Header.NumChunks)
+		{
+			LOG_ERROR("Unsupported world snapshot version {}: {}", Header.Version, FilePath.string());
+			return false;
+		}
+
+		std::span<const uint8_t> Names, Records;
+		TArray<std::span<const uint8_t>> MeshChunks;
+		TArray<bool>					 HasMeshChunk;
+		for (uint32_t i = 0; i < Header.NumChunks; i++)
+		{
+			FChunkEntry Entry;
+			std::memcpy(&Entry, Data.data() + sizeof(Header) + sizeof(FChunkEntry) * i, sizeof(Entry));
+			if (Entry.Offset > Data.size() || Entry.Size > Data.size() - Entry.Offset)
+			{
+				LOG_ERROR("Truncated world snapshot: {}", FilePath.string());
+				return false;
+			}
+			auto Payload = Data.subspan(Entry.Offset, Entry.Size);
+			if (Entry.Tag == MakeTag("STRS"))
+				Names = Payload;
+			else if (Entry.Tag == MakeTag("ACTR"))
+				Records = Payload;
+			else if (Entry.Tag == MakeTag("MESH"))
+			{
+				// Each mesh has one chunk, so a valid index is below the chunk count
+				if (Entry.Index >= Header.NumChunks)
+				{
+					LOG_ERROR("Corrupted world snapshot: {}", FilePath.string());
+					return false;
+				}
+				if (Entry.Index >= MeshChunks.size())
+				{
+					MeshChunks.resize(Entry.Index + 1);
+					HasMeshChunk.resize(Entry.Index + 1, false);
+				}
+				MeshChunks[Entry.Index] = Payload;
+				HasMeshChunk[Entry.Index] = true;
+			}
+		}
+		if (std::find(HasMeshChunk.begin(), HasMeshChunk.end(), false) != HasMeshChunk.end())
+		{
+			LOG_ERROR("Missing mesh chunk in world snapshot: {}", FilePath.string());
+			return false;
+		}
+
+		uint64_t NumActors = 0;
+		if (Records.size() >= sizeof(NumActors))
+			std::memcpy(&NumActors, Records.data(), sizeof(NumActors));
+		if (Records.size() < sizeof(NumActors) || NumActors > (Records.size() - sizeof(NumActors)) / sizeof(FActorRecord))
+		{
+			LOG_ERROR("Truncated world snapshot: {}", FilePath.string());
+			return false;
+		}
+
+		Actors.clear();
+		Actors.resize(NumActors);
+		std::atomic<bool> Valid = true;
+		JobSystem::Get().ParallelFor(static_cast<int>(NumActors), [&](int i) {
+			FActorRecord Record;
+			std::memcpy(&Record, Records.data() + sizeof(NumActors) + sizeof(FActorRecord) * i, sizeof(Record));
+			bool IsMeshActor = Record.Type == static_cast<uint32_t>(ESnapshotActorType::StaticMesh);
+			if (Record.NameOffset > Names.size() || Record.NameLength > Names.size() - Record.NameOffset || Record.Type > static_cast<uint32_t>(ESnapshotActorType::PointLight)
+				|| Record.MeshIndex >= static_cast<int>(MeshChunks.size()) || (IsMeshActor && Record.MeshIndex < 0))
+			{
+				Valid = false;
+				return;
+			}
+			Actors[i] = DecodeActor(Record);
+			Actors[i].Name.assign(reinterpret_cast<const char*>(Names.data()) + Record.NameOffset, Record.NameLength);
+		});
+		if (!Valid)
+		{
+			LOG_ERROR("Corrupted world snapshot: {}", FilePath.string());
+			Actors.clear();
+			return false;
+		}
+
+		Meshes.clear();
+		for (auto Chunk : MeshChunks)
+		{
+			auto& Entry = Meshes.emplace_back(std::make_unique<FLazyMesh>());
+			Entry->File = File;
+			Entry->Chunk = Chunk;
+		}
+		return true;
+	}
+
+protected:
+	struct FFileHeader
+	{
+		uint32_t Magic = MakeTag("MEWS");
+		uint32_t Version = WorldSnapshot::Version;
+		uint32_t NumChunks = 0;
+		uint32_t Reserved = 0;
+	};
+
+	struct FChunkEntry
+	{
+		uint32_t Tag = 0;
+		uint32_t Index = 0;
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+	};
+
+	enum : uint32_t
+	{
+		FlagBaseColor = 1 << 0,
+		FlagAlpha = 1 << 1,
+		FlagWireframe = 1 << 2
+	};
+
+	// On-disk actor record, the name lives in the string chunk
+	struct FActorRecord
+	{
+		uint32_t Type, Flags, NameOffset, NameLength;
+		int32_t	 MeshIndex, Padding;
+		double	 Translation[3], Rotation[3], Scale[3];
+		double	 BaseColor[3], Alpha;
+		double	 LookAtTarget[3], FovH;
+		double	 LightSize[2], Intensity[3];
+	};
+
+	struct FLazyMesh
+	{
+		std::shared_ptr<MappedFile> File; // Keeps Chunk alive
+		std::span<const uint8_t>	Chunk;
+		std::once_flag				DecodeOnce;
+		std::atomic<bool>			Decoded = false; // Set after Buffers, for the readers outside DecodeOnce
+		FMeshBuffers				Buffers;
+		ObjectPtr<StaticMesh>		Mesh; // Created by GetMesh on the game thread, or the mesh given to AddMesh
+	};
+
+	TArray<FSnapshotActor>			   Actors;
+	TArray<std::unique_ptr<FLazyMesh>> Meshes;
+
+	static constexpr uint32_t MakeTag(const char (&Tag)[5])
+	{
+		return uint32_t(uint8_t(Tag[0])) | uint32_t(uint8_t(Tag[1])) << 8 | uint32_t(uint8_t(Tag[2])) << 16 | uint32_t(uint8_t(Tag[3])) << 24;
+	}
+
+	static uint64_t AlignUp(uint64_t Offset) { return (Offset + 15) & ~uint64_t(15); }
+
+	template <class T>
+	static void Append(TArray<uint8_t>& Out, const T& Value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		const auto* Bytes = reinterpret_cast<const uint8_t*>(&Value);
+		Out.insert(Out.end(), Bytes, Bytes + sizeof(T));
+	}
+
+	static TArray<uint8_t> EncodeMesh(const FMeshBuffers& Mesh)
+	{
+		TArray<uint8_t> Out;
+		Out.reserve(8 + Mesh.Vertices.size() * sizeof(double) * 3 + Mesh.Triangles.size() * sizeof(int32_t) * 3);
+		Append(Out, static_cast<uint32_t>(Mesh.NumVertices()));
+		Append(Out, static_cast<uint32_t>(Mesh.NumTriangles()));
+		for (const auto& Vertex : Mesh.Vertices)
+			for (int Axis = 0; Axis < 3; Axis++)
+				Append(Out, Vertex[Axis]);
+		for (const auto& Triangle : Mesh.Triangles)
+			for (int Corner = 0; Corner < 3; Corner++)
+				Append(Out, static_cast<int32_t>(Triangle[Corner]));
+		return Out;
+	}
+
+	static FMeshBuffers DecodeMesh(std::span<const uint8_t> Chunk)
+	{
+		FMeshBuffers Mesh;
+		uint32_t	 NumVertices = 0, NumTriangles = 0;
+		if (Chunk.size() < 8)
+			return Mesh;
+		std::memcpy(&NumVertices, Chunk.data(), 4);
+		std::memcpy(&NumTriangles, Chunk.data() + 4, 4);
+		if (Chunk.size() < 8 + NumVertices * sizeof(double) * 3 + NumTriangles * sizeof(int32_t) * 3)
+		{
+			LOG_ERROR("Truncated mesh chunk in world snapshot");
+			return Mesh;
+		}
+		const uint8_t* Cursor = Chunk.data() + 8;
+		Mesh.Vertices.resize(NumVertices);
+		for (auto& Vertex : Mesh.Vertices)
+		{
+			double Position[3];
+			std::memcpy(Position, Cursor, sizeof(Position));
+			Cursor += sizeof(Position);
+			Vertex = { Position[0], Position[1], Position[2] };
+		}
+		Mesh.Triangles.resize(NumTriangles);
+		for (auto& Triangle : Mesh.Triangles)
+		{
+			int32_t Indices[3];
+			std::memcpy(Indices, Cursor, sizeof(Indices));
+			Cursor += sizeof(Indices);
+			for (int32_t Index : Indices)
+				if (Index < 0 || static_cast<uint32_t>(Index) >= NumVertices)
+				{
+					LOG_ERROR("Invalid vertex index {} in world snapshot mesh of {} vertices", Index, NumVertices);
+					return {};
+				}
+			Triangle = { Indices[0], Indices[1], Indices[2] };
+		}
+		return Mesh;
+	}
+
+	static FActorRecord EncodeActor(const FSnapshotActor& Actor)
+	{
+		FActorRecord Record{};
+		Record.Type = static_cast<uint32_t>(Actor.Type);
+		Record.Flags = (Actor.BaseColor ? FlagBaseColor : 0) | (Actor.Alpha ? FlagAlpha : 0) | (Actor.ShowWireframe ? FlagWireframe : 0);
+		Record.MeshIndex = Actor.MeshIndex;
+		for (int i = 0; i < 3; i++)
+		{
+			Record.Translation[i] = Actor.Translation[i];
+			Record.Rotation[i] = Actor.Rotation[i];
+			Record.Scale[i] = Actor.Scale[i];
+			Record.BaseColor[i] = Actor.BaseColor.value_or(FColor::Zero())[i];
+			Record.LookAtTarget[i] = Actor.LookAtTarget[i];
+			Record.Intensity[i] = Actor.Intensity[i];
+		}
+		Record.Alpha = Actor.Alpha.value_or(1.);
+		Record.FovH = Actor.FovH;
+		Record.LightSize[0] = Actor.LightSize.x();
+		Record.LightSize[1] = Actor.LightSize.y();
+		return Record;
+	}
+
+	static FSnapshotActor DecodeActor(const FActorRecord& Record)
+	{
+		FSnapshotActor Actor;
+		Actor.Type = static_cast<ESnapshotActorType>(Record.Type);
+		Actor.MeshIndex = Record.MeshIndex;
+		Actor.Translation = { Record.Translation[0], Record.Translation[1], Record.Translation[2] };
+		Actor.Rotation = { Record.Rotation[0], Record.Rotation[1], Record.Rotation[2] };
+		Actor.Scale = { Record.Scale[0], Record.Scale[1], Record.Scale[2] };
+		if (Record.Flags & FlagBaseColor)
+			Actor.BaseColor = FColor{ Record.BaseColor[0], Record.BaseColor[1], Record.BaseColor[2] };
+		if (Record.Flags & FlagAlpha)
+			Actor.Alpha = Record.Alpha;
+		Actor.ShowWireframe = Record.Flags & FlagWireframe;
+		Actor.LookAtTarget = { Record.LookAtTarget[0], Record.LookAtTarget[1], Record.LookAtTarget[2] };
+		Actor.FovH = Record.FovH;
+		Actor.LightSize = { Record.LightSize[0], Record.LightSize[1] };
+		Actor.Intensity = { Record.Intensity[0], Record.Intensity[1], Record.Intensity[2] };
+		return Actor;
+	}
+};
+
+// Usage: GEditor.LoadWorld(LoadWorldSnapshot(Path::ProjectContentDir() / "CornellBox.mews"))
+inline auto LoadWorldSnapshot(const Path& FilePath)
+{
+	return [FilePath](World& world) {
+		WorldSnapshot Snapshot;
+		if (Snapshot.Load(FilePath))
+			Snapshot.Spawn(world);
+	};
+}
@@ -20,8 +20,67 @@
 #include "CustomShaderExample.h" // This example demonstrates how to create a custom shader
 #include "PointsOBB.h"
 #include "CornellBox.h"
+#include "TransformHierarchyExample.h" // This example demonstrates how to animate a transform hierarchy with batched world transform updates
+#include "MeshLODExample.h"			 // This example demonstrates how to simplify a mesh into a LOD chain and select the levels by screen space error
+#include "CpuRenderingExample.h"		 // This example demonstrates how to render a scene offline with the CPU path tracer
+#include "CornellBoxBenchmark.h"		 // Progressive rendering benchmark of the Cornell box, reported as JSON
+#include "TransparencyBenchmark.h"	 // Order independent transparency compared with sorted blending, reported as JSON
+#include "ObjectPoolBenchmark.h"		 // Actor storage in object pools compared with reference counted heap objects, reported as JSON
+#include "MeshLayoutBenchmark.h"		 // Vertex cache and traversal cost of the meshes before and after the layout optimization, reported as JSON
+#include "ReflectionBenchmark.h"		 // Binary serialization from reflection tables compared with name keyed runtime properties, reported as JSON
+#include "CommandLine.h"
+#include <iostream>
+#include <string>
 int main(int argc, char *argv[])
 {
+    Profiler::Get().SetThreadName("Game");
+
+    // The headless modes work on plain buffers and create no engine object, they run without the editor and a GPU
+    // Headless reference render: --cpu-render <image.ppm|image.pfm> [spp]
+    if (argc >= 3 && std::string(argv[1]) == "--cpu-render")
+    {
+        int SamplesPerPixel = 64;
+        if (argc >= 4 && !ParseArgument("spp", argv[3], SamplesPerPixel, 1))
+        {
+            std::cerr << "Usage: MechEngineExamples --cpu-render <image.ppm|image.pfm> [spp]\n";
+            return 1;
+        }
+        return RenderCornellBoxOffline(argv[2], 512, 512, SamplesPerPixel) ? 0 : 1;
+    }
+    // Headless animation: --cpu-turntable <folder> [frames], one .ppm per frame
+    if (argc >= 3 && std::string(argv[1]) == "--cpu-turntable")
+    {
+        int NumFrames = 24;
+        if (argc >= 4 && !ParseArgument("frames", argv[3], NumFrames, 1))
+        {
+            std::cerr << "Usage: MechEngineExamples --cpu-turntable <folder> [frames]\n";
+            return 1;
+        }
+        return RenderCornellBoxTurntableOffline(argv[2], NumFrames) ? 0 : 1;
+    }
+    // Benchmark: --benchmark [--spp N | --time Seconds] [--size W H] [--reference image.pfm|none] [--out result.json]
+    if (argc >= 2 && std::string(argv[1]) == "--benchmark")
+        return CornellBoxBenchmarkMain(argc, argv);
+    // Profile the headless render: --profile-trace <trace.json>, open the trace in chrome://tracing
+    if (argc >= 3 && std::string(argv[1]) == "--profile-trace")
+    {
+        Profiler::Get().SetEnabled(true);
+        RenderCornellBoxOffline(std::string(argv[2]) + ".ppm", 256, 256, 16);
+        return Profiler::Get().ExportChromeTrace(argv[2]) ? 0 : 1;
+    }
+    // Transparency benchmark: --oit-benchmark [--parts N] [--size W H] [--images Folder] [--out result.json]
+    if (argc >= 2 && std::string(argv[1]) == "--oit-benchmark")
+        return TransparencyBenchmarkMain(argc, argv);
+    // Object pool benchmark: --pool-benchmark [--actors N] [--out result.json]
+    if (argc >= 2 && std::string(argv[1]) == "--pool-benchmark")
+        return ObjectPoolBenchmarkMain(argc, argv);
+    // Mesh layout benchmark: --layout-benchmark [--out result.json]
+    if (argc >= 2 && std::string(argv[1]) == "--layout-benchmark")
+        return MeshLayoutBenchmarkMain(argc, argv);
+    // Reflection serializer benchmark: --reflection-benchmark [--objects N] [--out result.json]
+    if (argc >= 2 && std::string(argv[1]) == "--reflection-benchmark")
+        return ReflectionBenchmarkMain(argc, argv);
+
     GEditor.Init(argv[0]);
     GEditor.LoadWorld(CornellBox());
     GEditor.Start();